@@ -0,0 +1,85 @@
+#include "dns/batch_decoder.h"
+#include "dns/message.h"
+
+#include "bench.h"
+
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main()
+{
+   auto&& raw = std::vector<std::vector<uint8_t>>{};
+
+   for(auto i = 0; i < 10000; ++i)
+   {
+      auto&& m = dns::message_t{};
+      auto&& qname = "host" + std::to_string(i) + ".example.com";
+
+      m.Header().ID(i);
+      m.Header().QR_Flag(true);
+      m.Header().QdCount(1);
+      m.Header().AnCount(2);
+
+      m.Question(dns::question_t{});
+      m.Question(0).Name(qname);
+      m.Question(0).Type(dns::rr_type_t::rec_mx);
+
+      for(auto j = 0; j < 2; ++j)
+      {
+         dns::answer_t r;
+         r.Name(qname);
+         r.Type(dns::rr_type_t::rec_mx);
+         r.TTL(300);
+         r.Data(dns::rec_mx_t{static_cast<uint16_t>(j), "mx" + std::to_string(j) + ".example.com"});
+         m.Answer(r);
+      }
+
+      raw.emplace_back();
+      m.save_to(raw.back());
+   }
+
+   auto&& packets = std::vector<dns::packet_t>{};
+
+   for(auto&& r : raw)
+      packets.push_back(dns::packet_t{r.data(), r.size()});
+
+   auto&& report = [&](double ns)
+   {
+      std::printf("%40s %10.2f Mpps\n", "", 1e3 * packets.size() / ns);
+   };
+
+   std::printf("10000 MX responses, 2 answers each\n");
+
+   report(bench::run("  message_t::load_from, one by one", 10, [&]
+   {
+      for(auto&& p : packets)
+      {
+         auto&& m = dns::message_t{};
+         m.load_from(p.data, p.data + p.size);
+         bench::keep(m);
+      }
+   }));
+
+   auto&& batch = dns::batch_decoder_t{};
+
+   report(bench::run("  batch_decoder_t::decode", 10, [&]
+   {
+      batch.clear();
+      batch.decode(packets.data(), packets.size());
+      bench::keep(batch);
+   }));
+
+   unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+   auto&& chunks = std::deque<dns::batch_decoder_t>(threads);
+
+   report(bench::run("  decode_parallel, " + std::to_string(threads) + " threads", 10, [&]
+   {
+      for(auto&& c : chunks)
+         c.clear();
+
+      dns::batch_decoder_t::decode_parallel(packets.data(), packets.size(), chunks.begin(), chunks.end());
+      bench::keep(chunks);
+   }));
+}
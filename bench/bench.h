@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace bench
+{
+   template<class T>
+   inline void keep(T&& value)
+   {
+      asm volatile("" : : "g"(&value) : "memory");
+   }
+
+   /*
+    * Runs fu() 'iterations' times, best of a few rounds, and prints the time per call.
+    */
+   template<class F>
+   double run(const std::string& name, std::size_t iterations, F&& fu)
+   {
+      auto&& best = 1e300;
+
+      for(auto round = 0; round < 5; ++round)
+      {
+         auto&& start = std::chrono::steady_clock::now();
+
+         for(std::size_t i = 0; i < iterations; ++i)
+            fu();
+
+         std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+         if(elapsed.count() / iterations < best)
+            best = elapsed.count() / iterations;
+      }
+
+      std::printf("%-40s %10.2f ns/op\n", name.c_str(), best);
+
+      return best;
+   }
+}
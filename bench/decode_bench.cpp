@@ -0,0 +1,165 @@
+#include "dns/message.h"
+#include "dns/message_view.h"
+#include "dns/detail/message_pool.h"
+
+#include "bench.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+int main()
+{
+   auto&& m = dns::message_t{};
+
+   m.Header().ID(0x1234);
+   m.Header().QR_Flag(true);
+   m.Header().QdCount(1);
+   m.Header().AnCount(5);
+
+   m.Question(dns::question_t{});
+   m.Question(0).Name("yahoo.com");
+   m.Question(0).Type(dns::rr_type_t::rec_mx);
+
+   for(auto i = 1; i <= 5; ++i)
+   {
+      dns::answer_t r;
+      r.Name("yahoo.com");
+      r.Type(dns::rr_type_t::rec_mx);
+      r.TTL(1800);
+      r.Data(dns::rec_mx_t{static_cast<uint16_t>(i), "mta" + std::to_string(i) + ".am0.yahoodns.net"});
+      m.Answer(r);
+   }
+
+   auto&& raw = std::vector<uint8_t>{};
+   m.save_to(raw);
+
+   auto&& linked = std::list<uint8_t>(raw.begin(), raw.end());
+
+   std::printf("MX response, 5 answers, %zu bytes\n", raw.size());
+
+   bench::run("  message_t::load_from, contiguous", 100000, [&]
+   {
+      auto&& m1 = dns::message_t{};
+      m1.load_from(raw.cbegin(), raw.cend());
+      bench::keep(m1);
+   });
+
+   auto&& pool = dns::detail::message_pool_t{};
+
+   bench::run("  message_t::load_from, pooled message", 100000, [&]
+   {
+      auto&& m1 = pool.acquire();
+      m1->load_from(raw.cbegin(), raw.cend());
+      bench::keep(*m1);
+   });
+
+   bench::run("  message_t::load_from, byte by byte", 100000, [&]
+   {
+      auto&& m1 = dns::message_t{};
+      m1.load_from(linked.cbegin(), linked.cend());
+      bench::keep(m1);
+   });
+
+   bench::run("  message_view_t, every Data<rec_mx_t>()", 100000, [&]
+   {
+      auto&& v = dns::message_view_t{raw};
+
+      for(auto&& r : v.Answers())
+         bench::keep(r.Data<dns::rec_mx_t>());
+   });
+
+   bench::run("  for_each_record<rec_mx_t>", 100000, [&]
+   {
+      dns::for_each_record<dns::rec_mx_t>(dns::message_view_t{raw}.Answers(), [](auto&& mx)
+      {
+         bench::keep(mx);
+      });
+   });
+
+   bench::run("  first_record<rec_mx_t>", 100000, [&]
+   {
+      bench::keep(dns::first_record<dns::rec_mx_t>(dns::message_view_t{raw}.Answers()));
+   });
+
+   auto&& txt = dns::message_t{};
+
+   txt.Header().QR_Flag(true);
+   txt.Header().QdCount(1);
+   txt.Header().AnCount(4);
+
+   txt.Question(dns::question_t{});
+   txt.Question(0).Name("selector._domainkey.example.com");
+   txt.Question(0).Type(dns::rr_type_t::rec_txt);
+
+   for(auto i = 0; i < 4; ++i)
+   {
+      dns::answer_t r;
+      r.Name("selector._domainkey.example.com");
+      r.Type(dns::rr_type_t::rec_txt);
+      r.TTL(300);
+      r.Data(dns::rec_txt_t{"v=DKIM1; k=rsa; p=" + std::string(400, 'A' + i)});
+      txt.Answer(r);
+   }
+
+   raw.clear();
+   txt.save_to(raw);
+
+   std::printf("TXT response, 4 answers, %zu bytes\n", raw.size());
+
+   bench::run("  message_t::load_from", 100000, [&]
+   {
+      auto&& m1 = dns::message_t{};
+      m1.load_from(raw.cbegin(), raw.cend());
+      bench::keep(m1);
+   });
+
+   bench::run("  message_t::load_from, pooled message", 100000, [&]
+   {
+      auto&& m1 = pool.acquire();
+      m1->load_from(raw.cbegin(), raw.cend());
+      bench::keep(*m1);
+   });
+
+   auto&& text = std::string{};
+
+   bench::run("  message_t::load_from + every AppendText()", 100000, [&]
+   {
+      auto&& m1 = dns::message_t{};
+      m1.load_from(raw.cbegin(), raw.cend());
+
+      for(auto i = 0; i < 4; ++i)
+      {
+         text.clear();
+         m1.Answer(i).Data<dns::rec_txt_t>().AppendText(text);
+         bench::keep(text);
+      }
+   });
+
+   // the MX response again, cut short in its last record
+   raw.clear();
+   m.save_to(raw);
+   raw.resize(raw.size() - 3);
+
+   std::printf("truncated MX response\n");
+
+   bench::run("  message_t::load_from, throwing", 100000, [&]
+   {
+      auto&& m1 = dns::message_t{};
+
+      try
+      {
+         m1.load_from(raw.cbegin(), raw.cend());
+      }
+      catch(const dns::exception::bad_data_stream& e)
+      {
+         bench::keep(e);
+      }
+   });
+
+   bench::run("  message_t::try_load_from", 100000, [&]
+   {
+      auto&& m1 = dns::message_t{};
+      bench::keep(m1.try_load_from(raw.data(), raw.size()));
+   });
+}
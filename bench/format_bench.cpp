@@ -0,0 +1,59 @@
+#include "dns/message.h"
+#include "dns/presentation.h"
+#include "util/text_buffer.h"
+
+#include "bench.h"
+
+#include <sstream>
+
+int main()
+{
+   auto&& m = dns::message_t{};
+
+   m.Header().ID(0x1234);
+   m.Header().QR_Flag(true);
+   m.Header().RD_Flag(true);
+   m.Header().QdCount(1);
+   m.Header().AnCount(3);
+
+   m.Question(dns::question_t{});
+   m.Question(0).Name("yahoo.com");
+   m.Question(0).Type(dns::rr_type_t::rec_a);
+
+   for(auto&& address : { "98.137.11.163", "74.6.143.25", "98.137.11.164" })
+   {
+      dns::answer_t r;
+      r.Name("yahoo.com");
+      r.Type(dns::rr_type_t::rec_a);
+      r.TTL(1800);
+      r.Data(dns::rec_a_t{address});
+      m.Answer(r);
+   }
+
+   auto&& a = dns::rec_a_t{"216.58.220.4"};
+
+   bench::run("rec_a_t::DotAddress", 1000000, [&] { bench::keep(a.DotAddress()); });
+
+   bench::run("message_t into a new ostringstream", 100000, [&]
+   {
+      std::ostringstream os;
+      os << m;
+      bench::keep(os);
+   });
+
+   util::text_buffer_t b;
+
+   bench::run("message_t into a reused text_buffer_t", 100000, [&]
+   {
+      b.clear();
+      b << m;
+      bench::keep(b);
+   });
+
+   bench::run("message_t as zone text into a reused text_buffer_t", 100000, [&]
+   {
+      b.clear();
+      dns::print_zone_to(b, m);
+      bench::keep(b);
+   });
+}
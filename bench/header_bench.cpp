@@ -0,0 +1,51 @@
+#include "dns/header.h"
+
+#include "bench.h"
+
+#include <list>
+#include <vector>
+
+int main()
+{
+   auto&& raw = std::vector<uint8_t>{ 0x50, 0x06, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01 };
+   auto&& linked = std::list<uint8_t>(raw.begin(), raw.end());
+
+   bench::run("load_from<header_t>, contiguous", 1000000, [&]
+   {
+      auto&& b = raw.cbegin();
+      dns::name_offset_tracker_t tr;
+
+      bench::keep(dns::load_from<dns::header_t>(tr, b, raw.cend()));
+   });
+
+   bench::run("load_from<header_t>, byte by byte", 1000000, [&]
+   {
+      auto&& b = linked.cbegin();
+      dns::name_offset_tracker_t tr;
+
+      bench::keep(dns::load_from<dns::header_t>(tr, b, linked.cend()));
+   });
+
+   auto&& h = dns::detail::load_header(raw.data());
+   uint8_t out[dns::detail::header_size];
+
+   bench::run("save_to(header_t), fixed buffer", 1000000, [&]
+   {
+      auto&& tr = dns::name_offset_tracker_t::write_to(out, sizeof(out));
+
+      save_to(tr, h);
+      bench::keep(out);
+   });
+
+   bench::run("detail::load_header", 10000000, [&]
+   {
+      bench::keep(raw);
+      bench::keep(dns::detail::load_header(raw.data()));
+   });
+
+   bench::run("detail::peek_id", 10000000, [&]
+   {
+      bench::keep(raw);
+      bench::keep(dns::detail::peek_id(raw.data()));
+   });
+}
@@ -0,0 +1,62 @@
+#include "dns/detail/name_kernel.h"
+#include "dns/dname.h"
+
+#include "bench.h"
+
+#include <string>
+#include <vector>
+
+namespace nk = dns::detail::name_kernel;
+
+int main()
+{
+   auto&& names = std::vector<std::string>{
+      "yahoo.com",
+      "mta5.am0.YahooDNS.net",
+      "google._domainkey.protodave.com",
+      "36.102.85.209.in-addr.arpa",
+      std::string(63, 'a') + "." + std::string(63, 'B') + "." + std::string(63, 'c') + "." + std::string(61, 'D'),
+   };
+
+   for(auto&& name : names)
+   {
+      auto&& text = name.substr(0, 24) + (name.size() > 24 ? "...(" + std::to_string(name.size()) + ")" : "");
+      auto&& p = reinterpret_cast<const uint8_t*>(name.data());
+      auto&& n = name.size();
+
+      std::printf("\n%s\n", text.c_str());
+
+      uint8_t wire[256];
+      uint8_t out[256];
+      auto&& dots = nk::position_map_t{};
+
+      bench::run("  hash scalar", 1000000, [&] { bench::keep(nk::scalar::hash(p, n, 0)); });
+#if defined(DNS_NAME_KERNEL_X86)
+      bench::run("  hash sse2", 1000000, [&] { bench::keep(nk::sse2::hash(p, n, 0)); });
+      if(nk::has_avx2())
+         bench::run("  hash avx2", 1000000, [&] { bench::keep(nk::avx2::hash(p, n, 0)); });
+#endif
+
+      bench::run("  lowercase scalar", 1000000, [&] { nk::scalar::lowercase(p, n, out); bench::keep(out); });
+#if defined(DNS_NAME_KERNEL_X86)
+      bench::run("  lowercase sse2", 1000000, [&] { nk::sse2::lowercase(p, n, out); bench::keep(out); });
+      if(nk::has_avx2())
+         bench::run("  lowercase avx2", 1000000, [&] { nk::avx2::lowercase(p, n, out); bench::keep(out); });
+#endif
+
+      bench::run("  scan_text scalar", 1000000, [&] { nk::scalar::scan_text(p, n, wire, dots); bench::keep(wire); });
+#if defined(DNS_NAME_KERNEL_X86)
+      bench::run("  scan_text sse2", 1000000, [&] { nk::sse2::scan_text(p, n, wire, dots); bench::keep(wire); });
+      if(nk::has_avx2())
+         bench::run("  scan_text avx2", 1000000, [&] { nk::avx2::scan_text(p, n, wire, dots); bench::keep(wire); });
+#endif
+
+      bench::run("  dname_t from text", 1000000, [&] { bench::keep(dns::dname_t{name}); });
+      bench::run("  label_list_t save_to (for reference)", 100000, [&]
+      {
+         auto&& tr = dns::name_offset_tracker_t{};
+         dns::save_to(tr, dns::label_list_t{name});
+         bench::keep(tr);
+      });
+   }
+}
@@ -0,0 +1,58 @@
+#include "dns/message.h"
+#include "dns/query_template.h"
+
+#include "bench.h"
+
+#include <string>
+#include <vector>
+
+int main()
+{
+   auto&& names = std::vector<std::string>{};
+
+   for(auto i = 0; i < 1000; ++i)
+      names.push_back("host" + std::to_string(i) + ".mail.example.com");
+
+   auto&& out = std::vector<uint8_t>{};
+   out.reserve(dns::query_template_t::max_size);
+
+   std::printf("1000 queries\n");
+
+   bench::run("  make_query + save_to", 100, [&]
+   {
+      for(auto&& name : names)
+      {
+         out.clear();
+         dns::make_query(name, dns::rr_type_t::rec_mx).save_to(out);
+         bench::keep(out);
+      }
+   });
+
+   auto&& tmpl = dns::query_template_t{dns::rr_type_t::rec_mx};
+
+   bench::run("  query_template_t", 100, [&]
+   {
+      uint16_t id = 0;
+
+      for(auto&& name : names)
+      {
+         out.clear();
+         tmpl.encode_to(++id, name, out);
+         bench::keep(out);
+      }
+   });
+
+   auto&& qnames = std::vector<dns::dname_t>(names.begin(), names.end());
+
+   bench::run("  query_template_t (names already dname_t)", 100, [&]
+   {
+      uint16_t id = 0;
+
+      for(auto&& qname : qnames)
+      {
+         out.clear();
+         tmpl.encode_to(++id, qname, out);
+         bench::keep(out);
+      }
+   });
+}
@@ -0,0 +1,173 @@
+#include "dns/message.h"
+#include "dns/message_builder.h"
+#include "util/small_vector.h"
+
+#include "bench.h"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace
+{
+   dns::answer_t make_answer(const std::string& name, dns::rr_type_t type)
+   {
+      dns::answer_t r;
+      r.Name(name);
+      r.Type(type);
+      r.TTL(300);
+      return r;
+   }
+
+   // 'answers' A records, with as many NS records and their addresses as 'servers'
+   dns::message_t make_response(int answers, int servers)
+   {
+      auto&& m = dns::message_t{};
+
+      m.Header().ID(0x1234);
+      m.Header().QR_Flag(true);
+      m.Header().QdCount(1);
+      m.Header().AnCount(answers);
+      m.Header().NsCount(servers);
+      m.Header().ArCount(servers);
+
+      m.Question(dns::question_t{});
+      m.Question(0).Name("www.example.com");
+
+      for(auto i = 0; i < answers; ++i)
+      {
+         auto&& r = make_answer("www.example.com", dns::rr_type_t::rec_a);
+         r.Data(dns::rec_a_t{"192.0.2." + std::to_string(i % 256)});
+         m.Answer(r);
+      }
+
+      for(auto i = 0; i < servers; ++i)
+      {
+         auto&& r = make_answer("example.com", dns::rr_type_t::rec_ns);
+         r.Data(dns::rec_ns_t{"ns" + std::to_string(i) + ".example.com"});
+         m.Authority(r);
+      }
+
+      for(auto i = 0; i < servers; ++i)
+      {
+         auto&& r = make_answer("ns" + std::to_string(i) + ".example.com", dns::rr_type_t::rec_a);
+         r.Data(dns::rec_a_t{"198.51.100." + std::to_string(i)});
+         m.Additional(r);
+      }
+
+      return m;
+   }
+
+   template<class SectionT>
+   void fill(SectionT& section, const dns::answer_t& r, int n)
+   {
+      section.reserve(n);
+
+      for(auto i = 0; i < n; ++i)
+         section.push_back(r);
+   }
+}
+
+int main()
+{
+   const struct
+   {
+      const char* name;
+      int answers;
+      int servers;
+   }
+   responses[] =
+   {
+      { "typical", 3, 2 },
+      { "worst case", 100, 13 },
+   };
+
+   for(auto&& response : responses)
+   {
+      auto&& raw = std::vector<uint8_t>{};
+      make_response(response.answers, response.servers).save_to(raw);
+
+      std::printf("%s response, %d/%d/%d records, %zu bytes\n", response.name, response.answers, response.servers, response.servers, raw.size());
+
+      bench::run("  message_t::load_from", 100000, [&]
+      {
+         auto&& m = dns::message_t{};
+         m.load_from(raw.cbegin(), raw.cend());
+         bench::keep(m);
+      });
+
+      auto&& m = dns::message_t{};
+      m.load_from(raw.cbegin(), raw.cend());
+
+      bench::run("  message_t copy", 100000, [&]
+      {
+         dns::message_t copy = m;
+         bench::keep(copy);
+      });
+
+      uint8_t out[4096];
+
+      bench::run("  save_to, whole message", 100000, [&]
+      {
+         bench::keep(m.save_to(out, sizeof(out)));
+      });
+
+      bench::run("  save_truncated_to, 512 byte budget", 100000, [&]
+      {
+         bench::keep(m.save_truncated_to(out, 512));
+      });
+   }
+
+   auto&& r = make_answer("www.example.com", dns::rr_type_t::rec_a);
+   r.Data(dns::rec_a_t{"192.0.2.1"});
+
+   for(auto n : { 3, 100 })
+   {
+      std::printf("section of %d answers\n", n);
+
+      bench::run("  std::pmr::vector<answer_t>", 100000, [&]
+      {
+         auto&& section = std::pmr::vector<dns::answer_t>{};
+         fill(section, r, n);
+         bench::keep(section);
+      });
+
+      bench::run("  util::small_vector_t<answer_t, 8>", 100000, [&]
+      {
+         auto&& section = util::small_vector_t<dns::answer_t, 8>{};
+         fill(section, r, n);
+         bench::keep(section);
+      });
+   }
+
+   std::printf("typical response, built and encoded\n");
+
+   auto&& wire = std::vector<uint8_t>{};
+
+   bench::run("  message_t, then save_to", 100000, [&]
+   {
+      wire.clear();
+      make_response(3, 2).save_to(wire);
+      bench::keep(wire);
+   });
+
+   bench::run("  message_builder_t", 100000, [&]
+   {
+      wire.clear();
+
+      auto&& b = dns::response(wire);
+
+      b.WithID(0x1234).AddQuestionNamed("www.example.com");
+
+      for(auto i = 0; i < 3; ++i)
+         b.AddAnswer("www.example.com").WithTTL(300).WithData(dns::rec_a_t{"192.0.2." + std::to_string(i)});
+
+      for(auto i = 0; i < 2; ++i)
+         b.AddAuthority("example.com").WithTTL(300).WithData(dns::rec_ns_t{"ns" + std::to_string(i) + ".example.com"});
+
+      for(auto i = 0; i < 2; ++i)
+         b.AddAdditional("ns" + std::to_string(i) + ".example.com").WithTTL(300).WithData(dns::rec_a_t{"198.51.100." + std::to_string(i)});
+
+      bench::keep(wire);
+   });
+}
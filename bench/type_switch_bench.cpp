@@ -0,0 +1,74 @@
+#include "dns/answer.h"
+#include "util/TypeMapSwitch.h"
+
+#include "bench.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+   template<typename T>
+   struct SizeOf
+   {
+      void operator()(std::size_t& total)
+      {
+         total += sizeof(T);
+      }
+   };
+
+   template<>
+   struct SizeOf<void>
+   {
+      void operator()(std::size_t& total)
+      {
+         total += 1;
+      }
+   };
+
+   template<typename SwitchT>
+   void run(const char* name, const std::vector<dns::rr_type_t>& keys)
+   {
+      bench::run(name, 1000, [&keys]
+      {
+         std::size_t total = 0;
+
+         for(auto&& key : keys)
+            SwitchT::template dispatch<SizeOf>(key, total);
+
+         bench::keep(total);
+      });
+   }
+}
+
+int main()
+{
+   using map_t = dns::detail::record_type_map_t;
+
+   std::printf("record_type_map_t is %s\n", util::detail::TypeMapListSwitch<map_t>::is_dense ? "dense (table)" : "sparse (tree)");
+
+   // a mix as seen in typical answers, with some types not in the map
+   auto&& mix = std::vector<dns::rr_type_t>{
+      dns::rr_type_t::rec_a, dns::rr_type_t::rec_a, dns::rr_type_t::rec_cname, dns::rr_type_t::rec_mx,
+      dns::rr_type_t::rec_ns, dns::rr_type_t::rec_aaaa, dns::rr_type_t::rec_txt, dns::rr_type_t::rec_soa,
+      dns::rr_type_t::rec_ptr, dns::rr_type_t::rec_a, dns::rr_type_t::rec_srv, dns::rr_type_t::rec_ns,
+   };
+
+   auto&& keys = std::vector<dns::rr_type_t>{};
+
+   auto&& rng = std::minstd_rand{42};
+
+   for(std::size_t i = 0; i < 1024; ++i)
+      keys.push_back(mix[rng() % mix.size()]);
+
+   std::printf("\n1024 dispatches, mixed types\n");
+   run< util::TypeMapListTreeSwitch_t<map_t> >("  tree", keys);
+   run< util::TypeMapListTableSwitch_t<map_t> >("  table", keys);
+
+   auto&& same = std::vector<dns::rr_type_t>(1024, dns::rr_type_t::rec_mx);
+
+   std::printf("\n1024 dispatches, one type\n");
+   run< util::TypeMapListTreeSwitch_t<map_t> >("  tree", same);
+   run< util::TypeMapListTableSwitch_t<map_t> >("  table", same);
+}
@@ -4,9 +4,8 @@
 #include "dns/rr_class.h"
 
 #include "dns/detail/name_offset_tracker.h"
-#include "dns/detail/label_list.h"
-#include "dns/detail/label_list/load_from.h"
-#include "dns/detail/label_list/save_to.h"
+#include "dns/dname.h"
+#include "dns/exception/bad_record_type.h"
 
 #include "dns/record/rec_a.h"
 #include "dns/record/rec_mx.h"
@@ -15,14 +14,18 @@
 #include "dns/record/rec_txt.h"
 #include "dns/record/rec_cname.h"
 #include "dns/record/rec_soa.h"
+#include "dns/record/rec_raw.h"
 
-#include "util/oct_dump.h"
+#include "util/TypeList.h"
 #include "util/TypeMapSwitch.h"
+#include "util/text_buffer.h"
 
-#include <boost/any.hpp>
+#include <iterator>
 #include <ostream>
 #include <string>
+#include <type_traits>
 #include <limits>
+#include <variant>
 
 namespace dns
 {
@@ -48,34 +51,48 @@ namespace dns
          }
       };
 
+      using record_type_map_t = util::TypeList <
+                                /**/ util::TypeMap<rr_type_t, rr_type_t::rec_a,     rec_a_t>,
+                                /**/ util::TypeMap<rr_type_t, rr_type_t::rec_mx,    rec_mx_t>,
+                                /**/ util::TypeMap<rr_type_t, rr_type_t::rec_ptr,   rec_ptr_t>,
+                                /**/ util::TypeMap<rr_type_t, rr_type_t::rec_ns,    rec_ns_t>,
+                                /**/ util::TypeMap<rr_type_t, rr_type_t::rec_txt,   rec_txt_t>,
+                                /**/ util::TypeMap<rr_type_t, rr_type_t::rec_soa,   rec_soa_t>,
+                                /**/ util::TypeMap<rr_type_t, rr_type_t::rec_cname, rec_cname_t>
+                                >;
+
       template<class TypeT, class F, class G>
       void TYPE_MAP_SWITCH_DISPATCH(TypeT&& ty, F&& fu, G&& gu)
       {
-         using namespace util;
-
-         using TYPE_MAP_SWITCH = TypeMapSwitch_t <
-                                 /**/ TypeMap<rr_type_t, rr_type_t::rec_a,     rec_a_t>,
-                                 /**/ TypeMap<rr_type_t, rr_type_t::rec_mx,    rec_mx_t>,
-                                 /**/ TypeMap<rr_type_t, rr_type_t::rec_ptr,   rec_ptr_t>,
-                                 /**/ TypeMap<rr_type_t, rr_type_t::rec_ns,    rec_ns_t>,
-                                 /**/ TypeMap<rr_type_t, rr_type_t::rec_txt,   rec_txt_t>,
-                                 /**/ TypeMap<rr_type_t, rr_type_t::rec_soa,   rec_soa_t>,
-                                 /**/ TypeMap<rr_type_t, rr_type_t::rec_cname, rec_cname_t>
-                                 >;
+         using TYPE_MAP_SWITCH = util::TypeMapListSwitch_t<record_type_map_t>;
 
          TYPE_MAP_SWITCH::dispatch<RecordTypeActionImpl>(std::forward<TypeT>(ty), std::forward<F>(fu), std::forward<G>(gu));
       }
+
+      template<class TypeMapListT>
+      struct rdata_variant;
+
+      template<class... TypeMapT>
+      struct rdata_variant< util::TypeList<TypeMapT...> >
+      {
+         using type = std::variant<rec_raw_t, util::ExtractType_t<TypeMapT>...>;
+      };
    }
 
+   /*
+    * Rdata of any of the record types known to TYPE_MAP_SWITCH_DISPATCH, or the raw bytes otherwise.
+    */
+   using rdata_t = typename detail::rdata_variant<detail::record_type_map_t>::type;
+
    class answer_t
    {
       public:
-         void Name(const std::string& name)
+         void Name(dname_t name)
          {
-            m_name = name;
+            m_name = std::move(name);
          }
 
-         std::string Name() const
+         const dname_t& Name() const
          {
             return m_name;
          }
@@ -111,80 +128,98 @@ namespace dns
          }
 
          template<class RecordT>
-         RecordT Data() const
+         const RecordT& Data() const
          {
-            return boost::any_cast<RecordT>(m_rec);
+            return std::get<RecordT>(m_rdata);
          }
 
          template<class RecordT>
-         void Data(RecordT&& v)
+         RecordT& Data()
          {
-            m_rec = std::forward<RecordT>(v);
+            return std::get<RecordT>(m_rdata);
          }
 
-         friend std::ostream& operator<<(std::ostream& os, const answer_t& rhs)
+         // a record is constructed anew rather than assigned over, so it keeps the allocator it came with
+         template<class RecordT>
+         void Data(RecordT&& v)
          {
-            os << "{ Name=" << rhs.Name() << ", Type=" << rhs.Type() << ", Class=" << rhs.Class() << ", TTL=" << rhs.TTL() << ", REC=";
-
-            detail::TYPE_MAP_SWITCH_DISPATCH(
-               rhs.Type(),
-
-               [&os, &rhs](auto rt)
-            {
-               using RT = std::remove_reference_t<decltype(*rt)>;
-               os << rhs.Data<RT>();
-            },
-
-            [&os, &rhs](auto)
-            {
-               os << util::oct_dump(rhs.Data<std::string>());
-            });
+            if constexpr(std::is_same<std::decay_t<RecordT>, rdata_t>::value)
+               m_rdata = std::forward<RecordT>(v);
+            else
+               m_rdata.template emplace<std::decay_t<RecordT>>(std::forward<RecordT>(v));
+         }
 
-            os << " }";
-            return os;
+         const rdata_t& RData() const
+         {
+            return m_rdata;
          }
 
-         friend bool operator==(const answer_t& lhs, const answer_t& rhs)
+         // true if the record held is of Type() - rec_raw_t, the bytes as they are, is of any type
+         bool DataMatchesType() const
          {
-            if(lhs.Name() == rhs.Name() &&
-                  lhs.Type() == rhs.Type() &&
-                  lhs.Class() == rhs.Class() &&
-                  lhs.TTL() == rhs.TTL()
-              )
+            return std::visit([this](auto&& rec)
             {
-               bool result = false;
-
-               detail::TYPE_MAP_SWITCH_DISPATCH(
-                  rhs.Type(),
+               using RT = std::decay_t<decltype(rec)>;
 
-                  [&lhs, &rhs, &result](auto rt)
-               {
-                  using RT = std::remove_reference_t<decltype(*rt)>;
-                  result = lhs.Data<RT>() == rhs.Data<RT>();
-               },
+               if constexpr(std::is_same<RT, rec_raw_t>::value)
+                  return true;
+               else
+                  return RT::m_type == m_type;
+            }, m_rdata);
+         }
 
-               [&lhs, &rhs, &result](auto)
-               {
-                  result = false;
-               });
+         // calls fu with the record held, e.g. rec_mx_t const&, or rec_raw_t const& for unknown types
+         template<class F>
+         decltype(auto) Visit(F&& fu) const
+         {
+            return std::visit(std::forward<F>(fu), m_rdata);
+         }
 
-               return result;
-            }
+         friend std::ostream& operator<<(std::ostream& os, const answer_t& rhs)
+         {
+            return util::print(os, rhs);
+         }
 
-            return false;
+         // throws exception::bad_record_type for a record holding rdata of another type
+         friend bool operator==(const answer_t& lhs, const answer_t& rhs)
+         {
+            if(!lhs.DataMatchesType() || !rhs.DataMatchesType())
+               throw dns::exception::bad_record_type("rdata not of the record type", 1);
+
+            return lhs.Name() == rhs.Name() &&
+                   lhs.Type() == rhs.Type() &&
+                   lhs.Class() == rhs.Class() &&
+                   lhs.TTL() == rhs.TTL() &&
+                   lhs.RData() == rhs.RData();
          }
 
       private:
-         std::string m_name;
+         dname_t m_name;
          rr_type_t m_type = rr_type_t::rec_a;
          rr_class_t m_class = rr_class_t::internet;
          int32_t m_TTL = 0;
-         boost::any m_rec;
+         rdata_t m_rdata;
    };
 
+   inline void print_to(util::text_buffer_t& b, const answer_t& r)
+   {
+      b << "{ Name=" << r.Name() << ", Type=" << r.Type() << ", Class=" << r.Class() << ", TTL=" << r.TTL() << ", REC=";
+
+      r.Visit([&b](auto&& rec)
+      {
+         print_to(b, rec);
+      });
+
+      b << " }";
+   }
+
+   // throws exception::bad_record_type, before writing anything, for rdata of another type
    inline void save_to(name_offset_tracker_t& tr, const answer_t& r)
    {
-      save_to(tr, label_list_t{r.Name()});
+      if(!r.DataMatchesType())
+         throw dns::exception::bad_record_type("rdata not of the record type", 1);
+
+      save_to(tr, r.Name());
       save_to(tr, static_cast<uint16_t>(r.Type()));
       save_to(tr, static_cast<uint16_t>(r.Class()));
       save_to(tr, r.TTL());
@@ -192,35 +227,42 @@ namespace dns
       uint16_t offset = tr.current_offset();
       save_to(tr, static_cast<uint16_t>(0));
 
-      detail::TYPE_MAP_SWITCH_DISPATCH(
-         r.Type(),
-
-         [&tr, &r](auto rt)
+      r.Visit([&tr](auto&& rec)
       {
-         using RT = std::remove_reference_t<decltype(*rt)>;
-         save_to(tr, r.Data<RT>());
-      },
-
-      [&tr, &r](auto)
-      {
-         for(auto && c : r.Data<std::string>())
-            save_to(tr, static_cast<uint8_t>(c));
+         save_to(tr, rec);
       });
 
-      auto&& ptr = tr.slice(offset, offset + sizeof(offset));
-      save_to(*ptr, static_cast<uint16_t>(tr.current_offset() - sizeof(offset) - offset));
+      tr.patch(offset, static_cast<uint16_t>(tr.current_offset() - sizeof(offset) - offset));
    }
 
    template<>
    struct LoadImpl<answer_t>
    {
+      template<class InputIterator>
+      static void load_rdata(answer_t& r, name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
+      {
+         detail::TYPE_MAP_SWITCH_DISPATCH(
+            r.Type(),
+
+            [&r, &tr, &ii, end](auto rt)
+         {
+            using RT = std::remove_reference_t<decltype(*rt)>;
+            r.Data(load_from<RT>(tr, ii, end));
+         },
+
+         [&r, &tr, &ii, end](auto)
+         {
+            r.Data(load_from<rec_raw_t>(tr, ii, end));
+         });
+      }
+
       template<class InputIterator>
       static answer_t impl(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
       {
          answer_t r{};
 
          {
-            r.Name(load_from<label_list_t>(tr, ii, end).Name());
+            r.Name(load_from<dname_t>(tr, ii, end));
             r.Type(static_cast<rr_type_t>(load_from<uint16_t>(tr, ii, end)));
             r.Class(static_cast<rr_class_t>(load_from<uint16_t>(tr, ii, end)));
             r.TTL(load_from<uint32_t>(tr, ii, end));
@@ -228,38 +270,38 @@ namespace dns
 
          {
             uint16_t record_length = load_from<uint16_t>(tr, ii, end);
-            uint16_t record_offset = tr.current_offset();
 
-            for(uint16_t i = 0; i < record_length; ++i)
-               load_from<uint8_t>(tr, ii, end);
+            using category_t = typename std::iterator_traits<InputIterator>::iterator_category;
 
-            if(auto && rec_tr = tr.slice(record_offset, record_offset + record_length))
+            if constexpr(std::is_base_of<std::random_access_iterator_tag, category_t>::value)
             {
-               auto&& rec_b = rec_tr->cbegin();
-               auto&& rec_e = rec_tr->cend();
+               if(end - ii < record_length)
+                  throw dns::exception::bad_data_stream("truncated", 1);
 
-               detail::TYPE_MAP_SWITCH_DISPATCH(
-                  r.Type(),
+               auto&& record_end = ii + record_length;
 
-                  [&r, &rec_tr, &rec_b, &rec_e](auto rt)
-               {
-                  using RT = std::remove_reference_t<decltype(*rt)>;
-                  r.Data(load_from<RT>(*rec_tr, rec_b, rec_e));
-               },
+               load_rdata(r, tr, ii, record_end);
 
-               [&r, &rec_tr, &rec_b, &rec_e, record_length](auto)
-               {
-                  auto&& raw_data = std::string{};
+               if(ii != record_end)
+                  throw dns::exception::bad_data_stream("bad record", 5);
+            }
+            else
+            {
+               // counting what is read against RDLENGTH, in one pass
+
+               using bounded_t = detail::bounded_input_t<InputIterator>;
 
-                  raw_data.resize(record_length);
-                  for(uint16_t i = 0; i < record_length; ++i)
-                     raw_data[i] = load_from<uint8_t>(*rec_tr, rec_b, rec_e);
+               auto&& state = typename bounded_t::state_t{ii, end, record_length};
+               auto&& b = bounded_t{&state, false};
 
-                  r.Data(raw_data);
-               });
+               load_rdata(r, tr, b, bounded_t{&state, true});
+
+               if(state.left != 0 && ii == end)
+                  throw dns::exception::bad_data_stream("truncated", 1);
+
+               if(state.left != 0)
+                  throw dns::exception::bad_data_stream("bad record", 5);
             }
-            else
-               throw dns::exception::bad_data_stream("bad record", 5);
          }
 
          return r;
@@ -0,0 +1,488 @@
+#pragma once
+
+#include "dns/decode_status.h"
+#include "dns/dname.h"
+#include "dns/header.h"
+#include "dns/rr_type.h"
+#include "dns/rr_class.h"
+
+#include "dns/detail/byte_order.h"
+#include "dns/detail/check_message.h"
+#include "dns/detail/label_list/walk.h"
+#include "dns/detail/name_offset_tracker.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dns
+{
+   // one captured message, e.g. a UDP payload
+   struct packet_t
+   {
+      const uint8_t* data;
+      std::size_t size;
+   };
+
+   // a decompressed name in the batch's name pool
+   struct name_ref_t
+   {
+      uint32_t offset;
+      uint8_t size;
+   };
+
+   enum class section_t : uint8_t
+   {
+      answer,
+      authority,
+      additional,
+   };
+
+   /*
+    * Decodes many messages into columns - one array per field, all allocated from the
+    * decoder's own arena - for scanning captures rather than answering queries:
+    *
+    *    auto&& batch = dns::batch_decoder_t{};
+    *
+    *    batch.decode(packets, count);
+    *
+    *    for(std::size_t r = 0; r < batch.RecordCount(); ++r)
+    *       if(batch.RecordType()[r] == dns::rr_type_t::rec_a)
+    *          ...
+    *
+    * Packet 'p' has the questions [QuestionBegin()[p], QuestionBegin()[p + 1]) and the
+    * records [RecordBegin()[p], RecordBegin()[p + 1]). Malformed packets keep their row,
+    * with the reason in Status() and no questions or records.
+    *
+    * Names are stored once per packet, decompressed in wire form, in a shared pool. Rdata
+    * is left where it is: RecordDataOffset() is relative to the packet, which must outlive
+    * the decoder's use of it. Packets over max_packet_size fail with decode_errc_t::too_long.
+    *
+    * The arena never frees, so columns grow geometrically - decoding in many small calls
+    * takes about as much memory as one call for them all.
+    */
+   class batch_decoder_t
+   {
+      public:
+         static constexpr std::size_t prefetch_distance = 4;
+         static constexpr std::size_t max_packet_size = detail::max_message_size;
+
+         explicit batch_decoder_t(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : m_arena(upstream)
+            , m_status(&m_arena)
+            , m_id(&m_arena)
+            , m_flags(&m_arena)
+            , m_question_begin(1, 0, &m_arena)
+            , m_record_begin(1, 0, &m_arena)
+            , m_question_name(&m_arena)
+            , m_question_type(&m_arena)
+            , m_question_class(&m_arena)
+            , m_record_packet(&m_arena)
+            , m_record_section(&m_arena)
+            , m_record_owner(&m_arena)
+            , m_record_type(&m_arena)
+            , m_record_class(&m_arena)
+            , m_record_ttl(&m_arena)
+            , m_record_data_offset(&m_arena)
+            , m_record_data_length(&m_arena)
+            , m_names(&m_arena)
+         {
+         }
+
+         batch_decoder_t(const batch_decoder_t&) = delete;
+         batch_decoder_t& operator=(const batch_decoder_t&) = delete;
+
+         // room for 'packets' more, assuming typical responses
+         void reserve(std::size_t packets)
+         {
+            std::size_t n = PacketCount() + packets;
+
+            grow(m_status, n);
+            grow(m_id, n);
+            grow(m_flags, n);
+            grow(m_question_begin, n + 1);
+            grow(m_record_begin, n + 1);
+
+            reserve_questions(QuestionCount() + packets);
+            reserve_records(RecordCount() + 4 * packets);
+
+            grow(m_names, m_names.size() + 64 * packets);
+         }
+
+         // empties the columns, keeping their capacity
+         void clear()
+         {
+            m_status.clear();
+            m_id.clear();
+            m_flags.clear();
+            m_question_begin.resize(1);
+            m_record_begin.resize(1);
+
+            m_question_name.clear();
+            m_question_type.clear();
+            m_question_class.clear();
+
+            m_record_packet.clear();
+            m_record_section.clear();
+            m_record_owner.clear();
+            m_record_type.clear();
+            m_record_class.clear();
+            m_record_ttl.clear();
+            m_record_data_offset.clear();
+            m_record_data_length.clear();
+
+            m_names.clear();
+         }
+
+         /*
+          * Appends the given packets, prefetching a few ahead of the one being decoded.
+          */
+         void decode(const packet_t* packets, std::size_t count)
+         {
+            reserve(count);
+
+            for(std::size_t i = 0; i < count; ++i)
+            {
+               if(i + prefetch_distance < count)
+               {
+                  __builtin_prefetch(packets[i + prefetch_distance].data);
+                  __builtin_prefetch(packets[i + prefetch_distance].data + 64);
+               }
+
+               decode(packets[i]);
+            }
+         }
+
+         void decode(const packet_t& packet)
+         {
+            std::size_t section_offset[5];
+
+            auto&& status = detail::check_sections(packet.data, packet.size, section_offset, true);
+
+            m_status.push_back(status);
+
+            if(status)
+            {
+               m_id.push_back(packet.size >= 2 ? detail::peek_id(packet.data) : 0);
+               m_flags.push_back(packet.size >= 4 ? detail::peek_flags(packet.data) : 0);
+            }
+            else
+            {
+               decode_checked(packet.data, section_offset);
+            }
+
+            m_question_begin.push_back(QuestionCount());
+            m_record_begin.push_back(RecordCount());
+         }
+
+         /*
+          * Splits the packets into as many chunks as there are decoders in [first, last),
+          * each decoded by its own thread into its own decoder (the first chunk on the
+          * calling thread).
+          */
+         template<class DecoderIterator>
+         static void decode_parallel(const packet_t* packets, std::size_t count, DecoderIterator first, DecoderIterator last)
+         {
+            auto&& chunks = static_cast<std::size_t>(std::distance(first, last));
+
+            if(chunks == 0)
+               return;
+
+            auto&& threads = std::vector<std::thread>{};
+            threads.reserve(chunks - 1);
+
+            auto&& chunk_size = (count + chunks - 1) / chunks;
+
+            std::size_t begin = std::min(count, chunk_size);
+
+            for(auto&& it = std::next(first); it != last; ++it)
+            {
+               std::size_t end = std::min(count, begin + chunk_size);
+
+               threads.emplace_back([&decoder = *it, packets, begin, end]
+               {
+                  decoder.decode(packets + begin, end - begin);
+               });
+
+               begin = end;
+            }
+
+            (*first).decode(packets, std::min(count, chunk_size));
+
+            for(auto&& t : threads)
+               t.join();
+         }
+
+         std::size_t PacketCount() const
+         {
+            return m_status.size();
+         }
+
+         std::size_t QuestionCount() const
+         {
+            return m_question_name.size();
+         }
+
+         std::size_t RecordCount() const
+         {
+            return m_record_packet.size();
+         }
+
+         // per packet
+
+         const std::pmr::vector<decode_status_t>& Status() const
+         {
+            return m_status;
+         }
+
+         const std::pmr::vector<uint16_t>& ID() const
+         {
+            return m_id;
+         }
+
+         // the flag word, as header_t::Flags()
+         const std::pmr::vector<uint16_t>& Flags() const
+         {
+            return m_flags;
+         }
+
+         const std::pmr::vector<uint32_t>& QuestionBegin() const
+         {
+            return m_question_begin;
+         }
+
+         const std::pmr::vector<uint32_t>& RecordBegin() const
+         {
+            return m_record_begin;
+         }
+
+         // per question
+
+         const std::pmr::vector<name_ref_t>& QuestionName() const
+         {
+            return m_question_name;
+         }
+
+         const std::pmr::vector<rr_type_t>& QuestionType() const
+         {
+            return m_question_type;
+         }
+
+         const std::pmr::vector<rr_class_t>& QuestionClass() const
+         {
+            return m_question_class;
+         }
+
+         // per record
+
+         const std::pmr::vector<uint32_t>& RecordPacket() const
+         {
+            return m_record_packet;
+         }
+
+         const std::pmr::vector<section_t>& RecordSection() const
+         {
+            return m_record_section;
+         }
+
+         const std::pmr::vector<name_ref_t>& RecordOwner() const
+         {
+            return m_record_owner;
+         }
+
+         const std::pmr::vector<rr_type_t>& RecordType() const
+         {
+            return m_record_type;
+         }
+
+         const std::pmr::vector<rr_class_t>& RecordClass() const
+         {
+            return m_record_class;
+         }
+
+         const std::pmr::vector<uint32_t>& RecordTTL() const
+         {
+            return m_record_ttl;
+         }
+
+         const std::pmr::vector<uint16_t>& RecordDataOffset() const
+         {
+            return m_record_data_offset;
+         }
+
+         const std::pmr::vector<uint16_t>& RecordDataLength() const
+         {
+            return m_record_data_length;
+         }
+
+         // names
+
+         std::string_view NameWire(name_ref_t n) const
+         {
+            return std::string_view{reinterpret_cast<const char*>(m_names.data()) + n.offset, n.size};
+         }
+
+         dname_t Name(name_ref_t n) const
+         {
+            auto&& tr = name_offset_tracker_t::read_in_place(m_names.data(), n.offset);
+            const uint8_t* b = m_names.data() + n.offset;
+
+            return load_from<dname_t>(tr, b, b + n.size);
+         }
+
+      private:
+         // room for 'n', at least doubling when it has to grow
+         template<class T>
+         static void grow(std::pmr::vector<T>& v, std::size_t n)
+         {
+            if(n > v.capacity())
+               v.reserve(std::max(n, 2 * v.capacity()));
+         }
+
+         void reserve_questions(std::size_t n)
+         {
+            grow(m_question_name, n);
+            grow(m_question_type, n);
+            grow(m_question_class, n);
+         }
+
+         void reserve_records(std::size_t n)
+         {
+            grow(m_record_packet, n);
+            grow(m_record_section, n);
+            grow(m_record_owner, n);
+            grow(m_record_type, n);
+            grow(m_record_class, n);
+            grow(m_record_ttl, n);
+            grow(m_record_data_offset, n);
+            grow(m_record_data_length, n);
+         }
+
+         /*
+          * Names already pooled for the packet being decoded, by where they start in it - a
+          * name that is only a pointer to one of these (e.g. an owner pointing back at the
+          * question) reuses it.
+          */
+         struct seen_names_t
+         {
+            static constexpr std::size_t capacity = 16;
+
+            uint16_t offset[capacity];
+            name_ref_t ref[capacity];
+            std::size_t size = 0;
+         };
+
+         name_ref_t pool_name(const uint8_t* msg, std::size_t size, std::size_t& offset, seen_names_t& seen)
+         {
+            if((msg[offset] & 0xC0) == 0xC0)
+            {
+               auto&& target = static_cast<uint16_t>(detail::load_be16(msg + offset) & 0x3FFF);
+
+               for(std::size_t i = 0; i < seen.size; ++i)
+               {
+                  if(seen.offset[i] == target)
+                  {
+                     offset += 2;
+                     return seen.ref[i];
+                  }
+               }
+            }
+
+            auto&& start = static_cast<uint16_t>(offset);
+            auto&& ref = name_ref_t{static_cast<uint32_t>(m_names.size()), 0};
+
+            // already checked, cannot fail
+            detail::walk_name(msg, size, offset, [this](const uint8_t* label, uint8_t sz)
+            {
+               m_names.push_back(sz);
+               m_names.insert(m_names.end(), label, label + sz);
+            });
+
+            m_names.push_back(0);
+            ref.size = static_cast<uint8_t>(m_names.size() - ref.offset);
+
+            if(seen.size < seen_names_t::capacity)
+            {
+               seen.offset[seen.size] = start;
+               seen.ref[seen.size] = ref;
+               ++seen.size;
+            }
+
+            return ref;
+         }
+
+         void decode_checked(const uint8_t* msg, const std::size_t (&section_offset)[5])
+         {
+            auto&& h = detail::load_header(msg);
+            auto&& size = section_offset[4];
+            auto&& packet = static_cast<uint32_t>(m_status.size() - 1);
+
+            seen_names_t seen;
+
+            m_id.push_back(h.ID());
+            m_flags.push_back(h.Flags());
+
+            std::size_t offset = section_offset[0];
+
+            for(uint16_t i = 0; i < h.QdCount(); ++i)
+            {
+               m_question_name.push_back(pool_name(msg, size, offset, seen));
+               m_question_type.push_back(static_cast<rr_type_t>(detail::load_be16(msg + offset)));
+               m_question_class.push_back(static_cast<rr_class_t>(detail::load_be16(msg + offset + 2)));
+
+               offset += 4;
+            }
+
+            const uint16_t counts[] = { h.AnCount(), h.NsCount(), h.ArCount() };
+
+            for(auto x = 0; x < 3; ++x)
+            {
+               for(uint16_t i = 0; i < counts[x]; ++i)
+               {
+                  m_record_packet.push_back(packet);
+                  m_record_section.push_back(static_cast<section_t>(x));
+                  m_record_owner.push_back(pool_name(msg, size, offset, seen));
+                  m_record_type.push_back(static_cast<rr_type_t>(detail::load_be16(msg + offset)));
+                  m_record_class.push_back(static_cast<rr_class_t>(detail::load_be16(msg + offset + 2)));
+                  m_record_ttl.push_back(detail::load_be32(msg + offset + 4));
+
+                  auto&& length = detail::load_be16(msg + offset + 8);
+
+                  m_record_data_offset.push_back(static_cast<uint16_t>(offset + 10));
+                  m_record_data_length.push_back(length);
+
+                  offset += 10 + length;
+               }
+            }
+         }
+
+      private:
+         std::pmr::monotonic_buffer_resource m_arena;
+
+         std::pmr::vector<decode_status_t> m_status;
+         std::pmr::vector<uint16_t> m_id;
+         std::pmr::vector<uint16_t> m_flags;
+         std::pmr::vector<uint32_t> m_question_begin;
+         std::pmr::vector<uint32_t> m_record_begin;
+
+         std::pmr::vector<name_ref_t> m_question_name;
+         std::pmr::vector<rr_type_t> m_question_type;
+         std::pmr::vector<rr_class_t> m_question_class;
+
+         std::pmr::vector<uint32_t> m_record_packet;
+         std::pmr::vector<section_t> m_record_section;
+         std::pmr::vector<name_ref_t> m_record_owner;
+         std::pmr::vector<rr_type_t> m_record_type;
+         std::pmr::vector<rr_class_t> m_record_class;
+         std::pmr::vector<uint32_t> m_record_ttl;
+         std::pmr::vector<uint16_t> m_record_data_offset;
+         std::pmr::vector<uint16_t> m_record_data_length;
+
+         std::pmr::vector<uint8_t> m_names;
+   };
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#include "dns/exception/bad_data_stream.h"
+
+namespace dns
+{
+   /*
+    * Why a message failed to decode.
+    */
+   enum class decode_errc_t
+   {
+      ok = 0,
+      truncated,        // a fixed size field or the rdata runs past the end
+      name_truncated,   // a name runs past the end
+      label_too_long,   // a label length octet above 63 (and not a pointer)
+      name_too_long,    // a name over 255 bytes or 127 labels once decompressed
+      bad_pointer,      // a compression pointer not strictly backwards, or looping
+      bad_rdata,        // the rdata is longer than its record type takes
+      too_long,         // a message over 65535 bytes, more than its offsets can address
+   };
+
+   inline const char* mnemonic(decode_errc_t e)
+   {
+      switch(e)
+      {
+         case decode_errc_t::ok:
+            return "ok";
+         case decode_errc_t::truncated:
+            return "truncated";
+         case decode_errc_t::name_truncated:
+            return "name truncated";
+         case decode_errc_t::label_too_long:
+            return "label too long";
+         case decode_errc_t::name_too_long:
+            return "name too long";
+         case decode_errc_t::bad_pointer:
+            return "bad compression pointer";
+         case decode_errc_t::bad_rdata:
+            return "bad rdata";
+         case decode_errc_t::too_long:
+            return "message too long";
+      }
+
+      return "unknown";
+   }
+
+   inline const std::error_category& decode_category()
+   {
+      struct category_t : std::error_category
+      {
+         const char* name() const noexcept override
+         {
+            return "dns::decode";
+         }
+
+         std::string message(int e) const override
+         {
+            return mnemonic(static_cast<decode_errc_t>(e));
+         }
+      };
+
+      static const category_t category;
+
+      return category;
+   }
+
+   inline std::error_code make_error_code(decode_errc_t e)
+   {
+      return std::error_code{static_cast<int>(e), decode_category()};
+   }
+
+   /*
+    * Outcome of a non throwing decode: like std::error_code it is true when decoding
+    * failed, and then also tells the message offset of the field it failed at.
+    */
+   struct decode_status_t
+   {
+      decode_errc_t reason = decode_errc_t::ok;
+      std::size_t offset = 0;
+
+      explicit operator bool() const
+      {
+         return reason != decode_errc_t::ok;
+      }
+
+      std::error_code code() const
+      {
+         return make_error_code(reason);
+      }
+   };
+
+   /*
+    * For the throwing decode functions - the exceptions they have always thrown.
+    */
+   inline void throw_if_failed(const decode_status_t& s)
+   {
+      switch(s.reason)
+      {
+         case decode_errc_t::ok:
+            return;
+         case decode_errc_t::truncated:
+            throw dns::exception::bad_data_stream("truncated", 1);
+         case decode_errc_t::name_truncated:
+            throw dns::exception::bad_data_stream("truncated", 2);
+         case decode_errc_t::label_too_long:
+         case decode_errc_t::name_too_long:
+            throw dns::exception::bad_data_stream("length too long", 2);
+         case decode_errc_t::bad_pointer:
+            throw dns::exception::bad_data_stream("bad offset", 1);
+         case decode_errc_t::bad_rdata:
+            throw dns::exception::bad_data_stream("bad record", 5);
+         case decode_errc_t::too_long:
+            throw dns::exception::bad_data_stream("length too long", 1);
+      }
+   }
+}
+
+namespace std
+{
+   template<>
+   struct is_error_code_enum<dns::decode_errc_t> : true_type
+   {
+   };
+}
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <ostream>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "dns/detail/name_offset_tracker.h"
+#include "dns/detail/byte_order.h"
 #include "dns/exception/bad_data_stream.h"
 
 namespace dns
@@ -15,16 +20,142 @@ namespace dns
 
    void save_to(name_offset_tracker_t& tr, uint16_t x)
    {
-      save_to(tr, static_cast<uint8_t>((x >> 8) & 0xFF));
-      save_to(tr, static_cast<uint8_t>((x >> 0) & 0xFF));
+      uint8_t buf[sizeof(x)];
+      detail::store_be16(buf, x);
+      tr.save(buf, sizeof(buf));
    }
 
    void save_to(name_offset_tracker_t& tr, uint32_t x)
    {
-      save_to(tr, static_cast<uint8_t>((x >> 24) & 0xFF));
-      save_to(tr, static_cast<uint8_t>((x >> 16) & 0xFF));
-      save_to(tr, static_cast<uint8_t>((x >> 8) & 0xFF));
-      save_to(tr, static_cast<uint8_t>((x >> 0) & 0xFF));
+      uint8_t buf[sizeof(x)];
+      detail::store_be32(buf, x);
+      tr.save(buf, sizeof(buf));
+   }
+
+   namespace detail
+   {
+      /*
+       * Iterators over contiguous single byte storage - loads from these can check the
+       * bounds once and read the bytes in place instead of one at a time.
+       */
+      template<class It>
+      struct is_contiguous_byte_iterator
+         : std::bool_constant <
+           (std::is_pointer<It>::value && sizeof(*std::declval<It>()) == 1) ||
+           std::is_same<It, std::string::iterator>::value ||
+           std::is_same<It, std::string::const_iterator>::value ||
+           std::is_same<It, std::vector<uint8_t>::iterator>::value ||
+           std::is_same<It, std::vector<uint8_t>::const_iterator>::value ||
+           std::is_same<It, std::vector<char>::iterator>::value ||
+           std::is_same<It, std::vector<char>::const_iterator>::value >
+      {
+      };
+
+      // 'ii' must be dereferenceable
+      template<class It>
+      const uint8_t* byte_pointer(It ii)
+      {
+         return reinterpret_cast<const uint8_t*>(&*ii);
+      }
+
+      /*
+       * One bounds check and one unaligned load for an N byte field, instead of N single
+       * byte loads.
+       */
+      template<std::size_t N, class It, class Load>
+      auto load_in_place(name_offset_tracker_t& tr, It& ii, It end, Load&& load)
+      {
+         if(end - ii < static_cast<std::ptrdiff_t>(N))
+            throw dns::exception::bad_data_stream("truncated", 1);
+
+         auto&& p = byte_pointer(ii);
+
+         tr.save(p, N);
+         ii += N;
+
+         return load(p);
+      }
+   }
+
+   namespace detail
+   {
+      /*
+       * At most 'left' bytes of an input range, where the end of a record cannot be found
+       * up front without a second pass over it. Copies share the position, as they do for
+       * single pass iterators; bytes read advance the underlying 'ii' itself.
+       */
+      template<class It>
+      class bounded_input_t
+      {
+         public:
+            struct state_t
+            {
+               It& ii;
+               It end;
+               std::size_t left;
+            };
+
+            using iterator_category = std::input_iterator_tag;
+            using value_type = typename std::iterator_traits<It>::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = value_type;
+
+            // for *ii++
+            struct postfix_t
+            {
+               value_type v;
+
+               value_type operator*() const
+               {
+                  return v;
+               }
+            };
+
+            bounded_input_t(state_t* state, bool is_end)
+               : m_state(state)
+               , m_is_end(is_end)
+            {
+            }
+
+            value_type operator*() const
+            {
+               return *m_state->ii;
+            }
+
+            bounded_input_t& operator++()
+            {
+               ++m_state->ii;
+               --m_state->left;
+               return *this;
+            }
+
+            postfix_t operator++(int)
+            {
+               auto&& p = postfix_t{**this};
+               ++*this;
+               return p;
+            }
+
+            friend bool operator==(const bounded_input_t& lhs, const bounded_input_t& rhs)
+            {
+               return lhs.done() == rhs.done();
+            }
+
+            friend bool operator!=(const bounded_input_t& lhs, const bounded_input_t& rhs)
+            {
+               return !(lhs == rhs);
+            }
+
+         private:
+            bool done() const
+            {
+               return m_is_end || m_state->left == 0 || m_state->ii == m_state->end;
+            }
+
+            state_t* m_state;
+            bool m_is_end;
+      };
    }
 
    template<class T>
@@ -57,11 +188,18 @@ namespace dns
       template<class InputIterator>
       static uint16_t impl(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
       {
-         uint8_t x1 = load_from<uint8_t>(tr, ii, end);
-         uint8_t x2 = load_from<uint8_t>(tr, ii, end);
+         if constexpr(detail::is_contiguous_byte_iterator<InputIterator>::value)
+         {
+            return detail::load_in_place<sizeof(uint16_t)>(tr, ii, end, detail::load_be16);
+         }
+         else
+         {
+            uint8_t x1 = load_from<uint8_t>(tr, ii, end);
+            uint8_t x2 = load_from<uint8_t>(tr, ii, end);
 
-         return (static_cast<uint16_t>(x1) << 8) |
-                (static_cast<uint16_t>(x2));
+            return (static_cast<uint16_t>(x1) << 8) |
+                   (static_cast<uint16_t>(x2));
+         }
       }
    };
 
@@ -71,15 +209,22 @@ namespace dns
       template<class InputIterator>
       static uint32_t impl(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
       {
-         uint8_t x1 = load_from<uint8_t>(tr, ii, end);
-         uint8_t x2 = load_from<uint8_t>(tr, ii, end);
-         uint8_t x3 = load_from<uint8_t>(tr, ii, end);
-         uint8_t x4 = load_from<uint8_t>(tr, ii, end);
-
-         return (static_cast<uint16_t>(x1) << 24) |
-                (static_cast<uint16_t>(x2) << 16) |
-                (static_cast<uint16_t>(x3) << 8) |
-                (static_cast<uint16_t>(x4));
+         if constexpr(detail::is_contiguous_byte_iterator<InputIterator>::value)
+         {
+            return detail::load_in_place<sizeof(uint32_t)>(tr, ii, end, detail::load_be32);
+         }
+         else
+         {
+            uint8_t x1 = load_from<uint8_t>(tr, ii, end);
+            uint8_t x2 = load_from<uint8_t>(tr, ii, end);
+            uint8_t x3 = load_from<uint8_t>(tr, ii, end);
+            uint8_t x4 = load_from<uint8_t>(tr, ii, end);
+
+            return (static_cast<uint32_t>(x1) << 24) |
+                   (static_cast<uint32_t>(x2) << 16) |
+                   (static_cast<uint32_t>(x3) << 8) |
+                   (static_cast<uint32_t>(x4));
+         }
       }
    };
 }
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace dns
+{
+   namespace detail
+   {
+      inline uint16_t from_big_endian(uint16_t x)
+      {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+         return __builtin_bswap16(x);
+#else
+         return x;
+#endif
+      }
+
+      inline uint32_t from_big_endian(uint32_t x)
+      {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+         return __builtin_bswap32(x);
+#else
+         return x;
+#endif
+      }
+
+      inline uint16_t to_big_endian(uint16_t x)
+      {
+         return from_big_endian(x);
+      }
+
+      inline uint32_t to_big_endian(uint32_t x)
+      {
+         return from_big_endian(x);
+      }
+
+      inline uint16_t load_be16(const uint8_t* p)
+      {
+         uint16_t x;
+         std::memcpy(&x, p, sizeof(x));
+         return from_big_endian(x);
+      }
+
+      inline uint32_t load_be32(const uint8_t* p)
+      {
+         uint32_t x;
+         std::memcpy(&x, p, sizeof(x));
+         return from_big_endian(x);
+      }
+
+      inline void store_be16(uint8_t* p, uint16_t x)
+      {
+         x = to_big_endian(x);
+         std::memcpy(p, &x, sizeof(x));
+      }
+
+      inline void store_be32(uint8_t* p, uint32_t x)
+      {
+         x = to_big_endian(x);
+         std::memcpy(p, &x, sizeof(x));
+      }
+   }
+}
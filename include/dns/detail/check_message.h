@@ -0,0 +1,278 @@
+#pragma once
+
+#include "dns/decode_status.h"
+#include "dns/header.h"
+#include "dns/dname.h"
+#include "dns/answer.h"
+
+#include "dns/detail/byte_order.h"
+#include "dns/detail/label_list/walk.h"
+#include "dns/detail/name_kernel.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dns
+{
+   namespace detail
+   {
+      inline decode_errc_t to_decode_errc(walk_result_t r)
+      {
+         switch(r)
+         {
+            case walk_result_t::ok:
+               return decode_errc_t::ok;
+            case walk_result_t::truncated:
+               return decode_errc_t::name_truncated;
+            case walk_result_t::length_too_long:
+               return decode_errc_t::label_too_long;
+            case walk_result_t::bad_offset:
+               return decode_errc_t::bad_pointer;
+         }
+
+         return decode_errc_t::bad_pointer;
+      }
+
+      /*
+       * Steps 'offset' past the name stored there. Deep, the name is also followed through
+       * its compression pointers and must fit a dname_t, as decoding it would; shallow
+       * (message_view_t, which decodes names only on access) it is only skipped.
+       */
+      inline decode_status_t check_name(const uint8_t* msg, std::size_t size, std::size_t& offset, bool deep)
+      {
+         std::size_t start = offset;
+
+         if(!deep)
+            return decode_status_t{to_decode_errc(skip_name(msg, size, offset)), start};
+
+         auto&& r = scan_wire_name(msg + offset, size - offset);
+
+         switch(r.status)
+         {
+            case name_status_t::ok:
+               break;
+
+            case name_status_t::truncated:
+            case name_status_t::empty_label:
+               return decode_status_t{decode_errc_t::name_truncated, start};
+
+            case name_status_t::label_too_long:
+               return decode_status_t{decode_errc_t::label_too_long, start};
+
+            case name_status_t::name_too_long:
+               return decode_status_t{decode_errc_t::name_too_long, start};
+         }
+
+         offset += r.size;
+
+         if(!r.compressed)
+            return decode_status_t{};
+
+         // the stored labels are fine - the ones a pointer leads to must still fit with them
+
+         std::size_t wire_size = r.wire_size;
+         std::size_t ptr_offset = ((msg[offset - 2] & ~0xC0) << 8) | msg[offset - 1];
+
+         auto&& w = walk_name(msg, offset - 2, ptr_offset, [&wire_size](const uint8_t*, uint8_t sz)
+         {
+            wire_size += 1 + sz;
+         });
+
+         if(w != walk_result_t::ok)
+            return decode_status_t{decode_errc_t::bad_pointer, start};
+
+         if(wire_size > dname_t::max_size)
+            return decode_status_t{decode_errc_t::name_too_long, start};
+
+         return decode_status_t{};
+      }
+
+      inline decode_status_t check_fixed(std::size_t size, std::size_t& offset, std::size_t n)
+      {
+         if(size - offset < n)
+            return decode_status_t{decode_errc_t::truncated, offset};
+
+         offset += n;
+
+         return decode_status_t{};
+      }
+
+      /*
+       * Walks the fields of one record's rdata in [offset, end) - each step a no-op once
+       * one has failed - for the check_rdata overloads below.
+       */
+      class rdata_checker_t
+      {
+         public:
+            rdata_checker_t(const uint8_t* msg, std::size_t offset, std::size_t end)
+               : m_msg(msg)
+               , m_offset(offset)
+               , m_end(end)
+            {
+            }
+
+            rdata_checker_t& name()
+            {
+               if(!m_status)
+                  m_status = check_name(m_msg, m_end, m_offset, true);
+
+               return *this;
+            }
+
+            rdata_checker_t& fixed(std::size_t n)
+            {
+               if(!m_status)
+                  m_status = check_fixed(m_end, m_offset, n);
+
+               return *this;
+            }
+
+            rdata_checker_t& character_strings()
+            {
+               if(!m_status && !character_strings_t::valid(m_msg + m_offset, m_end - m_offset))
+                  m_status = decode_status_t{decode_errc_t::truncated, m_offset};
+
+               m_offset = m_end;
+
+               return *this;
+            }
+
+            // the rdata must have been used up
+            decode_status_t done() const
+            {
+               if(!m_status && m_offset != m_end)
+                  return decode_status_t{decode_errc_t::bad_rdata, m_offset};
+
+               return m_status;
+            }
+
+         private:
+            const uint8_t* m_msg;
+            std::size_t m_offset;
+            std::size_t m_end;
+            decode_status_t m_status;
+      };
+
+      // what each LoadImpl<rec_*_t> reads
+
+      inline decode_status_t check_rdata(const rec_a_t*, rdata_checker_t c)
+      {
+         return c.fixed(4).done();
+      }
+
+      inline decode_status_t check_rdata(const rec_ns_t*, rdata_checker_t c)
+      {
+         return c.name().done();
+      }
+
+      inline decode_status_t check_rdata(const rec_cname_t*, rdata_checker_t c)
+      {
+         return c.name().done();
+      }
+
+      inline decode_status_t check_rdata(const rec_ptr_t*, rdata_checker_t c)
+      {
+         return c.name().done();
+      }
+
+      inline decode_status_t check_rdata(const rec_mx_t*, rdata_checker_t c)
+      {
+         return c.fixed(2).name().done();
+      }
+
+      inline decode_status_t check_rdata(const rec_soa_t*, rdata_checker_t c)
+      {
+         return c.name().name().fixed(20).done();
+      }
+
+      inline decode_status_t check_rdata(const rec_txt_t*, rdata_checker_t c)
+      {
+         return c.character_strings().done();
+      }
+
+      inline decode_status_t check_rdata(rr_type_t type, const uint8_t* msg, std::size_t offset, std::size_t end)
+      {
+         decode_status_t status;
+
+         TYPE_MAP_SWITCH_DISPATCH(
+            type,
+
+            [&status, msg, offset, end](auto rt)
+         {
+            status = check_rdata(rt, rdata_checker_t{msg, offset, end});
+         },
+
+         [](auto)
+         {
+            // kept raw, anything goes
+         });
+
+         return status;
+      }
+
+      // the most the 16 bit offsets of names and of the decoders can address
+      constexpr std::size_t max_message_size = 65535;
+
+      /*
+       * Checks that [msg, msg + size) holds a header and the sections it announces, filling
+       * in where each section starts (and, last, where the message ends). Deep, it also
+       * checks everything that decoding into a message_t would, so that decoding a
+       * message that passed cannot fail. Buffers over max_message_size are refused whole.
+       */
+      inline decode_status_t check_sections(const uint8_t* msg, std::size_t size, std::size_t (&section_offset)[5], bool deep)
+      {
+         if(size > max_message_size)
+            return decode_status_t{decode_errc_t::too_long, max_message_size};
+
+         if(size < header_size)
+            return decode_status_t{decode_errc_t::truncated, 0};
+
+         auto&& h = load_header(msg);
+
+         std::size_t offset = header_size;
+
+         section_offset[0] = offset;
+
+         for(uint16_t i = 0; i < h.QdCount(); ++i)
+         {
+            if(auto&& s = check_name(msg, size, offset, deep))
+               return s;
+
+            if(auto&& s = check_fixed(size, offset, 4))
+               return s;
+         }
+
+         const uint16_t counts[] = { h.AnCount(), h.NsCount(), h.ArCount() };
+
+         for(auto x = 0; x < 3; ++x)
+         {
+            section_offset[x + 1] = offset;
+
+            for(uint16_t i = 0; i < counts[x]; ++i)
+            {
+               if(auto&& s = check_name(msg, size, offset, deep))
+                  return s;
+
+               if(auto&& s = check_fixed(size, offset, 10))
+                  return s;
+
+               auto&& type = static_cast<rr_type_t>(load_be16(msg + offset - 10));
+               std::size_t rdata = offset;
+
+               if(auto&& s = check_fixed(size, offset, load_be16(msg + offset - 2)))
+                  return s;
+
+               if(deep)
+               {
+                  if(auto&& s = check_rdata(type, msg, rdata, offset))
+                     return s;
+               }
+            }
+         }
+
+         section_offset[4] = offset;
+
+         return decode_status_t{};
+      }
+   }
+}
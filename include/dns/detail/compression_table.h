@@ -0,0 +1,97 @@
+#pragma once
+
+#include <experimental/optional>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "dns/detail/name_kernel.h"
+
+namespace dns
+{
+   namespace detail
+   {
+      /*
+       * Offsets of the name suffixes written so far, keyed by a hash of their wire form.
+       *
+       * A flat open-addressing table, cleared in O(1) by bumping a generation, so a single
+       * instance per thread serves every message encoded on it. Hash hits are confirmed by
+       * the caller against the bytes actually written, so stale or colliding entries can
+       * never produce a wrong pointer. Once the table fills up, later names are just not
+       * offered for compression.
+       */
+      class compression_table_t
+      {
+         public:
+            static constexpr std::size_t capacity = 1024;
+
+            static compression_table_t& local()
+            {
+               thread_local compression_table_t table;
+               return table;
+            }
+
+            void clear()
+            {
+               m_size = 0;
+
+               if(++m_generation == 0)
+               {
+                  m_slots.fill(slot_t{});
+                  m_generation = 1;
+               }
+            }
+
+            template<class Matches>
+            std::experimental::optional<uint16_t> find(uint32_t hash, Matches&& matches) const
+            {
+               for(auto i = hash & mask; m_slots[i].generation == m_generation; i = (i + 1) & mask)
+               {
+                  if(m_slots[i].hash == hash && matches(m_slots[i].offset))
+                     return std::experimental::optional<uint16_t> {m_slots[i].offset};
+               }
+
+               return std::experimental::optional<uint16_t> {};
+            }
+
+            void insert(uint32_t hash, uint16_t offset)
+            {
+               if(m_size >= capacity / 4 * 3)
+                  return;
+
+               auto&& i = hash & mask;
+
+               while(m_slots[i].generation == m_generation)
+                  i = (i + 1) & mask;
+
+               m_slots[i] = slot_t{hash, offset, m_generation};
+
+               ++m_size;
+            }
+
+            /*
+             * Hash of a suffix, given the label in front of it and the hash of the rest.
+             */
+            static uint32_t hash_label(const uint8_t* label, std::size_t sz, uint32_t rest_hash)
+            {
+               return static_cast<uint32_t>(name_hash(label, sz, rest_hash));
+            }
+
+            static constexpr uint32_t root_hash = 2166136261u;
+
+         private:
+            static constexpr uint32_t mask = capacity - 1;
+
+            struct slot_t
+            {
+               uint32_t hash = 0;
+               uint16_t offset = 0;
+               uint16_t generation = 0;
+            };
+
+            std::array<slot_t, capacity> m_slots{};
+            uint16_t m_generation = 1;
+            uint16_t m_size = 0;
+      };
+   }
+}
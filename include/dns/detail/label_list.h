@@ -18,7 +18,7 @@ namespace dns
             m_name = std::move(name);
          }
 
-         std::string Name() const
+         const std::string& Name() const
          {
             return m_name;
          }
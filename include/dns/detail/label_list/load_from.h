@@ -2,96 +2,133 @@
 
 #include <ostream>
 #include <string>
+#include <string_view>
 
 #include "dns/detail/name_offset_tracker.h"
 #include "dns/detail/bin_serialize.h"
 #include "dns/detail/label_list.h"
 #include "dns/detail/label_list/save_to.h"
-#include "dns/detail/label_list/load_from.h"
+#include "dns/detail/label_list/walk.h"
+#include "dns/detail/name_kernel.h"
 #include "dns/exception/bad_data_stream.h"
 
 #include "util/name_builder.h"
 
 namespace dns
 {
-   template<>
-   struct LoadImpl<label_list_t>
+   namespace detail
    {
-      template<class InputIterator>
-      static label_list_t impl(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
+      /*
+       * Reads a (possibly compressed) name, calling on_label(data, size) for every label.
+       * Labels always point into the bytes already read into 'tr'. Names taking more than
+       * 255 bytes in full are refused.
+       */
+      template<class InputIterator, class F>
+      void load_name(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end, F&& on_label)
       {
-         auto&& term_found = false;
-         auto&& rem_labelchars = uint8_t{0};
-         auto&& ptr_offset = std::experimental::optional<uint16_t> {};
-         auto&& nb = util::name_builder{'.'};
+         std::size_t wire_size = 1;
 
-         while(ii != end && !term_found)
+         auto&& label = [&wire_size, &on_label](const uint8_t* data, uint8_t sz)
          {
-            if(ptr_offset)
-            {
-               // CASE I: read and accumulate the second byte into ptr_offset LSB
+            wire_size += 1 + sz;
 
-               uint8_t of = load_from<uint8_t>(tr, ii, end);
+            if(wire_size > max_name_size)
+               throw dns::exception::bad_data_stream("length too long", 2);
 
-               *ptr_offset |= static_cast<uint16_t>(of);
+            on_label(data, sz);
+         };
 
-               if( auto&& temp_tr = tr.slice(*ptr_offset, tr.current_offset() - 2u) )
-               {
-                  try
-                  {
-                     auto&& temp_bi = temp_tr->cbegin();
-                     auto&& temp_end = temp_tr->cend();
-                     auto&& temp_n = load_from<label_list_t>( *temp_tr, temp_bi, temp_end ).Name();
+         // the rest of the name was seen before - walk it in place, without recursion or copies
+         auto&& follow = [&tr, &label](std::size_t ptr_offset)
+         {
+            auto&& r = walk_name(tr.data(), tr.current_offset() - 2u, ptr_offset, label);
 
-                     nb.add_part(temp_n);
+            if(r != walk_result_t::ok)
+               throw dns::exception::bad_data_stream("bad offset", 1);
+         };
 
-                     term_found = true;
-                  }
-                  catch(const std::exception& e)
-                  {
-                     // FIXME - nest exception
-                  }
-               }
+         if constexpr(is_contiguous_byte_iterator<InputIterator>::value)
+         {
+            // the labels stored in place are checked in one pass over their length bytes, then taken whole
+            auto&& r = scan_wire_name(byte_pointer(ii), end - ii);
 
-               if(!term_found)
-                  throw dns::exception::bad_data_stream("bad offset", 1);
-            }
-            else if(rem_labelchars == 0)
+            if(r.status == name_status_t::truncated)
+               throw dns::exception::bad_data_stream("truncated", 2);
+            else if(r.status != name_status_t::ok)
+               throw dns::exception::bad_data_stream("length too long", 2);
+
+            uint16_t run_offset = tr.current_offset();
+
+            tr.save(byte_pointer(ii), r.size);
+            ii += r.size;
+
+            auto&& run = tr.data() + run_offset;
+
+            for(std::size_t pos = 0; pos + (r.compressed ? 2 : 1) < r.size; pos += 1 + run[pos])
+               on_label(run + pos + 1, run[pos]);
+
+            wire_size = r.wire_size;
+
+            if(r.compressed)
+               follow(((run[r.size - 2] & ~0xC0) << 8) | run[r.size - 1]);
+         }
+         else
+         {
+            while(true)
             {
-               // CASE II: expected is a number that is the size of label, or null, or ptr_offset byte
+               if(ii == end)
+                  throw dns::exception::bad_data_stream("truncated", 2);
 
                uint8_t sz = load_from<uint8_t>(tr, ii, end);
 
                if(sz == 0)
                {
-                  term_found = true;
+                  break;
+               }
+               else if((sz & 0xC0) == 0xC0)
+               {
+                  if(ii == end)
+                     throw dns::exception::bad_data_stream("truncated", 2);
+
+                  follow(((sz & ~0xC0) << 8) | load_from<uint8_t>(tr, ii, end));
+
+                  break;
                }
                else if(sz > 63)
                {
-                  if((sz & 0xC0) == 0xC0)
-                     ptr_offset = static_cast<uint16_t>((sz & ~0xC0) << 8); // accumulate the first byte into ptr_offset MSB
-                  else
-                     throw dns::exception::bad_data_stream("length too long", 2);
+                  throw dns::exception::bad_data_stream("length too long", 2);
                }
                else
                {
-                  nb.add_part("");
+                  uint16_t label_offset = tr.current_offset();
 
-                  rem_labelchars = sz;
-               }
-            }
-            else
-            {
-               // CASE III: expected is a set of characters of a namepart (rem_labelchars chars long)
+                  for(auto i = sz; i > 0; --i)
+                  {
+                     if(ii == end)
+                        throw dns::exception::bad_data_stream("truncated", 2);
 
-               nb.append( load_from<uint8_t>(tr, ii, end) );
+                     load_from<uint8_t>(tr, ii, end);
+                  }
 
-               --rem_labelchars;
+                  label(tr.data() + label_offset, sz);
+               }
             }
          }
+      }
+   }
+
+   template<>
+   struct LoadImpl<label_list_t>
+   {
+      template<class InputIterator>
+      static label_list_t impl(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
+      {
+         auto&& nb = util::name_builder{'.'};
 
-         if(!term_found)
-            throw dns::exception::bad_data_stream("truncated", 2);
+         detail::load_name(tr, ii, end, [&nb](const uint8_t* label, uint8_t sz)
+         {
+            nb.add_part(std::string_view{reinterpret_cast<const char*>(label), sz});
+         });
 
          return label_list_t{ std::move(nb).full_name() };
       }
@@ -1,48 +1,134 @@
 #pragma once
 
+#include <algorithm>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include "dns/detail/label_list.h"
 #include "dns/detail/name_offset_tracker.h"
 #include "dns/detail/bin_serialize.h"
+#include "dns/detail/compression_table.h"
+#include "dns/detail/label_list/walk.h"
 #include "dns/exception/bad_ptr_offset.h"
 #include "dns/exception/bad_name.h"
-#include "util/split2_at.h"
 
 namespace dns
 {
-   inline void save_to(name_offset_tracker_t& tr, const label_list_t& ll)
+   namespace detail
    {
-      auto&& range = ll.Name();
+      /* the limits of a name on the wire (RFC 1035 3.1) - dname_t keeps to the same */
+      constexpr std::size_t max_name_size = 255;
+      constexpr std::size_t max_labels = 127;
 
-      while(!range.empty() && range.back() == '.')
-         range.pop_back();
+      struct label_ref_t
+      {
+         const uint8_t* data;
+         std::size_t size;
+         uint32_t suffix_hash;
+      };
 
-      while(true)
+      /*
+       * written_name_equals() for a tracker that only counts, walking the labels it noted.
+       */
+      inline bool counted_name_equals(const std::vector<counted_label_t>& written, uint16_t offset, const label_ref_t* b, const label_ref_t* e)
       {
-         if(range.empty())
+         auto&& at = [&written](uint16_t o) -> const counted_label_t*
+         {
+            auto&& it = std::lower_bound(written.begin(), written.end(), o, [](const counted_label_t& l, uint16_t x)
+            {
+               return l.offset < x;
+            });
+
+            return it != written.end() && it->offset == o ? &*it : nullptr;
+         };
+
+         // the labels of a name were noted one after the other, ending in its end
+         const counted_label_t* l = at(offset);
+
+         while(l)
          {
-            save_to(tr, static_cast<uint8_t>(0));
-            break;
+            if(!l->data)
+            {
+               if(l->target == 0)
+                  return b == e;
+
+               l = at(l->target); // strictly backwards, so this ends
+            }
+            else if(b == e || b->size != l->size || !std::equal(l->data, l->data + l->size, b->data))
+            {
+               return false;
+            }
+            else
+            {
+               ++b;
+               ++l;
+            }
          }
 
-         if(auto && p_offset = tr.find_offset(range))
+         return false;
+      }
+
+      /*
+       * Does the name already written at 'offset' spell out exactly the labels [b, e)?
+       */
+      inline bool written_name_equals(const name_offset_tracker_t& tr, uint16_t offset, const label_ref_t* b, const label_ref_t* e)
+      {
+         if(offset >= tr.current_offset())
+            return false;
+
+         if(tr.counting())
+            return counted_name_equals(tr.counted_labels(), offset, b, e);
+
+         auto&& equal = true;
+         std::size_t pos = offset;
+
+         auto&& r = walk_name(tr.data(), tr.current_offset(), pos, [&equal, &b, e](const uint8_t* label, uint8_t sz)
+         {
+            equal = equal && b != e && b->size == sz && std::equal(label, label + sz, b->data);
+            ++b;
+         });
+
+         return r == walk_result_t::ok && equal && b == e;
+      }
+   }
+
+   namespace detail
+   {
+      /*
+       * Writes the labels, ending in a pointer to the longest suffix already in the message.
+       */
+      inline void save_labels(name_offset_tracker_t& tr, label_ref_t* labels, std::size_t count)
+      {
+         for(auto i = count; i > 0; --i)
          {
-            if(*p_offset > 0x3FFF)
-               throw exception::bad_ptr_offset("offset too long", 1);
+            uint32_t rest_hash = i < count ? labels[i].suffix_hash : compression_table_t::root_hash;
 
-            save_to(tr, static_cast<uint8_t>((*p_offset >> 8) | 0xC0));
-            save_to(tr, static_cast<uint8_t>(*p_offset & 0xFF));
-            break;
+            labels[i - 1].suffix_hash = compression_table_t::hash_label(labels[i - 1].data, labels[i - 1].size, rest_hash);
          }
 
+         for(std::size_t i = 0; i < count; ++i)
          {
-            tr.save_offset_of(range);
+            auto&& p_offset = tr.find_offset(labels[i].suffix_hash, [&tr, labels, i, count](uint16_t offset)
+            {
+               return written_name_equals(tr, offset, labels + i, labels + count);
+            });
+
+            if(p_offset)
+            {
+               if(*p_offset > 0x3FFF)
+                  throw exception::bad_ptr_offset("offset too long", 1);
 
-            auto&& split_parts = util::split2_at(range, '.');
+               tr.note_end(*p_offset);
 
-            auto&& sz = split_parts.first.size();
+               save_to(tr, static_cast<uint8_t>((*p_offset >> 8) | 0xC0));
+               save_to(tr, static_cast<uint8_t>(*p_offset & 0xFF));
+               return;
+            }
+
+            tr.save_offset_of(labels[i].suffix_hash);
+
+            auto&& sz = labels[i].size;
 
             if(sz > 63)
                throw exception::bad_name("length too long", 1);
@@ -50,15 +136,47 @@ namespace dns
             if(sz == 0)
                throw exception::bad_name("wrong format", 1);
 
+            tr.note_label(labels[i].data, static_cast<uint8_t>(sz));
+
             save_to(tr, static_cast<uint8_t>(sz));
+            tr.save(labels[i].data, sz);
+         }
 
-            for(auto x : split_parts.first)
-            {
-               save_to(tr, static_cast<uint8_t>(x));
-            }
+         tr.note_end(0);
 
-            range = std::move(split_parts.second);
-         }
+         save_to(tr, static_cast<uint8_t>(0));
       }
    }
+
+   inline void save_to(name_offset_tracker_t& tr, const label_list_t& ll)
+   {
+      auto&& range = ll.Name();
+
+      auto&& n = range.size();
+
+      while(n > 0 && range[n - 1] == '.')
+         --n;
+
+      detail::label_ref_t labels[detail::max_labels];
+      std::size_t count = 0;
+      std::size_t wire_size = 1;
+
+      for(std::size_t b = 0; b < n; ++count)
+      {
+         if(count == detail::max_labels)
+            throw exception::bad_name("length too long", 2);
+
+         std::size_t e = std::min(range.find('.', b), n);
+
+         labels[count] = detail::label_ref_t{ reinterpret_cast<const uint8_t*>(range.data()) + b, e - b, 0 };
+         wire_size += 1 + (e - b);
+
+         b = e + 1;
+      }
+
+      if(wire_size > detail::max_name_size)
+         throw exception::bad_name("length too long", 2);
+
+      detail::save_labels(tr, labels, count);
+   }
 }
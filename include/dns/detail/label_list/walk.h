@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "dns/exception/bad_data_stream.h"
+
+namespace dns
+{
+   namespace detail
+   {
+      enum class walk_result_t
+      {
+         ok,
+         truncated,
+         length_too_long,
+         bad_offset,
+      };
+
+      inline void throw_if_failed(walk_result_t r)
+      {
+         switch(r)
+         {
+            case walk_result_t::ok:
+               return;
+            case walk_result_t::truncated:
+               throw dns::exception::bad_data_stream("truncated", 2);
+            case walk_result_t::length_too_long:
+               throw dns::exception::bad_data_stream("length too long", 2);
+            case walk_result_t::bad_offset:
+               throw dns::exception::bad_data_stream("bad offset", 1);
+         }
+      }
+
+      // upper bound on compression pointers followed while decoding a single name
+      constexpr unsigned max_name_hops = 127;
+
+      /*
+       * Steps 'offset' past the name stored there, without following compression pointers.
+       */
+      inline walk_result_t skip_name(const uint8_t* msg, std::size_t size, std::size_t& offset)
+      {
+         std::size_t pos = offset;
+
+         while(pos < size)
+         {
+            uint8_t sz = msg[pos];
+
+            if(sz == 0)
+            {
+               offset = pos + 1;
+               return walk_result_t::ok;
+            }
+            else if((sz & 0xC0) == 0xC0)
+            {
+               if(pos + 2 > size)
+                  return walk_result_t::truncated;
+
+               offset = pos + 2;
+               return walk_result_t::ok;
+            }
+            else if(sz > 63)
+            {
+               return walk_result_t::length_too_long;
+            }
+
+            pos += 1 + sz;
+         }
+
+         return walk_result_t::truncated;
+      }
+
+      /*
+       * Walks the name stored at 'offset', following compression pointers, and calls
+       * on_label(const uint8_t* label, uint8_t length) for every label in order.
+       *
+       * A pointer must refer strictly backwards of itself, and once followed the labels
+       * must end before the pointer that led there - so every hop shrinks the window and
+       * the walk terminates. On success 'offset' is stepped past the name as stored.
+       */
+      template<class F>
+      walk_result_t walk_name(const uint8_t* msg, std::size_t size, std::size_t& offset, F&& on_label)
+      {
+         std::size_t pos = offset;
+         std::size_t limit = size;
+         unsigned hops = 0;
+
+         while(pos < limit)
+         {
+            uint8_t sz = msg[pos];
+
+            if(sz == 0)
+            {
+               if(hops == 0)
+                  offset = pos + 1;
+
+               return walk_result_t::ok;
+            }
+            else if((sz & 0xC0) == 0xC0)
+            {
+               if(pos + 2 > limit)
+                  break;
+
+               auto&& ptr_offset = static_cast<std::size_t>(((sz & ~0xC0) << 8) | msg[pos + 1]);
+
+               if(hops == 0)
+                  offset = pos + 2;
+
+               if(ptr_offset >= pos || ++hops > max_name_hops)
+                  return walk_result_t::bad_offset;
+
+               limit = pos;
+               pos = ptr_offset;
+            }
+            else if(sz > 63)
+            {
+               return hops == 0 ? walk_result_t::length_too_long : walk_result_t::bad_offset;
+            }
+            else
+            {
+               if(pos + 1 + sz > limit)
+                  break;
+
+               on_label(msg + pos + 1, sz);
+
+               pos += 1 + sz;
+            }
+         }
+
+         return hops == 0 ? walk_result_t::truncated : walk_result_t::bad_offset;
+      }
+   }
+}
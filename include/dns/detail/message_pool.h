@@ -0,0 +1,126 @@
+#pragma once
+
+#include "dns/message.h"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace dns
+{
+   namespace detail
+   {
+      /*
+       * A free list of message_t objects to decode responses into, each allocating from a
+       * pool resource of its own. A message given back is clear()ed: its sections keep
+       * their capacity and the rdata buffers go back to its pool, so once every message
+       * has seen a response of the size at hand decoding another allocates nothing.
+       *
+       * Up to 'max_free' messages are kept; more are only made while that many are in use
+       * at once (a callback resolving synchronously from within another), and destroyed
+       * when given back.
+       */
+      class message_pool_t
+      {
+         private:
+            struct entry_t
+            {
+               entry_t()
+                  : m_resource(pool_options())
+                  , m_message(&m_resource)
+               {
+               }
+
+               static std::pmr::pool_options pool_options()
+               {
+                  std::pmr::pool_options o;
+
+                  o.largest_required_pool_block = 0x10000; // any rdata
+
+                  return o;
+               }
+
+               std::pmr::unsynchronized_pool_resource m_resource;
+               message_t m_message;
+            };
+
+         public:
+            static constexpr std::size_t max_free = 4;
+
+            // a message_t on loan, given back to the pool when the lease goes
+            class lease_t
+            {
+               public:
+                  lease_t(lease_t&&) = default;
+                  lease_t& operator=(lease_t&&) = delete;
+
+                  ~lease_t()
+                  {
+                     if(m_entry)
+                        m_pool->release(std::move(m_entry));
+                  }
+
+                  message_t& operator*() const
+                  {
+                     return m_entry->m_message;
+                  }
+
+                  message_t* operator->() const
+                  {
+                     return &m_entry->m_message;
+                  }
+
+               private:
+                  friend class message_pool_t;
+
+                  lease_t(message_pool_t& pool, std::unique_ptr<entry_t> entry)
+                     : m_pool(&pool)
+                     , m_entry(std::move(entry))
+                  {
+                  }
+
+                  message_pool_t* m_pool;
+                  std::unique_ptr<entry_t> m_entry;
+            };
+
+            message_pool_t()
+            {
+               m_free.reserve(max_free);
+            }
+
+            message_pool_t(const message_pool_t&) = delete;
+            message_pool_t& operator=(const message_pool_t&) = delete;
+
+            // an empty message, recycled if there is one to spare
+            lease_t acquire()
+            {
+               if(m_free.empty())
+                  return lease_t{*this, std::make_unique<entry_t>()};
+
+               std::unique_ptr<entry_t> entry = std::move(m_free.back());
+               m_free.pop_back();
+
+               return lease_t{*this, std::move(entry)};
+            }
+
+            std::size_t free_count() const
+            {
+               return m_free.size();
+            }
+
+         private:
+            void release(std::unique_ptr<entry_t> entry)
+            {
+               if(m_free.size() == max_free)
+                  return;
+
+               entry->m_message.clear();
+
+               m_free.push_back(std::move(entry));
+            }
+
+            std::vector<std::unique_ptr<entry_t>> m_free;
+      };
+   }
+}
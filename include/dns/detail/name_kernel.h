@@ -0,0 +1,495 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define DNS_NAME_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace dns
+{
+   namespace detail
+   {
+      enum class name_status_t : uint8_t
+      {
+         ok,
+         empty_label,
+         label_too_long,
+         name_too_long,
+         truncated,
+      };
+
+      struct name_scan_t
+      {
+         name_status_t status = name_status_t::ok;
+         uint8_t wire_size = 1;     // including the root label
+         uint8_t label_count = 0;
+      };
+
+      struct wire_scan_t
+      {
+         name_status_t status = name_status_t::ok;
+         std::size_t size = 0;         // bytes stored in place, the closing root label or pointer included
+         std::size_t wire_size = 1;    // of the labels stored in place, plus the root label
+         std::size_t label_count = 0;
+         bool compressed = false;      // closed by a pointer, the last two of 'size' bytes
+      };
+
+      /*
+       * Byte level work on names: ASCII lowercasing, case-insensitive hashing and comparison,
+       * and splitting dotted text into wire form. Each has a scalar (word at a time) version
+       * plus SSE2 and AVX2 ones, which must give bit for bit the same results; the widest
+       * one the CPU supports is picked at run time, the narrower ones handle the tail.
+       */
+      namespace name_kernel
+      {
+         constexpr uint64_t ones = 0x0101010101010101ull;
+         constexpr uint64_t hash_mul = 0x9E3779B97F4A7C15ull;
+
+         // one bit per byte position of a name
+         struct position_map_t
+         {
+            uint64_t w[4] = {};
+
+            void set(std::size_t i)
+            {
+               w[i >> 6] |= uint64_t{1} << (i & 63);
+            }
+
+            // 'i' is a multiple of the block size, so the block never straddles two words
+            void set_block(std::size_t i, uint32_t bits)
+            {
+               w[i >> 6] |= uint64_t{bits} << (i & 63);
+            }
+         };
+
+         inline uint64_t load_word(const uint8_t* p)
+         {
+            uint64_t w;
+            std::memcpy(&w, p, sizeof(w));
+            return w;
+         }
+
+         inline uint64_t load_tail(const uint8_t* p, std::size_t n)
+         {
+            uint64_t w = 0;
+            std::memcpy(&w, p, n);
+            return w;
+         }
+
+         inline uint64_t lower_word(uint64_t w)
+         {
+            auto&& low7 = w & (ones * 0x7F);
+            auto&& ge_a = low7 + ones * (0x80 - 'A');
+            auto&& gt_z = low7 + ones * (0x80 - 'Z' - 1);
+            auto&& upper = ge_a & ~gt_z & ~w & (ones * 0x80);
+
+            return w | (upper >> 2);
+         }
+
+         inline uint64_t mix(uint64_t h, uint64_t w)
+         {
+            h ^= w;
+            h = (h << 23) | (h >> 41);
+            return h * hash_mul;
+         }
+
+         inline uint64_t finish(uint64_t h)
+         {
+            h ^= h >> 32;
+            h *= hash_mul;
+            return h ^ (h >> 29);
+         }
+
+         inline uint8_t lower_char(uint8_t c)
+         {
+            return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+         }
+
+         /////////////////////////////////////////////////////
+
+         namespace scalar
+         {
+            inline uint64_t hash_from(uint64_t h, const uint8_t* p, std::size_t i, std::size_t n)
+            {
+               for(; i + 8 <= n; i += 8)
+                  h = mix(h, lower_word(load_word(p + i)));
+
+               if(i < n)
+                  h = mix(h, lower_word(load_tail(p + i, n - i)));
+
+               return finish(h);
+            }
+
+            inline uint64_t hash(const uint8_t* p, std::size_t n, uint64_t seed)
+            {
+               return hash_from(seed ^ (n * hash_mul), p, 0, n);
+            }
+
+            inline bool equal_nocase_from(const uint8_t* a, const uint8_t* b, std::size_t i, std::size_t n)
+            {
+               for(; i + 8 <= n; i += 8)
+               {
+                  if(lower_word(load_word(a + i)) != lower_word(load_word(b + i)))
+                     return false;
+               }
+
+               return i == n || lower_word(load_tail(a + i, n - i)) == lower_word(load_tail(b + i, n - i));
+            }
+
+            inline bool equal_nocase(const uint8_t* a, const uint8_t* b, std::size_t n)
+            {
+               return equal_nocase_from(a, b, 0, n);
+            }
+
+            inline void lowercase_from(const uint8_t* in, std::size_t i, std::size_t n, uint8_t* out)
+            {
+               for(; i + 8 <= n; i += 8)
+               {
+                  auto&& w = lower_word(load_word(in + i));
+                  std::memcpy(out + i, &w, sizeof(w));
+               }
+
+               for(; i < n; ++i)
+                  out[i] = lower_char(in[i]);
+            }
+
+            inline void lowercase(const uint8_t* in, std::size_t n, uint8_t* out)
+            {
+               lowercase_from(in, 0, n, out);
+            }
+
+            // text byte i goes to out[i + 1], leaving out[0] for the first label length
+            inline void scan_text_from(const uint8_t* in, std::size_t i, std::size_t n, uint8_t* out, position_map_t& dots)
+            {
+               for(; i < n; ++i)
+               {
+                  out[i + 1] = in[i];
+
+                  if(in[i] == '.')
+                     dots.set(i);
+               }
+            }
+
+            inline void scan_text(const uint8_t* in, std::size_t n, uint8_t* out, position_map_t& dots)
+            {
+               scan_text_from(in, 0, n, out, dots);
+            }
+         }
+
+         /////////////////////////////////////////////////////
+
+#if defined(DNS_NAME_KERNEL_X86)
+         namespace sse2
+         {
+            inline __m128i lower(__m128i x)
+            {
+               auto&& upper = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(x, _mm_set1_epi8('Z' + 1)));
+
+               return _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+            }
+
+            inline uint64_t hash_from(uint64_t h, const uint8_t* p, std::size_t i, std::size_t n)
+            {
+               for(; i + 16 <= n; i += 16)
+               {
+                  auto&& x = lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+
+                  h = mix(h, static_cast<uint64_t>(_mm_cvtsi128_si64(x)));
+                  h = mix(h, static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(x, x))));
+               }
+
+               return scalar::hash_from(h, p, i, n);
+            }
+
+            inline uint64_t hash(const uint8_t* p, std::size_t n, uint64_t seed)
+            {
+               return hash_from(seed ^ (n * hash_mul), p, 0, n);
+            }
+
+            inline bool equal_nocase_from(const uint8_t* a, const uint8_t* b, std::size_t i, std::size_t n)
+            {
+               for(; i + 16 <= n; i += 16)
+               {
+                  auto&& x = lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+                  auto&& y = lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+
+                  if(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF)
+                     return false;
+               }
+
+               return scalar::equal_nocase_from(a, b, i, n);
+            }
+
+            inline bool equal_nocase(const uint8_t* a, const uint8_t* b, std::size_t n)
+            {
+               return equal_nocase_from(a, b, 0, n);
+            }
+
+            inline void lowercase_from(const uint8_t* in, std::size_t i, std::size_t n, uint8_t* out)
+            {
+               for(; i + 16 <= n; i += 16)
+                  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+
+               scalar::lowercase_from(in, i, n, out);
+            }
+
+            inline void lowercase(const uint8_t* in, std::size_t n, uint8_t* out)
+            {
+               lowercase_from(in, 0, n, out);
+            }
+
+            inline void scan_text_from(const uint8_t* in, std::size_t i, std::size_t n, uint8_t* out, position_map_t& dots)
+            {
+               for(; i + 16 <= n; i += 16)
+               {
+                  auto&& x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+                  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 1), x);
+
+                  dots.set_block(i, static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('.')))));
+               }
+
+               scalar::scan_text_from(in, i, n, out, dots);
+            }
+
+            inline void scan_text(const uint8_t* in, std::size_t n, uint8_t* out, position_map_t& dots)
+            {
+               scan_text_from(in, 0, n, out, dots);
+            }
+         }
+#endif
+
+         /////////////////////////////////////////////////////
+
+#if defined(DNS_NAME_KERNEL_X86)
+         namespace avx2
+         {
+            __attribute__((target("avx2"))) inline __m256i lower(__m256i x)
+            {
+               auto&& upper = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), x));
+
+               return _mm256_or_si256(x, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+            }
+
+            __attribute__((target("avx2"))) inline uint64_t hash(const uint8_t* p, std::size_t n, uint64_t seed)
+            {
+               auto&& h = seed ^ (n * hash_mul);
+               std::size_t i = 0;
+
+               for(; i + 32 <= n; i += 32)
+               {
+                  auto&& x = lower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+
+                  h = mix(h, static_cast<uint64_t>(_mm256_extract_epi64(x, 0)));
+                  h = mix(h, static_cast<uint64_t>(_mm256_extract_epi64(x, 1)));
+                  h = mix(h, static_cast<uint64_t>(_mm256_extract_epi64(x, 2)));
+                  h = mix(h, static_cast<uint64_t>(_mm256_extract_epi64(x, 3)));
+               }
+
+               return sse2::hash_from(h, p, i, n);
+            }
+
+            __attribute__((target("avx2"))) inline bool equal_nocase(const uint8_t* a, const uint8_t* b, std::size_t n)
+            {
+               std::size_t i = 0;
+
+               for(; i + 32 <= n; i += 32)
+               {
+                  auto&& x = lower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+                  auto&& y = lower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+
+                  if(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y))) != 0xFFFFFFFFu)
+                     return false;
+               }
+
+               return sse2::equal_nocase_from(a, b, i, n);
+            }
+
+            __attribute__((target("avx2"))) inline void lowercase(const uint8_t* in, std::size_t n, uint8_t* out)
+            {
+               std::size_t i = 0;
+
+               for(; i + 32 <= n; i += 32)
+                  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), lower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i))));
+
+               sse2::lowercase_from(in, i, n, out);
+            }
+
+            __attribute__((target("avx2"))) inline void scan_text(const uint8_t* in, std::size_t n, uint8_t* out, position_map_t& dots)
+            {
+               std::size_t i = 0;
+
+               for(; i + 32 <= n; i += 32)
+               {
+                  auto&& x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+
+                  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 1), x);
+
+                  dots.set_block(i, static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('.')))));
+               }
+
+               sse2::scan_text_from(in, i, n, out, dots);
+            }
+         }
+
+         inline bool has_avx2()
+         {
+            static const bool avx2 = __builtin_cpu_supports("avx2");
+            return avx2;
+         }
+#else
+         inline bool has_avx2()
+         {
+            return false;
+         }
+#endif
+
+#if defined(DNS_NAME_KERNEL_X86)
+#define DNS_NAME_KERNEL_DISPATCH(fn, ...) (name_kernel::has_avx2() ? name_kernel::avx2::fn(__VA_ARGS__) : name_kernel::sse2::fn(__VA_ARGS__))
+#else
+#define DNS_NAME_KERNEL_DISPATCH(fn, ...) (name_kernel::scalar::fn(__VA_ARGS__))
+#endif
+      }
+
+      /*
+       * Case-insensitive hash of 'n' bytes, e.g. a name in wire form.
+       */
+      inline uint64_t name_hash(const uint8_t* p, std::size_t n, uint64_t seed = 0)
+      {
+         return DNS_NAME_KERNEL_DISPATCH(hash, p, n, seed);
+      }
+
+      inline bool equal_nocase(const uint8_t* a, const uint8_t* b, std::size_t n)
+      {
+         return DNS_NAME_KERNEL_DISPATCH(equal_nocase, a, b, n);
+      }
+
+      inline void lowercase(const uint8_t* in, std::size_t n, uint8_t* out)
+      {
+         DNS_NAME_KERNEL_DISPATCH(lowercase, in, n, out);
+      }
+
+      /*
+       * Dotted text to wire form in 'wire' (room for 255 bytes), case preserved, with the
+       * offset of every label's length byte in 'label_offsets' (room for 127, may be null).
+       * Trailing dots are ignored. On failure the contents of 'wire' are undefined.
+       */
+      inline name_scan_t scan_text_name(const char* text, std::size_t n, uint8_t* wire, uint8_t* label_offsets)
+      {
+         auto&& r = name_scan_t{};
+
+         while(n > 0 && text[n - 1] == '.')
+            --n;
+
+         if(n > 253)
+         {
+            r.status = name_status_t::name_too_long;
+            return r;
+         }
+
+         auto&& dots = name_kernel::position_map_t{};
+
+         if(n > 0)
+            DNS_NAME_KERNEL_DISPATCH(scan_text, reinterpret_cast<const uint8_t*>(text), n, wire, dots);
+
+         std::size_t start = 0;
+
+         auto&& close_label = [&r, &start, wire, label_offsets](std::size_t end)
+         {
+            auto&& sz = end - start;
+
+            if(sz == 0)
+               r.status = name_status_t::empty_label;
+            else if(sz > 63)
+               r.status = name_status_t::label_too_long;
+            else
+            {
+               wire[start] = static_cast<uint8_t>(sz);
+
+               if(label_offsets)
+                  label_offsets[r.label_count] = static_cast<uint8_t>(start);
+
+               ++r.label_count;
+               start = end + 1;
+            }
+
+            return r.status == name_status_t::ok;
+         };
+
+         for(std::size_t k = 0; k < 4; ++k)
+         {
+            for(uint64_t bits = dots.w[k]; bits != 0; bits &= bits - 1)
+            {
+               if(!close_label(k * 64 + __builtin_ctzll(bits)))
+                  return r;
+            }
+         }
+
+         if(n > 0 && !close_label(n))
+            return r;
+
+         wire[start] = 0;
+
+         r.wire_size = static_cast<uint8_t>(start + 1);
+
+         return r;
+      }
+
+      /*
+       * Checks the labels stored in place at the start of [p, p + n) - up to the root label
+       * or the compression pointer that closes them - without following the pointer. Only
+       * the length bytes are visited; the name stops counting as valid once its labels so
+       * far take more than 255 bytes.
+       */
+      inline wire_scan_t scan_wire_name(const uint8_t* p, std::size_t n)
+      {
+         auto&& r = wire_scan_t{};
+         std::size_t pos = 0;
+
+         while(pos < n)
+         {
+            uint8_t sz = p[pos];
+
+            if(sz == 0)
+            {
+               r.size = pos + 1;
+               return r;
+            }
+            else if((sz & 0xC0) == 0xC0)
+            {
+               if(pos + 2 > n)
+                  break;
+
+               r.size = pos + 2;
+               r.compressed = true;
+               return r;
+            }
+            else if(sz > 63)
+            {
+               r.status = name_status_t::label_too_long;
+               return r;
+            }
+
+            r.wire_size += 1 + sz;
+            ++r.label_count;
+
+            if(r.wire_size > 255)
+            {
+               r.status = name_status_t::name_too_long;
+               return r;
+            }
+
+            pos += 1 + sz;
+         }
+
+         r.status = name_status_t::truncated;
+         return r;
+      }
+   }
+}
+
+#undef DNS_NAME_KERNEL_DISPATCH
@@ -5,11 +5,30 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <algorithm>
-#include <map>
+
+#include "dns/detail/byte_order.h"
+#include "dns/detail/compression_table.h"
+#include "dns/exception/bad_buffer_size.h"
 
 namespace dns
 {
+   namespace detail
+   {
+      /*
+       * A label written by a name_offset_tracker_t::count_only() tracker - or, with no
+       * 'data', the end of the name: the root label if 'target' is 0, else a pointer to it.
+       */
+      struct counted_label_t
+      {
+         uint16_t offset;
+         const uint8_t* data;
+         uint8_t size;
+         uint16_t target;
+      };
+   }
+
    class name_offset_tracker_t
    {
       public:
@@ -18,8 +37,9 @@ namespace dns
             , m_end_offset(m_initial_offset)
             , m_current_offset(m_initial_offset)
             , m_store{ std::make_shared<std::vector<uint8_t>>(m_initial_offset) }
-            , m_name_offset_assoc{ std::make_shared<std::multimap<std::string, uint16_t>>() }
+            , m_name_offset_assoc{ &detail::compression_table_t::local() }
          {
+            m_name_offset_assoc->clear();
          }
 
          template<class Str>
@@ -28,40 +48,85 @@ namespace dns
             , m_end_offset(m_initial_offset)
             , m_current_offset(m_initial_offset)
             , m_store{ std::make_shared<std::vector<uint8_t>>(std::cbegin(str), std::cbegin(str) + m_initial_offset) }
-            , m_name_offset_assoc{ std::make_shared<std::multimap<std::string, uint16_t>>() }
+            , m_name_offset_assoc{ &detail::compression_table_t::local() }
          {
+            m_name_offset_assoc->clear();
          }
 
-         name_offset_tracker_t(name_offset_tracker_t&&) = default;
-         name_offset_tracker_t& operator=(name_offset_tracker_t&&) = default;
-         name_offset_tracker_t& operator=(const name_offset_tracker_t&) = delete;
+         template<class InputIterator>
+         name_offset_tracker_t(InputIterator begin, InputIterator end)
+            : m_initial_offset(static_cast<uint16_t>(std::distance(begin, end)))
+            , m_end_offset(m_initial_offset)
+            , m_current_offset(m_initial_offset)
+            , m_store{ std::make_shared<std::vector<uint8_t>>(begin, end) }
+            , m_name_offset_assoc{ &detail::compression_table_t::local() }
+         {
+            m_name_offset_assoc->clear();
+         }
 
-         template<class Str>
-         auto find_offset(Str&& str) const
+         /*
+          * Encodes straight into the tail of 'out' - message offset 0 is at out.size()
+          * at the time of the call, so any prefix (e.g. a TCP length field) is left alone.
+          */
+         static name_offset_tracker_t append_to(std::vector<uint8_t>& out)
          {
-            auto&& i = m_name_offset_assoc->find(std::forward<Str>(str));
+            return name_offset_tracker_t{out, out.size()};
+         }
 
-            if(i != m_name_offset_assoc->end())
-               return std::experimental::optional < decltype(i->second) > {i->second};
-            else
-               return std::experimental::optional < decltype(i->second) > {};
+         /*
+          * Encodes into the caller's fixed buffer [out, out + capacity) - a write that does
+          * not fit throws exception::bad_buffer_size, leaving the bytes past it untouched.
+          */
+         static name_offset_tracker_t write_to(uint8_t* out, std::size_t capacity)
+         {
+            return name_offset_tracker_t{out, std::min<std::size_t>(capacity, 0xFFFF)};
          }
 
-         auto slice(uint16_t ptr_offset, uint16_t end_offset) const
+         /*
+          * As write_to(), except that a write that does not fit is dropped rather than
+          * throwing, as is every write after it: overflowed() tells, and rewind() goes back
+          * to what did fit.
+          */
+         static name_offset_tracker_t write_within(uint8_t* out, std::size_t budget)
          {
-            if(ptr_offset < current_offset() && end_offset <= current_offset() && ptr_offset <= end_offset)
-            {
-               return std::experimental::optional<name_offset_tracker_t>
-               {
-                  name_offset_tracker_t{
-                     *this,
-                     ptr_offset,
-                     end_offset,
-                  }
-               };
-            }
+            name_offset_tracker_t tr = write_to(out, budget);
+
+            tr.m_drop_overflow = true;
+
+            return tr;
+         }
+
+         /*
+          * Decodes a message lying in one contiguous buffer, 'msg' being offset 0 and the
+          * reading starting at 'offset'. The bytes loaded are only counted, not copied, so
+          * the input iterators must walk that very buffer.
+          */
+         static name_offset_tracker_t read_in_place(const uint8_t* msg, std::size_t offset = 0)
+         {
+            return name_offset_tracker_t{in_place_t{}, msg, static_cast<uint16_t>(offset)};
+         }
+
+         /*
+          * Only counts the bytes written, storing none, to size a message. Names are still
+          * compressed as they would be: their labels are noted instead (see note_label()),
+          * pointing into the names given, which must outlive the tracker's use.
+          */
+         static name_offset_tracker_t count_only()
+         {
+            return name_offset_tracker_t{count_t{}};
+         }
+
+         name_offset_tracker_t(name_offset_tracker_t&&) = default;
+         name_offset_tracker_t& operator=(name_offset_tracker_t&&) = default;
+         name_offset_tracker_t& operator=(const name_offset_tracker_t&) = delete;
 
-            return std::experimental::optional<name_offset_tracker_t> {};
+         /*
+          * Offset of an earlier name suffix with the given hash, for which matches(offset) holds.
+          */
+         template<class Matches>
+         auto find_offset(uint32_t hash, Matches&& matches) const
+         {
+            return m_name_offset_assoc->find(hash, std::forward<Matches>(matches));
          }
 
          uint16_t current_offset() const
@@ -69,14 +134,23 @@ namespace dns
             return m_current_offset;
          }
 
-         auto cbegin() const
+         const uint8_t* cbegin() const
+         {
+            return data() + m_initial_offset;
+         }
+
+         const uint8_t* cend() const
          {
-            return m_store->cbegin() + m_initial_offset;
+            return data() + m_end_offset;
          }
 
-         auto cend() const
+         // the message written (or read) so far, from offset 0 up to current_offset()
+         const uint8_t* data() const
          {
-            return m_store->cbegin() + m_end_offset;
+            if(m_in_place)
+               return m_in_place;
+
+            return m_fixed ? m_fixed : m_store->data() + m_base;
          }
 
          std::vector<uint8_t> store() const
@@ -84,42 +158,223 @@ namespace dns
             return std::vector<uint8_t>(cbegin(), cend());
          }
 
+         void reserve(std::size_t n)
+         {
+            if(m_store)
+               m_store->reserve(m_base + m_current_offset + n);
+         }
+
          uint8_t save(uint8_t c)
          {
-            if(m_current_offset >= m_store->size())
+            if(m_in_place || m_counted_labels)
             {
-               m_store->resize( m_store->size() + 1 );
-               ++m_end_offset;
+               skip(1);
+               return c;
             }
 
-            m_store->at(m_current_offset) = c;
+            if(m_fixed)
+            {
+               save_fixed(&c, 1);
+               return c;
+            }
 
-            m_current_offset++;
+            auto&& idx = m_base + m_current_offset;
+
+            if(idx < m_store->size())
+            {
+               (*m_store)[idx] = c;
+            }
+            else
+            {
+               m_store->push_back(c);
+               ++m_end_offset;
+            }
+
+            ++m_current_offset;
 
             return c;
          }
 
-         template<class Str>
-         void save_offset_of(Str&& str)
+         void save(const uint8_t* p, std::size_t n)
+         {
+            if(m_in_place || m_counted_labels)
+               return skip(n);
+
+            if(m_fixed)
+               return save_fixed(p, n);
+
+            auto&& idx = m_base + m_current_offset;
+            std::size_t overlap = std::min(n, m_store->size() - idx);
+
+            std::copy_n(p, overlap, m_store->begin() + idx);
+            m_store->insert(m_store->end(), p + overlap, p + n);
+
+            m_end_offset += n - overlap;
+            m_current_offset += n;
+         }
+
+         // overwrites an already written 16 bit field, e.g. a length only known afterwards
+         void patch(uint16_t offset, uint16_t v)
+         {
+            if(m_overflowed || m_counted_labels)
+               return;
+
+            detail::store_be16(const_cast<uint8_t*>(data()) + offset, v);
+         }
+
+         bool overflowed() const
+         {
+            return m_overflowed;
+         }
+
+         // back to 'offset', dropping what was written after it (see write_within())
+         void rewind(uint16_t offset)
+         {
+            m_current_offset = offset;
+            m_end_offset = offset;
+            m_overflowed = false;
+         }
+
+         // where records being decoded allocate their variable sized data
+         std::pmr::memory_resource* resource() const
+         {
+            return m_resource;
+         }
+
+         void resource(std::pmr::memory_resource* mr)
+         {
+            m_resource = mr;
+         }
+
+         /*
+          * Names are offered for compression from 'table' (cleared here) instead of the one
+          * kept per thread, which any other encode on the thread starts over - for an encode
+          * spread over time, as message_builder_t's is.
+          */
+         void compression_table(detail::compression_table_t& table)
+         {
+            table.clear();
+            m_name_offset_assoc = &table;
+         }
+
+         void save_offset_of(uint32_t hash)
+         {
+            m_name_offset_assoc->insert(hash, current_offset());
+         }
+
+         bool counting() const
+         {
+            return m_counted_labels != nullptr;
+         }
+
+         // with count_only(), the label about to be written at current_offset()
+         void note_label(const uint8_t* p, uint8_t sz)
+         {
+            if(m_counted_labels)
+               m_counted_labels->push_back(detail::counted_label_t{current_offset(), p, sz, 0});
+         }
+
+         // with count_only(), the end of the name about to be written - see counted_label_t
+         void note_end(uint16_t target)
+         {
+            if(m_counted_labels)
+               m_counted_labels->push_back(detail::counted_label_t{current_offset(), nullptr, 0, target});
+         }
+
+         // in the order written, so by offset
+         const std::vector<detail::counted_label_t>& counted_labels() const
          {
-            m_name_offset_assoc->emplace(std::forward<Str>(str), current_offset());
+            return *m_counted_labels;
          }
 
       private:
-         name_offset_tracker_t(const name_offset_tracker_t& rhs, uint16_t b_offset, uint16_t e_offset)
-            : m_initial_offset(b_offset)
-            , m_end_offset(e_offset)
-            , m_current_offset(m_initial_offset)
-            , m_store(rhs.m_store)
-            , m_name_offset_assoc(rhs.m_name_offset_assoc)
+         name_offset_tracker_t(std::vector<uint8_t>& out, std::size_t base)
+            : m_base(base)
+            , m_store(std::shared_ptr<void>{}, &out)
+            , m_name_offset_assoc{ &detail::compression_table_t::local() }
+         {
+            m_name_offset_assoc->clear();
+         }
+
+         name_offset_tracker_t(uint8_t* out, std::size_t capacity)
+            : m_fixed(out)
+            , m_fixed_capacity(capacity)
+            , m_name_offset_assoc{ &detail::compression_table_t::local() }
          {
+            m_name_offset_assoc->clear();
+         }
+
+         struct in_place_t
+         {
+         };
+
+         name_offset_tracker_t(in_place_t, const uint8_t* msg, uint16_t offset)
+            : m_initial_offset(offset)
+            , m_end_offset(offset)
+            , m_current_offset(offset)
+            , m_in_place(msg)
+            , m_name_offset_assoc{ &detail::compression_table_t::local() }
+         {
+         }
+
+         struct count_t
+         {
+         };
+
+         // kept per thread, as the compression table is, so that sizing does not allocate
+         explicit name_offset_tracker_t(count_t)
+            : m_counted_labels{ &counted_labels_local() }
+            , m_name_offset_assoc{ &detail::compression_table_t::local() }
+         {
+            m_counted_labels->clear();
+            m_name_offset_assoc->clear();
+         }
+
+         static std::vector<detail::counted_label_t>& counted_labels_local()
+         {
+            thread_local std::vector<detail::counted_label_t> labels;
+            return labels;
+         }
+
+         void skip(std::size_t n)
+         {
+            m_current_offset += n;
+            m_end_offset = std::max(m_end_offset, m_current_offset);
+         }
+
+         void save_fixed(const uint8_t* p, std::size_t n)
+         {
+            if(m_overflowed)
+               return;
+
+            if(n > m_fixed_capacity - m_current_offset)
+            {
+               if(!m_drop_overflow)
+                  throw exception::bad_buffer_size("buffer too small", 1);
+
+               m_overflowed = true;
+               return;
+            }
+
+            std::copy_n(p, n, m_fixed + m_current_offset);
+
+            m_current_offset += n;
+            m_end_offset = std::max(m_end_offset, m_current_offset);
          }
 
       private:
          uint16_t m_initial_offset = 0;
          uint16_t m_end_offset = 0;
          uint16_t m_current_offset = 0;
-         std::shared_ptr< std::vector<uint8_t> > m_store;
-         std::shared_ptr< std::multimap<std::string, uint16_t> > m_name_offset_assoc;
+         std::size_t m_base = 0;
+         std::shared_ptr< std::vector<uint8_t> > m_store; // non-owning when appending to a caller's buffer
+         uint8_t* m_fixed = nullptr;                       // set instead of m_store when writing to a fixed buffer
+         std::size_t m_fixed_capacity = 0;
+         bool m_drop_overflow = false;                     // write_within()
+         bool m_overflowed = false;
+         const uint8_t* m_in_place = nullptr;              // set instead of m_store when reading in place
+         std::vector<detail::counted_label_t>* m_counted_labels = nullptr; // set instead of m_store when only counting
+         detail::compression_table_t* m_name_offset_assoc;
+         std::pmr::memory_resource* m_resource = std::pmr::get_default_resource();
    };
 }
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace dns
+{
+   namespace detail
+   {
+      namespace chacha
+      {
+         inline uint32_t rotl(uint32_t x, int n)
+         {
+            return (x << n) | (x >> (32 - n));
+         }
+
+         inline void quarter_round(uint32_t* s, int a, int b, int c, int d)
+         {
+            s[a] += s[b]; s[d] = rotl(s[d] ^ s[a], 16);
+            s[c] += s[d]; s[b] = rotl(s[b] ^ s[c], 12);
+            s[a] += s[b]; s[d] = rotl(s[d] ^ s[a], 8);
+            s[c] += s[d]; s[b] = rotl(s[b] ^ s[c], 7);
+         }
+
+         /*
+          * The ChaCha20 block function of RFC 7539 (section 2.3).
+          */
+         inline void block(const uint32_t key[8], uint32_t counter, const uint32_t nonce[3], uint32_t out[16])
+         {
+            uint32_t in[16] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+
+            std::memcpy(in + 4, key, 8 * sizeof(uint32_t));
+            in[12] = counter;
+            std::memcpy(in + 13, nonce, 3 * sizeof(uint32_t));
+
+            std::memcpy(out, in, sizeof(in));
+
+            for(auto i = 0; i < 10; ++i)
+            {
+               quarter_round(out, 0, 4,  8, 12);
+               quarter_round(out, 1, 5,  9, 13);
+               quarter_round(out, 2, 6, 10, 14);
+               quarter_round(out, 3, 7, 11, 15);
+
+               quarter_round(out, 0, 5, 10, 15);
+               quarter_round(out, 1, 6, 11, 12);
+               quarter_round(out, 2, 7,  8, 13);
+               quarter_round(out, 3, 4,  9, 14);
+            }
+
+            for(auto i = 0; i < 16; ++i)
+               out[i] += in[i];
+         }
+      }
+
+      /*
+       * Unpredictable query IDs: a ChaCha20 key stream, keyed from std::random_device, cut
+       * into 16 bit IDs a batch of blocks at a time.
+       *
+       * next() also skips the IDs still in flight - the ones it handed out (or that were
+       * reserve()d) and not yet release()d - so that no two outstanding queries share one.
+       */
+      class query_id_generator_t
+      {
+         public:
+            static constexpr std::size_t batch_blocks = 4;
+
+            query_id_generator_t()
+            {
+               auto&& rd = std::random_device{};
+
+               for(auto&& k : m_key)
+                  k = rd();
+
+               for(auto&& n : m_nonce)
+                  n = rd();
+            }
+
+            // the next ID of the key stream, in flight or not
+            uint16_t random()
+            {
+               if(m_pos == batch_size)
+                  refill();
+
+               return m_batch[m_pos++];
+            }
+
+            // a fresh ID, not in flight, which now is
+            uint16_t next()
+            {
+               if(m_in_flight_count == m_in_flight.size())
+                  throw std::length_error("all query ids in flight");
+
+               uint16_t id = random();
+
+               while(m_in_flight[id])
+                  id = random();
+
+               reserve(id);
+
+               return id;
+            }
+
+            // marks an ID chosen elsewhere as in flight
+            void reserve(uint16_t id)
+            {
+               if(!m_in_flight[id])
+               {
+                  m_in_flight[id] = true;
+                  ++m_in_flight_count;
+               }
+            }
+
+            void release(uint16_t id)
+            {
+               if(m_in_flight[id])
+               {
+                  m_in_flight[id] = false;
+                  --m_in_flight_count;
+               }
+            }
+
+            bool in_flight(uint16_t id) const
+            {
+               return m_in_flight[id];
+            }
+
+            std::size_t in_flight_count() const
+            {
+               return m_in_flight_count;
+            }
+
+         private:
+            static constexpr std::size_t batch_size = batch_blocks * 32;
+
+            void refill()
+            {
+               uint32_t out[16];
+
+               for(std::size_t b = 0; b < batch_blocks; ++b)
+               {
+                  chacha::block(m_key, m_counter, m_nonce, out);
+
+                  if(++m_counter == 0)
+                     ++m_nonce[0];
+
+                  for(auto i = 0; i < 16; ++i)
+                  {
+                     m_batch[b * 32 + i * 2 + 0] = static_cast<uint16_t>(out[i]);
+                     m_batch[b * 32 + i * 2 + 1] = static_cast<uint16_t>(out[i] >> 16);
+                  }
+               }
+
+               m_pos = 0;
+            }
+
+         private:
+            uint32_t m_key[8];
+            uint32_t m_nonce[3];
+            uint32_t m_counter = 0;
+
+            uint16_t m_batch[batch_size];
+            std::size_t m_pos = batch_size;
+
+            std::bitset<65536> m_in_flight;
+            std::size_t m_in_flight_count = 0;
+      };
+   }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "dns/message.h"
+#include "dns/message_view.h"
+#include "dns/detail/message_pool.h"
+
+#include <boost/system/error_code.hpp>
+#include <string>
+#include <type_traits>
+
+namespace dns
+{
+   namespace detail
+   {
+      // decode_errc_t as the boost error codes the callbacks get
+      inline const boost::system::error_category& response_decode_category()
+      {
+         struct category_t : boost::system::error_category
+         {
+            const char* name() const noexcept override
+            {
+               return "dns::decode";
+            }
+
+            std::string message(int e) const override
+            {
+               return mnemonic(static_cast<decode_errc_t>(e));
+            }
+         };
+
+         static const category_t category;
+
+         return category;
+      }
+
+      inline boost::system::error_code make_response_error(const decode_status_t& status)
+      {
+         return boost::system::error_code{static_cast<int>(status.reason), response_decode_category()};
+      }
+
+      /*
+       * The response received in [data, data + size) - or, if it is malformed, an empty
+       * view with 'ec' telling why, so that nothing is thrown out of the handler.
+       */
+      inline message_view_t response_view(const uint8_t* data, std::size_t size, boost::system::error_code& ec)
+      {
+         decode_status_t status;
+
+         auto&& response = message_view_t{data, size, status};
+
+         if(status)
+            ec = make_response_error(status);
+
+         return response;
+      }
+
+      /*
+       * Callbacks taking a message_t get a fully decoded copy of the response (the
+       * historical interface); callbacks taking a message_view_t get the view over the
+       * receive buffer, which is only valid for the duration of the call.
+       *
+       * The decoded copy is a message from the resolver's pool, given back for the next
+       * response when the callback returns. The view has only been checked as deep as
+       * message_view_t checks; rdata that does not decode comes as an error in 'ec', with
+       * an empty message.
+       */
+      template<class F>
+      void invoke_response_callback(F& callback, const boost::system::error_code& ec, const message_view_t& response, message_pool_t& pool)
+      {
+         if constexpr(std::is_invocable<F&, const boost::system::error_code&, const message_t&>::value)
+         {
+            auto&& m = pool.acquire();
+            boost::system::error_code result = ec;
+
+            if(!response.empty())
+            {
+               if(auto&& status = m->try_load_from(response.data(), response.size()))
+                  result = make_response_error(status);
+            }
+
+            callback(result, *m);
+         }
+         else
+         {
+            callback(ec, response);
+         }
+      }
+   }
+}
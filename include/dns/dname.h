@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "dns/detail/name_offset_tracker.h"
+#include "dns/detail/bin_serialize.h"
+#include "dns/detail/label_list/save_to.h"
+#include "dns/detail/label_list/load_from.h"
+#include "dns/detail/name_kernel.h"
+#include "dns/exception/bad_data_stream.h"
+#include "dns/exception/bad_name.h"
+#include "util/text_buffer.h"
+
+namespace dns
+{
+   /*
+    * A domain name kept in its uncompressed wire form (length prefixed labels, ending in
+    * the root label) in a fixed inline buffer, with the offset of every label alongside.
+    *
+    * Comparison and hashing ignore ASCII case, as DNS does; the case given is preserved.
+    */
+   class dname_t
+   {
+      public:
+         static constexpr std::size_t max_size = detail::max_name_size;
+         static constexpr std::size_t max_labels = detail::max_labels;
+
+         dname_t()
+         {
+            m_wire[0] = 0;
+         }
+
+         dname_t(std::string_view text)
+         {
+            auto&& r = detail::scan_text_name(text.data(), text.size(), m_wire, m_label_offset);
+
+            switch(r.status)
+            {
+               case detail::name_status_t::ok:
+                  break;
+
+               case detail::name_status_t::empty_label:
+               case detail::name_status_t::truncated:
+                  throw exception::bad_name("wrong format", 1);
+
+               case detail::name_status_t::label_too_long:
+                  throw exception::bad_name("length too long", 1);
+
+               case detail::name_status_t::name_too_long:
+                  throw exception::bad_name("length too long", 2);
+            }
+
+            m_size = r.wire_size;
+            m_label_count = r.label_count;
+         }
+
+         dname_t(const char* text)
+            : dname_t(std::string_view{text})
+         {
+         }
+
+         dname_t(const std::string& text)
+            : dname_t(std::string_view{text})
+         {
+         }
+
+         // the name as dotted text, without the trailing dot
+         std::string Name() const
+         {
+            auto&& result = std::string{};
+
+            result.reserve(m_size - 1);
+
+            for(std::size_t i = 0; i < m_label_count; ++i)
+            {
+               if(i > 0)
+                  result += '.';
+
+               result += Label(i);
+            }
+
+            return result;
+         }
+
+         const uint8_t* WireData() const
+         {
+            return m_wire;
+         }
+
+         std::size_t WireSize() const
+         {
+            return m_size;
+         }
+
+         std::size_t LabelCount() const
+         {
+            return m_label_count;
+         }
+
+         std::string_view Label(std::size_t i) const
+         {
+            auto&& p = m_wire + m_label_offset[i];
+
+            return std::string_view{reinterpret_cast<const char*>(p + 1), *p};
+         }
+
+         // the same name in lower case, e.g. for use as a cache key
+         dname_t Canonical() const
+         {
+            dname_t result = *this;
+
+            detail::lowercase(m_wire, m_size, result.m_wire);
+
+            return result;
+         }
+
+         bool IsRoot() const
+         {
+            return m_label_count == 0;
+         }
+
+         // true for the name itself as well as any name below it
+         bool IsSubdomainOf(const dname_t& parent) const
+         {
+            if(parent.m_label_count > m_label_count)
+               return false;
+
+            auto&& suffix = m_wire + (parent.IsRoot() ? m_size - 1 : m_label_offset[m_label_count - parent.m_label_count]);
+
+            return static_cast<std::size_t>(m_wire + m_size - suffix) == parent.m_size && equal_nocase(suffix, parent.m_wire, parent.m_size);
+         }
+
+         std::size_t Hash() const
+         {
+            return detail::name_hash(m_wire, m_size);
+         }
+
+         friend bool operator==(const dname_t& lhs, const dname_t& rhs)
+         {
+            return lhs.m_size == rhs.m_size && equal_nocase(lhs.m_wire, rhs.m_wire, lhs.m_size);
+         }
+
+         friend bool operator!=(const dname_t& lhs, const dname_t& rhs)
+         {
+            return !(lhs == rhs);
+         }
+
+         // compares against dotted text, an absolute name (single trailing dot) matches too
+         friend bool operator==(const dname_t& lhs, std::string_view rhs)
+         {
+            if(!rhs.empty() && rhs.back() == '.' && rhs != ".")
+               rhs.remove_suffix(1);
+
+            if(lhs.IsRoot())
+               return rhs.empty() || rhs == ".";
+
+            if(rhs.size() != lhs.m_size - 2u)
+               return false;
+
+            for(std::size_t i = 0, pos = 0; i < lhs.m_label_count; ++i)
+            {
+               auto&& label = lhs.Label(i);
+
+               if(i > 0 && rhs[pos++] != '.')
+                  return false;
+
+               if(!equal_nocase(reinterpret_cast<const uint8_t*>(label.data()), reinterpret_cast<const uint8_t*>(rhs.data() + pos), label.size()))
+                  return false;
+
+               pos += label.size();
+            }
+
+            return true;
+         }
+
+         friend bool operator==(std::string_view lhs, const dname_t& rhs)
+         {
+            return rhs == lhs;
+         }
+
+         friend bool operator==(const dname_t& lhs, const std::string& rhs)
+         {
+            return lhs == std::string_view{rhs};
+         }
+
+         friend bool operator==(const std::string& lhs, const dname_t& rhs)
+         {
+            return rhs == std::string_view{lhs};
+         }
+
+         friend bool operator==(const dname_t& lhs, const char* rhs)
+         {
+            return lhs == std::string_view{rhs};
+         }
+
+         friend bool operator==(const char* lhs, const dname_t& rhs)
+         {
+            return rhs == std::string_view{lhs};
+         }
+
+         friend bool operator!=(const dname_t& lhs, const std::string& rhs)
+         {
+            return !(lhs == rhs);
+         }
+
+         friend std::ostream& operator<<(std::ostream& os, const dname_t& rhs)
+         {
+            for(std::size_t i = 0; i < rhs.m_label_count; ++i)
+            {
+               if(i > 0)
+                  os << '.';
+
+               auto&& label = rhs.Label(i);
+               os.write(label.data(), label.size());
+            }
+
+            return os;
+         }
+
+      private:
+         friend struct LoadImpl<dname_t>;
+
+         bool push_label(const uint8_t* label, std::size_t sz)
+         {
+            if(m_size + 1 + sz > max_size || m_label_count == max_labels)
+               return false;
+
+            auto&& pos = m_size - 1;
+
+            m_label_offset[m_label_count++] = pos;
+            m_wire[pos] = sz;
+            std::memcpy(m_wire + pos + 1, label, sz);
+
+            m_size += sz + 1;
+            m_wire[m_size - 1] = 0;
+
+            return true;
+         }
+
+         static bool equal_nocase(const uint8_t* a, const uint8_t* b, std::size_t n)
+         {
+            return detail::equal_nocase(a, b, n);
+         }
+
+      private:
+         uint8_t m_size = 1;
+         uint8_t m_label_count = 0;
+         uint8_t m_label_offset[max_labels];
+         uint8_t m_wire[max_size];
+   };
+
+   inline void print_to(util::text_buffer_t& b, const dname_t& n)
+   {
+      for(std::size_t i = 0; i < n.LabelCount(); ++i)
+      {
+         if(i > 0)
+            b << '.';
+
+         b << n.Label(i);
+      }
+   }
+
+   inline void save_to(name_offset_tracker_t& tr, const dname_t& n)
+   {
+      detail::label_ref_t labels[dname_t::max_labels];
+
+      for(std::size_t i = 0; i < n.LabelCount(); ++i)
+      {
+         auto&& label = n.Label(i);
+
+         labels[i] = detail::label_ref_t{ reinterpret_cast<const uint8_t*>(label.data()), label.size(), 0 };
+      }
+
+      detail::save_labels(tr, labels, n.LabelCount());
+   }
+
+   template<>
+   struct LoadImpl<dname_t>
+   {
+      template<class InputIterator>
+      static dname_t impl(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
+      {
+         dname_t n{};
+
+         detail::load_name(tr, ii, end, [&n](const uint8_t* label, uint8_t sz)
+         {
+            if(!n.push_label(label, sz))
+               throw dns::exception::bad_data_stream("length too long", 2);
+         });
+
+         return n;
+      }
+   };
+}
+
+namespace std
+{
+   template<>
+   struct hash<dns::dname_t>
+   {
+      std::size_t operator()(const dns::dname_t& n) const
+      {
+         return n.Hash();
+      }
+   };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace dns
+{
+   namespace exception
+   {
+      struct bad_build_order : public std::exception
+      {
+         public:
+            bad_build_order(const char* const str, int code)
+               : m_str(str)
+               , m_code(code)
+            {
+            }
+
+            bad_build_order(bad_build_order& rhs)
+               : m_str(rhs.m_str)
+               , m_code(rhs.m_code)
+            {
+            }
+
+            bad_build_order(bad_build_order&& rhs)
+               : m_str(rhs.m_str)
+               , m_code(rhs.m_code)
+            {
+            }
+
+            int code() const noexcept { return m_code; }
+
+            const char* what() const noexcept { return m_str; }
+
+            void operator=(const bad_build_order&) = delete;
+            void operator=(bad_build_order&&) = delete;
+
+         private:
+            const char* const m_str;
+            int m_code;
+      };
+   }
+}
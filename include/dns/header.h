@@ -7,9 +7,20 @@
 #include "dns/r_code.h"
 #include "dns/detail/name_offset_tracker.h"
 #include "dns/detail/bin_serialize.h"
+#include "dns/detail/byte_order.h"
+#include "util/text_buffer.h"
 
 namespace dns
 {
+   namespace detail
+   {
+      constexpr std::size_t header_size = 12;
+   }
+
+   /*
+    * The flags are kept packed as they are on the wire, so the header loads and stores
+    * as six 16 bit words.
+    */
    class header_t
    {
       public:
@@ -23,104 +34,115 @@ namespace dns
             m_ID = v;
          }
 
+         // the second 16 bit word of the header as on the wire: QR, OPCODE, AA, TC, RD, RA, Z, AD, CD, RCODE
+         uint16_t Flags() const
+         {
+            return m_Flags;
+         }
+
+         void Flags(uint16_t v)
+         {
+            m_Flags = v;
+         }
+
          bool QR_Flag() const
          {
-            return m_QR;
+            return (m_Flags & 0x8000) != 0;
          }
 
          void QR_Flag(bool v)
          {
-            m_QR = v;
+            set_bits(0x8000, v ? 0x8000 : 0);
          }
 
          op_code_t OpCode() const
          {
-            return m_OpCode;
+            return static_cast<op_code_t>((m_Flags >> 11) & 0xF);
          }
 
          void OpCode(op_code_t v)
          {
-            m_OpCode = v;
+            set_bits(0x7800, static_cast<uint16_t>((static_cast<uint16_t>(v) & 0xF) << 11));
          }
 
          bool AA_Flag() const
          {
-            return m_AA;
+            return (m_Flags & 0x0400) != 0;
          }
 
          void AA_Flag(bool v)
          {
-            m_AA = v;
+            set_bits(0x0400, v ? 0x0400 : 0);
          }
 
          bool TC_Flag() const
          {
-            return m_TC;
+            return (m_Flags & 0x0200) != 0;
          }
 
          void TC_Flag(bool v)
          {
-            m_TC = v;
+            set_bits(0x0200, v ? 0x0200 : 0);
          }
 
          bool RD_Flag() const
          {
-            return m_RD;
+            return (m_Flags & 0x0100) != 0;
          }
 
          void RD_Flag(bool v)
          {
-            m_RD = v;
+            set_bits(0x0100, v ? 0x0100 : 0);
          }
 
          bool RA_Flag() const
          {
-            return m_RA;
+            return (m_Flags & 0x0080) != 0;
          }
 
          void RA_Flag(bool v)
          {
-            m_RA = v;
+            set_bits(0x0080, v ? 0x0080 : 0);
          }
 
          bool Res1_Flag() const
          {
-            return m_Res1;
+            return (m_Flags & 0x0040) != 0;
          }
 
          void Res1_Flag(bool v)
          {
-            m_Res1 = v;
+            set_bits(0x0040, v ? 0x0040 : 0);
          }
 
          bool AD_Flag() const
          {
-            return m_AD;
+            return (m_Flags & 0x0020) != 0;
          }
 
          void AD_Flag(bool v)
          {
-            m_AD = v;
+            set_bits(0x0020, v ? 0x0020 : 0);
          }
 
          bool CD_Flag() const
          {
-            return m_CD;
+            return (m_Flags & 0x0010) != 0;
          }
 
          void CD_Flag(bool v)
          {
-            m_CD = v;
+            set_bits(0x0010, v ? 0x0010 : 0);
          }
 
          r_code_t RCode() const
          {
-            return m_RCode;
+            return static_cast<r_code_t>(m_Flags & 0xF);
          }
 
          void RCode(r_code_t v)
          {
-            m_RCode = v;
+            set_bits(0x000F, static_cast<uint16_t>(static_cast<uint16_t>(v) & 0xF));
          }
 
          uint16_t QdCount() const
@@ -165,86 +187,116 @@ namespace dns
 
          friend std::ostream& operator<<(std::ostream& os, const header_t& rhs)
          {
-            os << "{ ";
-            os << "ID=" << rhs.ID() << ", ";
-            {
-               os << "Flags=[";
-               std::string sep = "";
-               for(auto F :
-                     {
-                        std::string(rhs.QR_Flag() ? "QR" : ""),
-                        std::string(rhs.AA_Flag() ? "AA" : ""),
-                        std::string(rhs.TC_Flag() ? "TC" : ""),
-                        std::string(rhs.RD_Flag() ? "RD" : ""),
-                        std::string(rhs.RA_Flag() ? "RA" : ""),
-                        std::string(rhs.AD_Flag() ? "AD" : ""),
-                        std::string(rhs.CD_Flag() ? "CD" : "")
-                     })
-               {
-                  if(!F.empty())
-                  {
-                     os << sep << F;
-                     if(sep.empty())
-                        sep = ",";
-                  }
-               }
-               os << "], ";
-            }
-            os << "OpCode=" << rhs.OpCode() << ", ";
-            os << "RCode=" << rhs.RCode() << ", ";
-
-            os << "QdCount=" << rhs.QdCount() << ", ";
-            os << "AnCount=" << rhs.AnCount() << ", ";
-            os << "NsCount=" << rhs.NsCount() << ", ";
-            os << "ArCount=" << rhs.ArCount() << " ";
-            os << "}";
+            return util::print(os, rhs);
+         }
 
-            return os;
+      private:
+         void set_bits(uint16_t mask, uint16_t bits)
+         {
+            m_Flags = static_cast<uint16_t>((m_Flags & ~mask) | bits);
          }
 
       private:
          uint16_t m_ID = 0;
-
-         bool m_QR = false;
-         op_code_t m_OpCode = op_code_t::query;
-         bool m_AA = false;
-         bool m_TC = false;
-         bool m_RD = false;
-
-         bool m_RA = false;
-         bool m_Res1 = false;
-         bool m_AD = false;
-         bool m_CD = false;
-         r_code_t m_RCode = r_code_t::no_error;
-
+         uint16_t m_Flags = 0;
          uint16_t m_QdCount = 0;
          uint16_t m_AnCount = 0;
          uint16_t m_NsCount = 0;
          uint16_t m_ArCount = 0;
    };
 
+   inline void print_to(util::text_buffer_t& b, const header_t& h)
+   {
+      b << "{ ";
+      b << "ID=" << h.ID() << ", ";
+      {
+         const struct
+         {
+            bool set;
+            const char* name;
+         }
+         flags[] =
+         {
+            { h.QR_Flag(), "QR" },
+            { h.AA_Flag(), "AA" },
+            { h.TC_Flag(), "TC" },
+            { h.RD_Flag(), "RD" },
+            { h.RA_Flag(), "RA" },
+            { h.AD_Flag(), "AD" },
+            { h.CD_Flag(), "CD" },
+         };
+
+         b << "Flags=[";
+         const char* sep = "";
+         for(auto&& f : flags)
+         {
+            if(f.set)
+            {
+               b << sep << f.name;
+               sep = ",";
+            }
+         }
+         b << "], ";
+      }
+      b << "OpCode=" << h.OpCode() << ", ";
+      b << "RCode=" << h.RCode() << ", ";
+
+      b << "QdCount=" << h.QdCount() << ", ";
+      b << "AnCount=" << h.AnCount() << ", ";
+      b << "NsCount=" << h.NsCount() << ", ";
+      b << "ArCount=" << h.ArCount() << " ";
+      b << "}";
+   }
+
+   namespace detail
+   {
+      /*
+       * The whole header in one go: six big endian 16 bit words, read and written with
+       * unaligned loads and stores. 'p' must have header_size bytes.
+       */
+      inline header_t load_header(const uint8_t* p)
+      {
+         header_t h{};
+
+         h.ID(load_be16(p + 0));
+         h.Flags(load_be16(p + 2));
+         h.QdCount(load_be16(p + 4));
+         h.AnCount(load_be16(p + 6));
+         h.NsCount(load_be16(p + 8));
+         h.ArCount(load_be16(p + 10));
+
+         return h;
+      }
+
+      inline void store_header(uint8_t* p, const header_t& h)
+      {
+         store_be16(p + 0, h.ID());
+         store_be16(p + 2, h.Flags());
+         store_be16(p + 4, h.QdCount());
+         store_be16(p + 6, h.AnCount());
+         store_be16(p + 8, h.NsCount());
+         store_be16(p + 10, h.ArCount());
+      }
+
+      // header fields straight off a received buffer of at least header_size bytes
+      inline uint16_t peek_id(const uint8_t* p)
+      {
+         return load_be16(p + 0);
+      }
+
+      inline uint16_t peek_flags(const uint8_t* p)
+      {
+         return load_be16(p + 2);
+      }
+   }
+
    inline void save_to(name_offset_tracker_t& tr, const header_t& h)
    {
-      save_to(tr, h.ID());
-
-      save_to(tr, static_cast<uint8_t>(
-                 (h.QR_Flag() ? 0x80 : 0) |
-                 ((static_cast<uint8_t>(h.OpCode()) & 0xF) << 3) |
-                 (h.AA_Flag() ? 0x04 : 0) |
-                 (h.TC_Flag() ? 0x02 : 0) |
-                 (h.RD_Flag() ? 0x01 : 0)));
-
-      save_to(tr, static_cast<uint8_t>(
-                 (h.RA_Flag() ? 0x80 : 0) |
-                 (h.Res1_Flag() ? 0x40 : 0) |
-                 (h.AD_Flag() ? 0x20 : 0) |
-                 (h.CD_Flag() ? 0x10 : 0) |
-                 (static_cast<uint8_t>(h.RCode()) & 0xF)));
-
-      save_to(tr, h.QdCount());
-      save_to(tr, h.AnCount());
-      save_to(tr, h.NsCount());
-      save_to(tr, h.ArCount());
+      uint8_t raw[detail::header_size];
+
+      detail::store_header(raw, h);
+
+      tr.save(raw, sizeof(raw));
    }
 
    template<>
@@ -253,40 +305,19 @@ namespace dns
       template<class InputIterator>
       static header_t impl(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
       {
-         header_t h{};
-
+         if constexpr(detail::is_contiguous_byte_iterator<InputIterator>::value)
          {
-            h.ID(load_from<uint16_t>(tr, ii, end));
+            return detail::load_in_place<detail::header_size>(tr, ii, end, detail::load_header);
          }
-
+         else
          {
-            uint8_t v = load_from<uint8_t>(tr, ii, end);
+            uint8_t raw[detail::header_size];
 
-            h.QR_Flag((v & 0x80) == 0x80 ? true : false);
-            h.OpCode(static_cast<op_code_t>((v >> 3) & 0xF));
-            h.AA_Flag((v & 0x04) == 0x04 ? true : false);
-            h.TC_Flag((v & 0x02) == 0x02 ? true : false);
-            h.RD_Flag((v & 0x01) == 0x01 ? true : false);
-         }
+            for(auto& c : raw)
+               c = load_from<uint8_t>(tr, ii, end);
 
-         {
-            uint8_t v = load_from<uint8_t>(tr, ii, end);
-
-            h.RA_Flag((v & 0x80) == 0x80 ? true : false);
-            h.Res1_Flag((v & 0x40) == 0x40 ? true : false);
-            h.AD_Flag((v & 0x20) == 0x20 ? true : false);
-            h.CD_Flag((v & 0x10) == 0x10 ? true : false);
-            h.RCode(static_cast<r_code_t>(v & 0xF));
+            return detail::load_header(raw);
          }
-
-         {
-            h.QdCount(load_from<uint16_t>(tr, ii, end));
-            h.AnCount(load_from<uint16_t>(tr, ii, end));
-            h.NsCount(load_from<uint16_t>(tr, ii, end));
-            h.ArCount(load_from<uint16_t>(tr, ii, end));
-         }
-
-         return h;
       }
    };
 }
@@ -3,7 +3,13 @@
 #include "dns/header.h"
 #include "dns/question.h"
 #include "dns/answer.h"
+#include "dns/decode_status.h"
+#include "dns/detail/query_id.h"
+#include "dns/detail/check_message.h"
+#include "util/text_buffer.h"
+#include "util/small_vector.h"
 
+#include <memory_resource>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -13,60 +19,211 @@ namespace dns
    class message_t
    {
       public:
+         /*
+          * Sections have room inside the message for a typical response - one question and
+          * a few records each - and only allocate when larger.
+          */
+         static constexpr std::size_t inline_questions = 1;
+         static constexpr std::size_t inline_answers = 8;
+         static constexpr std::size_t inline_authorities = 4;
+         static constexpr std::size_t inline_additionals = 4;
+
+         /*
+          * Sections and the variable sized rdata decoded into them are allocated from 'mr',
+          * e.g. a std::pmr::monotonic_buffer_resource released in one go once done.
+          */
+         explicit message_t(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : m_question(mr)
+            , m_answer(mr)
+            , m_authority(mr)
+            , m_additional(mr)
+         {
+         }
+
+         std::pmr::memory_resource* resource() const
+         {
+            return m_question.resource();
+         }
+
          template<class OutputIterator>
          void save_to(OutputIterator o) const
          {
             auto&& tr = name_offset_tracker_t{};
 
+            save_sections(tr);
+
+            std::copy(tr.cbegin(), tr.cend(), o);
+         }
+
+         /*
+          * Appends the encoded message to 'out', encoding in place without an intermediate buffer.
+          */
+         void save_to(std::vector<uint8_t>& out) const
+         {
+            auto&& tr = name_offset_tracker_t::append_to(out);
+
+            save_sections(tr);
+         }
+
+         /*
+          * Exact size of the encoded message, name compression included. Names are
+          * compressed as save_to() does it, but no byte is stored.
+          */
+         std::size_t encoded_size() const
+         {
+            auto&& tr = name_offset_tracker_t::count_only();
+
+            save_sections(tr);
+
+            return tr.current_offset();
+         }
+
+         /*
+          * Encodes into the caller's buffer [out, out + capacity), e.g. a slot of a send ring,
+          * returning the number of bytes written. Throws exception::bad_buffer_size if the
+          * message does not fit; nothing past 'capacity' is written either way.
+          */
+         std::size_t save_to(uint8_t* out, std::size_t capacity) const
+         {
+            auto&& tr = name_offset_tracker_t::write_to(out, capacity);
+
+            save_sections(tr);
+
+            return tr.current_offset();
+         }
+
+         /*
+          * Encodes as much of the message as fits in 'budget' bytes - 512 for plain UDP, or
+          * the payload size the client advertised over EDNS - into [out, out + budget),
+          * returning the number of bytes written. Records go in by whole RRsets (runs of
+          * records sharing owner, type and class), stopping at the first that does not fit,
+          * with the header counts telling what made it. TC is set if that cut the answer or
+          * authority section, not for additional records only (RFC 2181 section 9).
+          *
+          * Nothing is encoded past the budget in the first place. Throws
+          * exception::bad_buffer_size if not even the header and questions fit.
+          */
+         std::size_t save_truncated_to(uint8_t* out, std::size_t budget) const
+         {
+            auto&& tr = name_offset_tracker_t::write_within(out, budget);
+
             dns::save_to(tr, m_header);
 
             for(auto && q : m_question)
                dns::save_to(tr, q);
-            for(auto && r : m_answer)
-               dns::save_to(tr, r);
-            for(auto && r : m_authority)
-               dns::save_to(tr, r);
-            for(auto && r : m_additional)
-               dns::save_to(tr, r);
 
-            std::copy(tr.cbegin(), tr.cend(), o);
+            if(tr.overflowed())
+               throw exception::bad_buffer_size("buffer too small", 1);
+
+            bool cut = false;
+            header_t h = m_header;
+
+            h.AnCount(save_rrsets(tr, m_answer, cut));
+            h.NsCount(save_rrsets(tr, m_authority, cut));
+
+            if(cut)
+               h.TC_Flag(true);
+
+            h.ArCount(save_rrsets(tr, m_additional, cut));
+
+            detail::store_header(out, h);
+
+            return tr.current_offset();
          }
 
+         /*
+          * As above, preceded by the 2 byte length prefix used over TCP.
+          */
+         std::size_t save_framed_to(uint8_t* out, std::size_t capacity) const
+         {
+            if(capacity < 2)
+               throw exception::bad_buffer_size("buffer too small", 1);
+
+            auto&& sz = save_to(out + 2, capacity - 2);
+
+            detail::store_be16(out, static_cast<uint16_t>(sz));
+
+            return sz + 2;
+         }
+
+         /*
+          * Decodes the message at the start of [data, data + size) without throwing on
+          * malformed input (e.g. a garbage datagram): that is checked first, and if found
+          * the reason and offset are returned with the message left as it was.
+          */
+         decode_status_t try_load_from(const uint8_t* data, std::size_t size)
+         {
+            std::size_t section_offset[5];
+
+            auto&& status = detail::check_sections(data, size, section_offset, true);
+
+            if(!status)
+               load_checked(data, size);
+
+            return status;
+         }
+
+         /*
+          * Throws exception::bad_data_stream on malformed input. Contiguous bytes go
+          * through try_load_from and are decoded in place, other input is copied aside as it
+          * is read (compressed names refer back into it).
+          */
          template<class InputIterator>
          InputIterator load_from(InputIterator begin, InputIterator end)
          {
-            auto&& tr = name_offset_tracker_t{};
+            if constexpr(detail::is_contiguous_byte_iterator<InputIterator>::value)
+            {
+               std::size_t size = end - begin;
+               const uint8_t* data = size ? detail::byte_pointer(begin) : nullptr;
+               std::size_t section_offset[5];
 
-            m_header = dns::load_from<dns::header_t>(tr, begin, end);
-            m_question.resize(m_header.QdCount());
-            m_answer.resize(m_header.AnCount());
-            m_authority.resize(m_header.NsCount());
-            m_additional.resize(m_header.ArCount());
+               throw_if_failed(detail::check_sections(data, size, section_offset, true));
+
+               load_checked(data, size);
+
+               return begin + section_offset[4];
+            }
+            else
+            {
+               auto&& tr = name_offset_tracker_t{};
 
-            for(auto& q : m_question)
-               q = dns::load_from<dns::question_t>(tr, begin, end);
-            for(auto& r : m_answer)
-               r = dns::load_from<dns::answer_t>(tr, begin, end);
-            for(auto& r : m_authority)
-               r = dns::load_from<dns::answer_t>(tr, begin, end);
-            for(auto& r : m_additional)
-               r = dns::load_from<dns::answer_t>(tr, begin, end);
+               load_sections(tr, begin, end);
 
-            return begin;
+               return begin;
+            }
+         }
+
+         /*
+          * Back to an empty message for the next decode, the sections keeping their
+          * capacity. The rdata of the records dropped is given back to resource() - with a
+          * pool resource behind it (see detail::message_pool_t) reused by the next decode.
+          */
+         void clear()
+         {
+            m_header = header_t{};
+
+            m_question.clear();
+            m_answer.clear();
+            m_authority.clear();
+            m_additional.clear();
          }
 
          friend std::ostream& operator<<(std::ostream& os, const message_t& rhs)
          {
-            os << "HD: " << rhs.m_header << "\n";
+            return util::print(os, rhs);
+         }
+
+         friend void print_to(util::text_buffer_t& b, const message_t& rhs)
+         {
+            b << "HD: " << rhs.m_header << "\n";
             for(auto && q : rhs.m_question)
-               os << "QD: " << q << "\n";
+               b << "QD: " << q << "\n";
             for(auto && r : rhs.m_answer)
-               os << "AN: " << r << "\n";
+               b << "AN: " << r << "\n";
             for(auto && r : rhs.m_authority)
-               os << "NS: " << r << "\n";
+               b << "NS: " << r << "\n";
             for(auto && r : rhs.m_additional)
-               os << "AR: " << r << "\n";
-            return os;
+               b << "AR: " << r << "\n";
          }
 
          header_t& Header()
@@ -139,21 +296,165 @@ namespace dns
             return m_additional.at(x);
          }
 
+         // the sections as held - their sizes need not agree with the header counts
+
+         const util::small_vector_t<question_t, inline_questions>& Questions() const
+         {
+            return m_question;
+         }
+
+         const util::small_vector_t<answer_t, inline_answers>& Answers() const
+         {
+            return m_answer;
+         }
+
+         const util::small_vector_t<answer_t, inline_authorities>& Authorities() const
+         {
+            return m_authority;
+         }
+
+         const util::small_vector_t<answer_t, inline_additionals>& Additionals() const
+         {
+            return m_additional;
+         }
+
+      private:
+         template<class InputIterator>
+         void load_sections(name_offset_tracker_t& tr, InputIterator& begin, InputIterator end)
+         {
+            tr.resource(resource());
+
+            m_header = dns::load_from<dns::header_t>(tr, begin, end);
+
+            load_section(m_question, m_header.QdCount(), tr, begin, end);
+            load_section(m_answer, m_header.AnCount(), tr, begin, end);
+            load_section(m_authority, m_header.NsCount(), tr, begin, end);
+            load_section(m_additional, m_header.ArCount(), tr, begin, end);
+         }
+
+         // decodes a message that passed detail::check_sections
+         void load_checked(const uint8_t* data, std::size_t size)
+         {
+            auto&& tr = name_offset_tracker_t::read_in_place(data);
+            const uint8_t* b = data;
+
+            load_sections(tr, b, data + size);
+         }
+
+         /*
+          * Elements are moved in, never assigned over, so they keep the section's allocator.
+          * Only counts already held against the bytes by check_sections() (contiguous input
+          * always is) are reserved up front - a bare header may claim 65535 records.
+          */
+         template<class SectionT, class InputIterator>
+         static void load_section(SectionT& section, uint16_t count, name_offset_tracker_t& tr, InputIterator& begin, InputIterator end)
+         {
+            section.clear();
+
+            if constexpr(detail::is_contiguous_byte_iterator<InputIterator>::value)
+               section.reserve(count);
+
+            for(uint16_t i = 0; i < count; ++i)
+               section.push_back(dns::load_from<typename SectionT::value_type>(tr, begin, end));
+         }
+
+         /*
+          * Upper bound of the encoded size as long as the rdata fits in 'rdata_hint' bytes
+          * per record - exact for queries, where all the time goes into the question.
+          */
+         std::size_t encoded_size_hint(std::size_t rdata_hint = 16) const
+         {
+            auto&& sz = std::size_t{12};
+
+            for(auto && q : m_question)
+               sz += q.Name().WireSize() + 4;
+
+            auto&& add_records = [&sz, rdata_hint](auto&& section)
+            {
+               for(auto && r : section)
+                  sz += r.Name().WireSize() + 10 + rdata_hint;
+            };
+
+            add_records(m_answer);
+            add_records(m_authority);
+            add_records(m_additional);
+
+            return sz;
+         }
+
+         // the records of 'section' in whole RRsets while they fit, unless 'cut' already - returns how many
+         template<class SectionT>
+         static uint16_t save_rrsets(name_offset_tracker_t& tr, const SectionT& section, bool& cut)
+         {
+            std::size_t saved = 0;
+
+            while(!cut && saved < section.size())
+            {
+               auto&& first = section[saved];
+               std::size_t rrset_end = saved + 1;
+
+               while(rrset_end < section.size() && section[rrset_end].Type() == first.Type() &&
+                     section[rrset_end].Class() == first.Class() && section[rrset_end].Name() == first.Name())
+                  ++rrset_end;
+
+               uint16_t rrset_begin = tr.current_offset();
+
+               for(auto i = saved; i < rrset_end && !tr.overflowed(); ++i)
+                  dns::save_to(tr, section[i]);
+
+               if(tr.overflowed())
+               {
+                  tr.rewind(rrset_begin);
+                  cut = true;
+               }
+               else
+               {
+                  saved = rrset_end;
+               }
+            }
+
+            return static_cast<uint16_t>(saved);
+         }
+
+         void save_sections(name_offset_tracker_t& tr) const
+         {
+            tr.reserve(encoded_size_hint());
+
+            dns::save_to(tr, m_header);
+
+            for(auto && q : m_question)
+               dns::save_to(tr, q);
+            for(auto && r : m_answer)
+               dns::save_to(tr, r);
+            for(auto && r : m_authority)
+               dns::save_to(tr, r);
+            for(auto && r : m_additional)
+               dns::save_to(tr, r);
+         }
+
       private:
          header_t m_header;
-         std::vector<question_t> m_question;
-         std::vector<answer_t> m_answer;
-         std::vector<answer_t> m_authority;
-         std::vector<answer_t> m_additional;
+         util::small_vector_t<question_t, inline_questions> m_question;
+         util::small_vector_t<answer_t, inline_answers> m_answer;
+         util::small_vector_t<answer_t, inline_authorities> m_authority;
+         util::small_vector_t<answer_t, inline_additionals> m_additional;
    };
 
-   const message_t make_query(std::string qname, dns::rr_type_t qtype, dns::rr_class_t qclass = dns::rr_class_t::internet)
+   namespace detail
    {
-      auto&& m = dns::message_t{};
+      inline uint16_t random_query_id()
+      {
+         thread_local query_id_generator_t gen;
 
-      srand(time(0));
+         return gen.random();
+      }
+   }
 
-      m.Header().ID(rand());
+   inline const message_t make_query(std::string qname, dns::rr_type_t qtype, dns::rr_class_t qclass = dns::rr_class_t::internet)
+   {
+      auto&& m = dns::message_t{};
+
+      m.Header().ID(detail::random_query_id());
       m.Header().RD_Flag(true);
       m.Header().AD_Flag(true);
       m.Header().QdCount(1);
@@ -166,21 +467,4 @@ namespace dns
 
       return m;
    }
-
-   /*
-    * TODO: Request Builder (client side)
-    *
-    *    dns::request().WithID().WithRecurrsion().
-    *                  .AddQuestionNamed(n).WithQType(1).WithQClass(2)
-    *
-    * TODO: Response Builder (server side)
-    *
-    *    dns::response().WithID()...
-    *                   .AddQuestionNamed(n).WithQType(1).WithQClass(2)
-    *                   .AddAnswer().WithType(t).WithPreference().WithMXData().WithPreference().WithName("mx.n.com")
-    *                   .AddAuthority().WithNS(ns)...
-    *                   .AddAuthority().WithNS(ns)...
-    *                   .AddAdditional().Withxx(yy)...
-    *
-    */
 }
@@ -0,0 +1,338 @@
+#pragma once
+
+#include "dns/message.h"
+#include "dns/header.h"
+#include "dns/dname.h"
+#include "dns/answer.h"
+#include "dns/exception/bad_build_order.h"
+
+#include "dns/detail/name_offset_tracker.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dns
+{
+   /*
+    * Writes a message as it is described, each call going straight into the output - no
+    * message_t is built first:
+    *
+    *    dns::response(out).WithID(id).WithRecursionAvailable()
+    *                      .AddQuestionNamed(n).WithQType(dns::rr_type_t::rec_mx)
+    *                      .AddAnswer(n).WithTTL(300).WithData(dns::rec_mx_t{1, "mx.n.com"})
+    *                      .AddAuthority(n).WithTTL(3600).WithData(dns::rec_ns_t{"ns.n.com"})
+    *                      .AddAdditional("ns.n.com").WithTTL(3600).WithData(dns::rec_a_t{"192.0.2.1"});
+    *
+    * Names are compressed against those written before, and the header counts kept up to
+    * date, so the output is a whole message after every call. Sections have to be added
+    * in order (questions, answers, authority, additional); With*() after an Add*() set
+    * that question or record, a record taking its type from WithData().
+    *
+    * A fixed buffer that runs out throws exception::bad_buffer_size, leaving the bytes
+    * past it untouched. Calls out of order throw exception::bad_build_order.
+    *
+    * The names written are remembered in a compression table of the builder's own, so
+    * other messages encoded on the thread in between do not stop later names compressing.
+    */
+   class message_builder_t
+   {
+      public:
+         // onto the end of 'out'
+         static message_builder_t append_to(std::vector<uint8_t>& out)
+         {
+            return message_builder_t{name_offset_tracker_t::append_to(out)};
+         }
+
+         // into [out, out + capacity)
+         static message_builder_t write_to(uint8_t* out, std::size_t capacity)
+         {
+            return message_builder_t{name_offset_tracker_t::write_to(out, capacity)};
+         }
+
+         // bytes written so far
+         std::size_t size() const
+         {
+            return m_tr.current_offset();
+         }
+
+         /////////////////////////////////////////////////////
+         // header
+
+         message_builder_t& WithID(uint16_t id)
+         {
+            m_header.ID(id);
+            return store_header();
+         }
+
+         // a random one
+         message_builder_t& WithID()
+         {
+            return WithID(detail::random_query_id());
+         }
+
+         // QR
+         message_builder_t& AsResponse(bool v = true)
+         {
+            m_header.QR_Flag(v);
+            return store_header();
+         }
+
+         message_builder_t& WithOpCode(op_code_t v)
+         {
+            m_header.OpCode(v);
+            return store_header();
+         }
+
+         message_builder_t& WithRCode(r_code_t v)
+         {
+            m_header.RCode(v);
+            return store_header();
+         }
+
+         message_builder_t& WithRecursion(bool v = true)
+         {
+            m_header.RD_Flag(v);
+            return store_header();
+         }
+
+         message_builder_t& WithRecursionAvailable(bool v = true)
+         {
+            m_header.RA_Flag(v);
+            return store_header();
+         }
+
+         message_builder_t& WithAuthoritative(bool v = true)
+         {
+            m_header.AA_Flag(v);
+            return store_header();
+         }
+
+         message_builder_t& WithAuthenticData(bool v = true)
+         {
+            m_header.AD_Flag(v);
+            return store_header();
+         }
+
+         message_builder_t& WithCheckingDisabled(bool v = true)
+         {
+            m_header.CD_Flag(v);
+            return store_header();
+         }
+
+         /////////////////////////////////////////////////////
+         // questions, of type A and class IN unless set
+
+         message_builder_t& AddQuestionNamed(const dname_t& name)
+         {
+            if(m_section != section_t::question)
+               throw exception::bad_build_order("question after records", 1);
+
+            save_to(m_tr, name);
+
+            m_fields = m_tr.current_offset();
+
+            save_to(m_tr, static_cast<uint16_t>(rr_type_t::rec_a));
+            save_to(m_tr, static_cast<uint16_t>(rr_class_t::internet));
+
+            m_header.QdCount(m_header.QdCount() + 1);
+
+            return store_header();
+         }
+
+         message_builder_t& WithQType(rr_type_t v)
+         {
+            m_tr.patch(question_field(0), static_cast<uint16_t>(v));
+            return *this;
+         }
+
+         message_builder_t& WithQClass(rr_class_t v)
+         {
+            m_tr.patch(question_field(2), static_cast<uint16_t>(v));
+            return *this;
+         }
+
+         /////////////////////////////////////////////////////
+         // records, of class IN and TTL 0 unless set
+
+         message_builder_t& AddAnswer(const dname_t& owner)
+         {
+            return add_record(section_t::answer, owner);
+         }
+
+         message_builder_t& AddAuthority(const dname_t& owner)
+         {
+            return add_record(section_t::authority, owner);
+         }
+
+         message_builder_t& AddAdditional(const dname_t& owner)
+         {
+            return add_record(section_t::additional, owner);
+         }
+
+         message_builder_t& WithClass(rr_class_t v)
+         {
+            m_tr.patch(record_field(2), static_cast<uint16_t>(v));
+            return *this;
+         }
+
+         message_builder_t& WithTTL(uint32_t v)
+         {
+            m_tr.patch(record_field(4), static_cast<uint16_t>(v >> 16));
+            m_tr.patch(record_field(6), static_cast<uint16_t>(v));
+            return *this;
+         }
+
+         // the record's type and rdata, e.g. WithData(dns::rec_mx_t{10, "mx.n.com"})
+         template<class RecordT>
+         message_builder_t& WithData(const RecordT& r)
+         {
+            return with_data(RecordT::m_type, r);
+         }
+
+         // rdata of a type without a record class of its own
+         message_builder_t& WithData(rr_type_t type, const rec_raw_t& r)
+         {
+            return with_data(type, r);
+         }
+
+      private:
+         enum class section_t
+         {
+            question,
+            answer,
+            authority,
+            additional,
+         };
+
+         explicit message_builder_t(name_offset_tracker_t tr)
+            : m_table(std::make_unique<detail::compression_table_t>())
+            , m_tr(std::move(tr))
+         {
+            m_tr.compression_table(*m_table);
+
+            save_to(m_tr, m_header);
+         }
+
+         message_builder_t& store_header()
+         {
+            m_tr.patch(0, m_header.ID());
+            m_tr.patch(2, m_header.Flags());
+            m_tr.patch(4, m_header.QdCount());
+            m_tr.patch(6, m_header.AnCount());
+            m_tr.patch(8, m_header.NsCount());
+            m_tr.patch(10, m_header.ArCount());
+
+            return *this;
+         }
+
+         uint16_t question_field(uint16_t offset) const
+         {
+            if(m_section != section_t::question || m_header.QdCount() == 0)
+               throw exception::bad_build_order("no question to set", 2);
+
+            return m_fields + offset;
+         }
+
+         uint16_t record_field(uint16_t offset) const
+         {
+            if(m_section == section_t::question)
+               throw exception::bad_build_order("no record to set", 3);
+
+            return m_fields + offset;
+         }
+
+         message_builder_t& add_record(section_t section, const dname_t& owner)
+         {
+            if(section < m_section)
+               throw exception::bad_build_order("records out of section order", 4);
+
+            m_section = section;
+
+            save_to(m_tr, owner);
+
+            m_fields = m_tr.current_offset();
+            m_has_data = false;
+
+            // type, class, TTL, rdata length
+            save_to(m_tr, static_cast<uint16_t>(0));
+            save_to(m_tr, static_cast<uint16_t>(rr_class_t::internet));
+            save_to(m_tr, static_cast<uint32_t>(0));
+            save_to(m_tr, static_cast<uint16_t>(0));
+
+            switch(section)
+            {
+               case section_t::answer:
+                  m_header.AnCount(m_header.AnCount() + 1);
+                  break;
+               case section_t::authority:
+                  m_header.NsCount(m_header.NsCount() + 1);
+                  break;
+               default:
+                  m_header.ArCount(m_header.ArCount() + 1);
+                  break;
+            }
+
+            return store_header();
+         }
+
+         template<class RecordT>
+         message_builder_t& with_data(rr_type_t type, const RecordT& r)
+         {
+            uint16_t fields = record_field(0);
+
+            if(m_has_data)
+               throw exception::bad_build_order("record data already set", 5);
+
+            m_tr.patch(fields, static_cast<uint16_t>(type));
+
+            save_to(m_tr, r);
+
+            m_tr.patch(fields + 8, static_cast<uint16_t>(m_tr.current_offset() - fields - 10));
+            m_has_data = true;
+
+            return *this;
+         }
+
+      private:
+         std::unique_ptr<detail::compression_table_t> m_table;    // on the heap, so moving the builder keeps m_tr's pointer to it
+         name_offset_tracker_t m_tr;
+         header_t m_header;
+         section_t m_section = section_t::question;
+         uint16_t m_fields = 0;     // offset of the type field of the last question or record
+         bool m_has_data = false;
+   };
+
+   /*
+    * A query (QR clear) or a response (QR set) written onto the end of 'out' or into the
+    * fixed buffer [out, out + capacity), see message_builder_t.
+    */
+
+   inline message_builder_t request(std::vector<uint8_t>& out)
+   {
+      return message_builder_t::append_to(out);
+   }
+
+   inline message_builder_t request(uint8_t* out, std::size_t capacity)
+   {
+      return message_builder_t::write_to(out, capacity);
+   }
+
+   inline message_builder_t response(std::vector<uint8_t>& out)
+   {
+      message_builder_t b = message_builder_t::append_to(out);
+
+      b.AsResponse();
+
+      return b;
+   }
+
+   inline message_builder_t response(uint8_t* out, std::size_t capacity)
+   {
+      message_builder_t b = message_builder_t::write_to(out, capacity);
+
+      b.AsResponse();
+
+      return b;
+   }
+}
@@ -0,0 +1,432 @@
+#pragma once
+
+#include "dns/header.h"
+#include "dns/rr_type.h"
+#include "dns/rr_class.h"
+
+#include "dns/detail/byte_order.h"
+#include "dns/detail/bin_serialize.h"
+#include "dns/detail/name_offset_tracker.h"
+#include "dns/detail/label_list/walk.h"
+#include "dns/detail/check_message.h"
+#include "dns/decode_status.h"
+#include "dns/exception/bad_data_stream.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace dns
+{
+   /*
+    * A (possibly compressed) domain name inside a message buffer. Labels are decoded
+    * on access, nothing is copied until text is asked for.
+    */
+   class name_view_t
+   {
+      public:
+         name_view_t() = default;
+
+         name_view_t(const uint8_t* msg, std::size_t size, std::size_t offset)
+            : m_msg(msg)
+            , m_size(size)
+            , m_offset(offset)
+         {
+         }
+
+         template<class F>
+         void for_each_label(F&& fu) const
+         {
+            std::size_t offset = m_offset;
+
+            detail::throw_if_failed(detail::walk_name(m_msg, m_size, offset, std::forward<F>(fu)));
+         }
+
+         std::string Name() const
+         {
+            std::string result;
+
+            for_each_label([&result](const uint8_t* label, uint8_t sz)
+            {
+               if(!result.empty())
+                  result += '.';
+
+               result.append(reinterpret_cast<const char*>(label), sz);
+            });
+
+            return result;
+         }
+
+         friend std::ostream& operator<<(std::ostream& os, const name_view_t& rhs)
+         {
+            auto&& first = true;
+
+            rhs.for_each_label([&os, &first](const uint8_t* label, uint8_t sz)
+            {
+               if(!first)
+                  os << '.';
+
+               os.write(reinterpret_cast<const char*>(label), sz);
+               first = false;
+            });
+
+            return os;
+         }
+
+      private:
+         const uint8_t* m_msg = nullptr;
+         std::size_t m_size = 0;
+         std::size_t m_offset = 0;
+   };
+
+   class question_view_t
+   {
+      public:
+         question_view_t(const uint8_t* msg, std::size_t size, std::size_t offset)
+            : m_msg(msg)
+            , m_size(size)
+            , m_offset(offset)
+            , m_fixed_offset(offset)
+         {
+            detail::skip_name(m_msg, m_size, m_fixed_offset); // already validated by message_view_t
+         }
+
+         name_view_t Name() const
+         {
+            return name_view_t{m_msg, m_size, m_offset};
+         }
+
+         rr_type_t Type() const
+         {
+            return static_cast<rr_type_t>(detail::load_be16(m_msg + m_fixed_offset));
+         }
+
+         rr_class_t Class() const
+         {
+            return static_cast<rr_class_t>(detail::load_be16(m_msg + m_fixed_offset + 2));
+         }
+
+         std::size_t end_offset() const
+         {
+            return m_fixed_offset + 4;
+         }
+
+      private:
+         const uint8_t* m_msg;
+         std::size_t m_size;
+         std::size_t m_offset;
+         std::size_t m_fixed_offset;
+   };
+
+   class record_view_t
+   {
+      public:
+         record_view_t(const uint8_t* msg, std::size_t size, std::size_t offset)
+            : m_msg(msg)
+            , m_size(size)
+            , m_offset(offset)
+            , m_fixed_offset(offset)
+         {
+            detail::skip_name(m_msg, m_size, m_fixed_offset); // already validated by message_view_t
+         }
+
+         name_view_t Name() const
+         {
+            return name_view_t{m_msg, m_size, m_offset};
+         }
+
+         rr_type_t Type() const
+         {
+            return static_cast<rr_type_t>(detail::load_be16(m_msg + m_fixed_offset));
+         }
+
+         rr_class_t Class() const
+         {
+            return static_cast<rr_class_t>(detail::load_be16(m_msg + m_fixed_offset + 2));
+         }
+
+         uint32_t TTL() const
+         {
+            return detail::load_be32(m_msg + m_fixed_offset + 4);
+         }
+
+         uint16_t DataLength() const
+         {
+            return detail::load_be16(m_msg + m_fixed_offset + 8);
+         }
+
+         const uint8_t* DataBegin() const
+         {
+            return m_msg + m_fixed_offset + 10;
+         }
+
+         const uint8_t* DataEnd() const
+         {
+            return DataBegin() + DataLength();
+         }
+
+         /*
+          * Decodes the rdata as RecordT - the caller is expected to have checked Type().
+          * Throws exception::bad_data_stream, as message_t does, unless it takes exactly
+          * DataLength() bytes.
+          */
+         template<class RecordT>
+         RecordT Data() const
+         {
+            auto&& tr = name_offset_tracker_t::read_in_place(m_msg, DataBegin() - m_msg);
+            auto&& b = DataBegin();
+            auto&& e = DataEnd();
+
+            RecordT r = load_from<RecordT>(tr, b, e);
+
+            if(b != e)
+               throw dns::exception::bad_data_stream("bad record", 5);
+
+            return r;
+         }
+
+         std::size_t end_offset() const
+         {
+            return m_fixed_offset + 10 + DataLength();
+         }
+
+      private:
+         const uint8_t* m_msg;
+         std::size_t m_size;
+         std::size_t m_offset;
+         std::size_t m_fixed_offset;
+   };
+
+   template<class EntryT>
+   class section_view_t
+   {
+      public:
+         class iterator
+         {
+            public:
+               using iterator_category = std::forward_iterator_tag;
+               using value_type = EntryT;
+               using difference_type = std::ptrdiff_t;
+               using pointer = void;
+               using reference = EntryT;
+
+               iterator(const uint8_t* msg, std::size_t size, std::size_t offset)
+                  : m_msg(msg)
+                  , m_size(size)
+                  , m_offset(offset)
+               {
+               }
+
+               EntryT operator*() const
+               {
+                  return EntryT{m_msg, m_size, m_offset};
+               }
+
+               iterator& operator++()
+               {
+                  m_offset = (**this).end_offset();
+                  return *this;
+               }
+
+               iterator operator++(int)
+               {
+                  auto prev = *this;
+                  ++*this;
+                  return prev;
+               }
+
+               friend bool operator==(const iterator& lhs, const iterator& rhs)
+               {
+                  return lhs.m_offset == rhs.m_offset;
+               }
+
+               friend bool operator!=(const iterator& lhs, const iterator& rhs)
+               {
+                  return !(lhs == rhs);
+               }
+
+            private:
+               const uint8_t* m_msg;
+               std::size_t m_size;
+               std::size_t m_offset;
+         };
+
+         section_view_t(const uint8_t* msg, std::size_t size, std::size_t begin_offset, std::size_t end_offset, uint16_t count)
+            : m_msg(msg)
+            , m_size(size)
+            , m_begin_offset(begin_offset)
+            , m_end_offset(end_offset)
+            , m_count(count)
+         {
+         }
+
+         iterator begin() const
+         {
+            return iterator{m_msg, m_size, m_begin_offset};
+         }
+
+         iterator end() const
+         {
+            return iterator{m_msg, m_size, m_end_offset};
+         }
+
+         uint16_t size() const
+         {
+            return m_count;
+         }
+
+         bool empty() const
+         {
+            return m_count == 0;
+         }
+
+      private:
+         const uint8_t* m_msg;
+         std::size_t m_size;
+         std::size_t m_begin_offset;
+         std::size_t m_end_offset;
+         uint16_t m_count;
+   };
+
+   /*
+    * Read-only view of a DNS message over a contiguous buffer. The header and the
+    * section boundaries are validated once on construction; names and rdata are only
+    * decoded when asked for. The buffer must outlive the view.
+    */
+   class message_view_t
+   {
+      public:
+         message_view_t() = default;
+
+         message_view_t(const uint8_t* data, std::size_t size)
+         {
+            decode_status_t status;
+
+            *this = message_view_t{data, size, status};
+
+            throw_if_failed(status);
+         }
+
+         /*
+          * As above, but not throwing: if the message is malformed 'status' tells why and
+          * where, and the view is left empty().
+          */
+         message_view_t(const uint8_t* data, std::size_t size, decode_status_t& status)
+         {
+            status = detail::check_sections(data, size, m_section_offset, false);
+
+            if(!status)
+            {
+               m_data = data;
+               m_size = size;
+               m_header = detail::load_header(m_data);
+            }
+         }
+
+         template<class Container>
+         explicit message_view_t(const Container& c)
+            : message_view_t(reinterpret_cast<const uint8_t*>(c.data()), c.size())
+         {
+         }
+
+         bool empty() const
+         {
+            return m_data == nullptr;
+         }
+
+         const uint8_t* data() const
+         {
+            return m_data;
+         }
+
+         // number of bytes covered by the message (excess data in the buffer is not counted)
+         std::size_t size() const
+         {
+            return m_section_offset[4];
+         }
+
+         const header_t& Header() const
+         {
+            return m_header;
+         }
+
+         section_view_t<question_view_t> Questions() const
+         {
+            return section<question_view_t>(0, m_header.QdCount());
+         }
+
+         section_view_t<record_view_t> Answers() const
+         {
+            return section<record_view_t>(1, m_header.AnCount());
+         }
+
+         section_view_t<record_view_t> Authorities() const
+         {
+            return section<record_view_t>(2, m_header.NsCount());
+         }
+
+         section_view_t<record_view_t> Additionals() const
+         {
+            return section<record_view_t>(3, m_header.ArCount());
+         }
+
+      private:
+         template<class EntryT>
+         section_view_t<EntryT> section(int x, uint16_t count) const
+         {
+            return section_view_t<EntryT>{m_data, m_size, m_section_offset[x], m_section_offset[x + 1], count};
+         }
+
+      private:
+         const uint8_t* m_data = nullptr;
+         std::size_t m_size = 0;
+         header_t m_header;
+         std::size_t m_section_offset[5] = {};
+   };
+
+   /*
+    * Calls fu(const RecordT&) - or fu(const RecordT&, const record_view_t&), to also see
+    * the owner, TTL etc. - for every record of type RecordT in the section, in order:
+    *
+    *    dns::for_each_record<dns::rec_mx_t>(view.Answers(), [](auto&& mx)
+    *    {
+    *       ...
+    *    });
+    *
+    * Only those records have their rdata decoded; any other costs reading its type and
+    * stepping over it.
+    */
+   template<class RecordT, class F>
+   void for_each_record(const section_view_t<record_view_t>& section, F&& fu)
+   {
+      for(auto&& r : section)
+      {
+         if(r.Type() != RecordT::m_type)
+            continue;
+
+         auto&& rec = r.template Data<RecordT>();
+
+         if constexpr(std::is_invocable<F, const RecordT&, const record_view_t&>::value)
+            fu(static_cast<const RecordT&>(rec), r);
+         else
+            fu(static_cast<const RecordT&>(rec));
+      }
+   }
+
+   // the first record of type RecordT in the section, if any, with nothing after it decoded
+   template<class RecordT>
+   std::optional<RecordT> first_record(const section_view_t<record_view_t>& section)
+   {
+      for(auto&& r : section)
+      {
+         if(r.Type() == RecordT::m_type)
+            return r.template Data<RecordT>();
+      }
+
+      return std::nullopt;
+   }
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <ostream>
+#include <string_view>
+
+#include "util/text_buffer.h"
 
 namespace dns
 {
@@ -16,22 +19,38 @@ namespace dns
       /* unassigned = 6-15, */
    };
 
-   std::ostream& operator<<(std::ostream& os, op_code_t rhs)
+   // the mnemonic, empty for values without one
+   inline std::string_view mnemonic(op_code_t rhs)
    {
       switch(rhs)
       {
          case op_code_t::query:
-            return os << "query";
+            return "query";
          case op_code_t::iquery:
-            return os << "iquery";
+            return "iquery";
          case op_code_t::status:
-            return os << "status";
+            return "status";
          case op_code_t::notify:
-            return os << "notify";
+            return "notify";
          case op_code_t::update:
-            return os << "update";
+            return "update";
       }
 
-      return os << static_cast<unsigned>(rhs);
+      return {};
+   }
+
+   inline void print_to(util::text_buffer_t& b, op_code_t rhs)
+   {
+      auto&& name = mnemonic(rhs);
+
+      if(name.empty())
+         b << static_cast<unsigned>(rhs);
+      else
+         b << name;
+   }
+
+   inline std::ostream& operator<<(std::ostream& os, op_code_t rhs)
+   {
+      return util::print(os, rhs);
    }
 }
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "dns/message.h"
+#include "dns/dname.h"
+#include "dns/rr_type.h"
+#include "dns/rr_class.h"
+#include "dns/op_code.h"
+#include "dns/r_code.h"
+
+#include "util/text_buffer.h"
+
+#include <cstdint>
+#include <string_view>
+
+/*
+ * Master file (zone file) presentation format, RFC 1035 section 5 - one line per record:
+ *
+ *    yahoo.com.	1800	IN	MX	1 mta5.am0.yahoodns.net.
+ *
+ * with the rdata of types without a presentation form here written in the generic
+ * "\# <length> <hex>" form of RFC 3597.
+ *
+ * All of it goes through print_zone_to(util::text_buffer_t&, ...) overloads, so dumping
+ * many messages into one reused buffer allocates nothing per record.
+ */
+
+namespace dns
+{
+   namespace detail
+   {
+      enum class zone_char_t : uint8_t
+      {
+         plain,
+         escape,     // \c
+         decimal,    // \DDD
+      };
+
+      struct zone_char_table_t
+      {
+         constexpr zone_char_table_t(bool quoted)
+            : kind{}
+         {
+            for(auto c = 0; c < 256; ++c)
+               kind[c] = (c < 0x20 || c > 0x7E) ? zone_char_t::decimal : zone_char_t::plain;
+
+            kind[static_cast<uint8_t>('"')] = zone_char_t::escape;
+            kind[static_cast<uint8_t>('\\')] = zone_char_t::escape;
+
+            if(!quoted)
+            {
+               for(auto c : { ' ', '.', '(', ')', ';', '@', '$' })
+                  kind[static_cast<uint8_t>(c)] = zone_char_t::escape;
+            }
+         }
+
+         zone_char_t kind[256];
+      };
+
+      inline constexpr zone_char_table_t zone_label_chars{false};
+      inline constexpr zone_char_table_t zone_quoted_chars{true};
+
+      inline void print_zone_escaped(util::text_buffer_t& b, const zone_char_table_t& table, const char* p, std::size_t n)
+      {
+         const char* run = p;
+
+         for(auto&& e = p + n; p != e; ++p)
+         {
+            auto&& c = static_cast<uint8_t>(*p);
+
+            if(table.kind[c] == zone_char_t::plain)
+               continue;
+
+            b.append(run, p - run);
+            b << '\\';
+
+            if(table.kind[c] == zone_char_t::escape)
+            {
+               b << static_cast<char>(c);
+            }
+            else
+            {
+               b << static_cast<char>('0' + c / 100) << static_cast<char>('0' + c / 10 % 10) << static_cast<char>('0' + c % 10);
+            }
+
+            run = p + 1;
+         }
+
+         b.append(run, p - run);
+      }
+
+      // upper case, '_' as '-' (e.g. NSAP-PTR) or dropped (e.g. NOERROR)
+      inline void print_zone_mnemonic(util::text_buffer_t& b, std::string_view name, bool keep_underscore)
+      {
+         for(auto&& c : name)
+         {
+            if(c == '_')
+            {
+               if(keep_underscore)
+                  b << '-';
+            }
+            else
+            {
+               b << static_cast<char>(c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c);
+            }
+         }
+      }
+
+      inline void print_zone_hex(util::text_buffer_t& b, std::string_view bytes)
+      {
+         constexpr const char* digits = "0123456789ABCDEF";
+
+         for(auto&& c : bytes)
+            b << digits[static_cast<uint8_t>(c) >> 4] << digits[static_cast<uint8_t>(c) & 0xF];
+      }
+   }
+
+   // absolute, i.e. with the trailing dot
+   inline void print_zone_to(util::text_buffer_t& b, const dname_t& n)
+   {
+      if(n.IsRoot())
+      {
+         b << '.';
+         return;
+      }
+
+      for(std::size_t i = 0; i < n.LabelCount(); ++i)
+      {
+         auto&& label = n.Label(i);
+
+         detail::print_zone_escaped(b, detail::zone_label_chars, label.data(), label.size());
+         b << '.';
+      }
+   }
+
+   inline void print_zone_to(util::text_buffer_t& b, rr_type_t t)
+   {
+      auto&& name = mnemonic(t);
+
+      if(name.empty())
+         b << "TYPE" << static_cast<unsigned>(t);
+      else
+         detail::print_zone_mnemonic(b, name, true);
+   }
+
+   inline void print_zone_to(util::text_buffer_t& b, rr_class_t c)
+   {
+      switch(c)
+      {
+         case rr_class_t::internet:
+            b << "IN";
+            return;
+         case rr_class_t::chaos:
+            b << "CH";
+            return;
+         case rr_class_t::hesiod:
+            b << "HS";
+            return;
+         case rr_class_t::none:
+            b << "NONE";
+            return;
+         case rr_class_t::any:
+            b << "ANY";
+            return;
+         default:
+            b << "CLASS" << static_cast<unsigned>(c);
+            return;
+      }
+   }
+
+   /////////////////////////////////////////////////////
+   // rdata
+
+   inline void print_zone_to(util::text_buffer_t& b, const rec_a_t& r)
+   {
+      b.append_ipv4(r.Address());
+   }
+
+   inline void print_zone_to(util::text_buffer_t& b, const rec_ns_t& r)
+   {
+      print_zone_to(b, r.Name());
+   }
+
+   inline void print_zone_to(util::text_buffer_t& b, const rec_cname_t& r)
+   {
+      print_zone_to(b, r.Name());
+   }
+
+   inline void print_zone_to(util::text_buffer_t& b, const rec_ptr_t& r)
+   {
+      print_zone_to(b, r.Name());
+   }
+
+   inline void print_zone_to(util::text_buffer_t& b, const rec_mx_t& r)
+   {
+      b << r.Preference() << ' ';
+      print_zone_to(b, r.Exchange());
+   }
+
+   inline void print_zone_to(util::text_buffer_t& b, const rec_soa_t& r)
+   {
+      print_zone_to(b, r.MName());
+      b << ' ';
+      print_zone_to(b, r.RName());
+      b << ' ' << r.Serial() << ' ' << r.RefreshInterval() << ' ' << r.RetryInterval() << ' ' << r.ExpireInterval() << ' ' << r.MinimumTTL();
+   }
+
+   // the character strings, each quoted
+   inline void print_zone_to(util::text_buffer_t& b, const rec_txt_t& r)
+   {
+      if(r.Strings().empty())
+      {
+         b << "\"\"";
+         return;
+      }
+
+      const char* sep = "";
+
+      for(auto&& s : r.Strings())
+      {
+         b << sep << '"';
+         detail::print_zone_escaped(b, detail::zone_quoted_chars, s.data(), s.size());
+         b << '"';
+
+         sep = " ";
+      }
+   }
+
+   inline void print_zone_to(util::text_buffer_t& b, const rec_raw_t& r)
+   {
+      b << "\\# " << r.Bytes().size();
+
+      if(!r.Bytes().empty())
+      {
+         b << ' ';
+         detail::print_zone_hex(b, r.Bytes());
+      }
+   }
+
+   /////////////////////////////////////////////////////
+
+   // "<owner> <ttl> <class> <type> <rdata>", tab separated, with the line end
+   inline void print_zone_to(util::text_buffer_t& b, const answer_t& r)
+   {
+      print_zone_to(b, r.Name());
+      b << '\t' << static_cast<uint32_t>(r.TTL()) << '\t';
+      print_zone_to(b, r.Class());
+      b << '\t';
+      print_zone_to(b, r.Type());
+      b << '\t';
+
+      r.Visit([&b](auto&& rec)
+      {
+         print_zone_to(b, rec);
+      });
+
+      b << '\n';
+   }
+
+   // commented out, as dig does
+   inline void print_zone_to(util::text_buffer_t& b, const question_t& q)
+   {
+      b << ';';
+      print_zone_to(b, q.Name());
+      b << "\t\t";
+      print_zone_to(b, q.Class());
+      b << '\t';
+      print_zone_to(b, q.Type());
+      b << '\n';
+   }
+
+   /*
+    * The header as comments, then every non-empty section under its own heading - the
+    * layout dig uses.
+    */
+   inline void print_zone_to(util::text_buffer_t& b, const message_t& m)
+   {
+      auto&& h = m.Header();
+
+      b << ";; ->>HEADER<<- opcode: ";
+      detail::print_zone_mnemonic(b, mnemonic(h.OpCode()), false);
+      b << ", status: ";
+      detail::print_zone_mnemonic(b, mnemonic(h.RCode()), false);
+      b << ", id: " << h.ID() << '\n';
+
+      b << ";; flags:";
+      {
+         const struct
+         {
+            bool set;
+            const char* name;
+         }
+         flags[] =
+         {
+            { h.QR_Flag(), " qr" },
+            { h.AA_Flag(), " aa" },
+            { h.TC_Flag(), " tc" },
+            { h.RD_Flag(), " rd" },
+            { h.RA_Flag(), " ra" },
+            { h.AD_Flag(), " ad" },
+            { h.CD_Flag(), " cd" },
+         };
+
+         for(auto&& f : flags)
+            if(f.set)
+               b << f.name;
+      }
+      b << "; QUERY: " << h.QdCount() << ", ANSWER: " << h.AnCount() << ", AUTHORITY: " << h.NsCount() << ", ADDITIONAL: " << h.ArCount() << '\n';
+
+      b << "\n;; QUESTION SECTION:\n";
+      for(auto&& q : m.Questions())
+         print_zone_to(b, q);
+
+      auto&& print_section = [&b](const char* heading, auto&& section)
+      {
+         if(section.empty())
+            return;
+
+         b << heading;
+
+         for(auto&& r : section)
+            print_zone_to(b, r);
+      };
+
+      print_section("\n;; ANSWER SECTION:\n", m.Answers());
+      print_section("\n;; AUTHORITY SECTION:\n", m.Authorities());
+      print_section("\n;; ADDITIONAL SECTION:\n", m.Additionals());
+   }
+}
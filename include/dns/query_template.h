@@ -0,0 +1,100 @@
+#pragma once
+
+#include "dns/header.h"
+#include "dns/dname.h"
+#include "dns/rr_type.h"
+#include "dns/rr_class.h"
+
+#include "dns/detail/name_offset_tracker.h"
+#include "dns/detail/byte_order.h"
+#include "dns/exception/bad_buffer_size.h"
+
+#include <cstring>
+#include <vector>
+
+namespace dns
+{
+   /*
+    * A single question query for a fixed (qtype, qclass, header flags), encoded once, so
+    * that each query made from it only copies in its ID and the name:
+    *
+    *    auto&& tmpl = dns::query_template_t{dns::rr_type_t::rec_mx};
+    *
+    *    for(auto&& name : names)
+    *       tmpl.encode_to(next_id(), name, buffer);
+    */
+   class query_template_t
+   {
+      public:
+         static constexpr std::size_t max_size = detail::header_size + dname_t::max_size + 4;
+
+         /*
+          * All of 'flags' but the ID and the section counts is used.
+          */
+         explicit query_template_t(rr_type_t qtype, rr_class_t qclass = rr_class_t::internet, header_t flags = query_flags())
+         {
+            flags.ID(0);
+            flags.QdCount(1);
+            flags.AnCount(0);
+            flags.NsCount(0);
+            flags.ArCount(0);
+
+            auto&& tr = name_offset_tracker_t::write_to(m_head, sizeof(m_head));
+
+            save_to(tr, flags);
+
+            detail::store_be16(m_tail + 0, static_cast<uint16_t>(qtype));
+            detail::store_be16(m_tail + 2, static_cast<uint16_t>(qclass));
+         }
+
+         // the flags make_query uses: recursion desired, authentic data
+         static header_t query_flags()
+         {
+            header_t h{};
+
+            h.RD_Flag(true);
+            h.AD_Flag(true);
+
+            return h;
+         }
+
+         std::size_t encoded_size(const dname_t& qname) const
+         {
+            return sizeof(m_head) + qname.WireSize() + sizeof(m_tail);
+         }
+
+         /*
+          * Writes the query into [out, out + capacity), returning its size; throws
+          * exception::bad_buffer_size, writing nothing, if it does not fit.
+          */
+         std::size_t encode_to(uint16_t id, const dname_t& qname, uint8_t* out, std::size_t capacity) const
+         {
+            auto&& sz = encoded_size(qname);
+
+            if(sz > capacity)
+               throw exception::bad_buffer_size("buffer too small", 1);
+
+            std::memcpy(out, m_head, sizeof(m_head));
+            detail::store_be16(out, id);
+
+            std::memcpy(out + sizeof(m_head), qname.WireData(), qname.WireSize());
+            std::memcpy(out + sizeof(m_head) + qname.WireSize(), m_tail, sizeof(m_tail));
+
+            return sz;
+         }
+
+         // appends the query to 'out'
+         void encode_to(uint16_t id, const dname_t& qname, std::vector<uint8_t>& out) const
+         {
+            auto&& pos = out.size();
+
+            out.resize(pos + encoded_size(qname));
+
+            encode_to(id, qname, out.data() + pos, out.size() - pos);
+         }
+
+      private:
+         uint8_t m_head[detail::header_size];
+         uint8_t m_tail[4];
+   };
+}
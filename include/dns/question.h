@@ -5,21 +5,20 @@
 
 #include "dns/rr_type.h"
 #include "dns/rr_class.h"
-#include "dns/detail/label_list.h"
-#include "dns/detail/label_list/save_to.h"
-#include "dns/detail/label_list/load_from.h"
+#include "dns/dname.h"
+#include "util/text_buffer.h"
 
 namespace dns
 {
    class question_t
    {
       public:
-         void Name(const std::string& qname)
+         void Name(dname_t qname)
          {
-            m_qname = qname;
+            m_qname = std::move(qname);
          }
 
-         std::string Name() const
+         const dname_t& Name() const
          {
             return m_qname;
          }
@@ -46,18 +45,23 @@ namespace dns
 
          friend std::ostream& operator<<(std::ostream& os, const question_t& rhs)
          {
-            return os << "{ Name=" << rhs.Name() << ", Type=" << rhs.Type() << ", Class=" << rhs.Class() << " }";
+            return util::print(os, rhs);
          }
 
       private:
-         std::string m_qname;
+         dname_t m_qname;
          rr_type_t m_type = rr_type_t::rec_a;
          rr_class_t m_class = rr_class_t::internet;
    };
 
+   inline void print_to(util::text_buffer_t& b, const question_t& q)
+   {
+      b << "{ Name=" << q.Name() << ", Type=" << q.Type() << ", Class=" << q.Class() << " }";
+   }
+
    inline void save_to(name_offset_tracker_t& tr, const question_t& q)
    {
-      save_to(tr, label_list_t{q.Name()});
+      save_to(tr, q.Name());
       save_to(tr, static_cast<uint16_t>(q.Type()));
       save_to(tr, static_cast<uint16_t>(q.Class()));
    }
@@ -70,7 +74,7 @@ namespace dns
       {
          question_t q{};
 
-         q.Name(load_from<label_list_t>(tr, ii, end).Name());
+         q.Name(load_from<dname_t>(tr, ii, end));
          q.Type(static_cast<rr_type_t>(load_from<uint16_t>(tr, ii, end)));
          q.Class(static_cast<rr_class_t>(load_from<uint16_t>(tr, ii, end)));
 
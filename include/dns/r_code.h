@@ -1,6 +1,9 @@
 #pragma once
 
 #include <ostream>
+#include <string_view>
+
+#include "util/text_buffer.h"
 
 namespace dns
 {
@@ -34,50 +37,66 @@ namespace dns
       /* reserved = 65535, can be allocated by Standards Action, [RFC6895] */
    };
 
-   std::ostream& operator<<(std::ostream& os, r_code_t rhs)
+   // the mnemonic, empty for values without one
+   inline std::string_view mnemonic(r_code_t rhs)
    {
       switch(rhs)
       {
          case r_code_t::no_error:
-            return os << "no_error";
+            return "no_error";
          case r_code_t::form_err:
-            return os << "form_err";
+            return "form_err";
          case r_code_t::serv_fail:
-            return os << "serv_fail";
+            return "serv_fail";
          case r_code_t::nx_domain:
-            return os << "nx_domain";
+            return "nx_domain";
          case r_code_t::not_imp:
-            return os << "not_imp";
+            return "not_imp";
          case r_code_t::refused:
-            return os << "refused";
+            return "refused";
          case r_code_t::yx_domain:
-            return os << "yx_domain";
+            return "yx_domain";
          case r_code_t::yx_rrset:
-            return os << "yx_rrset";
+            return "yx_rrset";
          case r_code_t::nx_rrset:
-            return os << "nx_rrset";
+            return "nx_rrset";
          case r_code_t::not_auth:
-            return os << "not_auth";
+            return "not_auth";
          case r_code_t::not_zone:
-            return os << "not_zone";
+            return "not_zone";
          case r_code_t::bad_vers:
-            return os << "bad_vers|bad_sig";
+            return "bad_vers|bad_sig";
          case r_code_t::bad_key:
-            return os << "bad_key";
+            return "bad_key";
          case r_code_t::bad_time:
-            return os << "bad_time";
+            return "bad_time";
          case r_code_t::bad_mode:
-            return os << "bad_mode";
+            return "bad_mode";
          case r_code_t::bad_name:
-            return os << "bad_name";
+            return "bad_name";
          case r_code_t::bad_alg:
-            return os << "bad_alg";
+            return "bad_alg";
          case r_code_t::bad_trunc:
-            return os << "bad_trunc";
+            return "bad_trunc";
          case r_code_t::bad_cookie:
-            return os << "bad_cookie";
+            return "bad_cookie";
       }
 
-      return os << static_cast<unsigned>(rhs);
+      return {};
+   }
+
+   inline void print_to(util::text_buffer_t& b, r_code_t rhs)
+   {
+      auto&& name = mnemonic(rhs);
+
+      if(name.empty())
+         b << static_cast<unsigned>(rhs);
+      else
+         b << name;
+   }
+
+   inline std::ostream& operator<<(std::ostream& os, r_code_t rhs)
+   {
+      return util::print(os, rhs);
    }
 }
@@ -1,16 +1,21 @@
 #pragma once
 
-#include <boost/lexical_cast.hpp>
-
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <ostream>
 
+#include "dns/rr_type.h"
+#include "dns/detail/name_offset_tracker.h"
+#include "dns/detail/bin_serialize.h"
+#include "util/text_buffer.h"
+
 namespace dns
 {
    class rec_a_t
    {
       public:
-         explicit rec_a_t(const std::string& address)
+         explicit rec_a_t(std::string_view address)
          {
             DotAddress(address);
          }
@@ -37,39 +42,46 @@ namespace dns
 
          std::string DotAddress() const
          {
-            std::string result;
-            result.reserve(16);
-
-            result += boost::lexical_cast<std::string>( ( m_address >> 24 ) & 0xFF );
-            result += '.';                                                  
-            result += boost::lexical_cast<std::string>( ( m_address >> 16 ) & 0xFF );
-            result += '.';                                                  
-            result += boost::lexical_cast<std::string>( ( m_address >> 8  ) & 0xFF );
-            result += '.';                                                  
-            result += boost::lexical_cast<std::string>( ( m_address >> 0  ) & 0xFF );
-
-            return result;
+            thread_local util::text_buffer_t b;
+
+            b.clear();
+            b.append_ipv4(m_address);
+
+            return b.str();
          }
 
-         void DotAddress(const std::string& v)
+         // throws std::invalid_argument unless 'v' is four dot separated octets
+         void DotAddress(std::string_view v)
          {
             uint32_t result = 0;
-            std::string::size_type pos = 0;
-            for(int p = 3; p >= 0; p--)
+            std::size_t pos = 0;
+
+            for(auto p = 0; p < 4; ++p)
             {
-               auto dot_pos = v.find('.', pos);
-               result |= ( boost::lexical_cast<uint32_t>(v.substr(pos, dot_pos - pos)) << (p*8) );
-               if(dot_pos == v.npos)
-                  break;
-               pos = dot_pos + 1;
+               if(p > 0 && (pos == v.size() || v[pos++] != '.'))
+                  throw std::invalid_argument("bad dotted address");
+
+               std::size_t begin = pos;
+               uint32_t octet = 0;
+
+               for(; pos < v.size() && pos - begin < 3 && v[pos] >= '0' && v[pos] <= '9'; ++pos)
+                  octet = octet * 10 + (v[pos] - '0');
+
+               if(pos == begin || octet > 255)
+                  throw std::invalid_argument("bad dotted address");
+
+               result = (result << 8) | octet;
             }
 
+            if(pos != v.size())
+               throw std::invalid_argument("bad dotted address");
+
             m_address = result;
          }
 
          friend std::ostream& operator<<(std::ostream& os, const rec_a_t& rhs)
          {
-            return os << "[" << rhs.DotAddress() << "]";
+            return util::print(os, rhs);
          }
 
          friend bool operator==(const rec_a_t& lhs, const rec_a_t& rhs)
@@ -83,6 +95,13 @@ namespace dns
          uint32_t m_address;
    };
 
+   inline void print_to(util::text_buffer_t& b, const rec_a_t& r)
+   {
+      b << "[";
+      b.append_ipv4(r.Address());
+      b << "]";
+   }
+
    inline void save_to(name_offset_tracker_t& tr, const rec_a_t& r)
    {
       save_to(tr, r.Address());
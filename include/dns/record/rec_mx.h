@@ -3,16 +3,15 @@
 #include <ostream>
 #include <string>
 
-#include "dns/detail/label_list.h"
-#include "dns/detail/label_list/save_to.h"
-#include "dns/detail/label_list/load_from.h"
+#include "dns/dname.h"
+#include "util/text_buffer.h"
 
 namespace dns
 {
    class rec_mx_t
    {
       public:
-         explicit rec_mx_t(uint16_t preference, std::string exchange)
+         explicit rec_mx_t(uint16_t preference, dname_t exchange)
             : m_preference(preference)
             , m_exchange(std::move(exchange))
          {
@@ -33,19 +32,19 @@ namespace dns
             return m_preference;
          }
 
-         void Exchange(std::string v)
+         void Exchange(dname_t v)
          {
             m_exchange = std::move(v);
          }
 
-         const std::string& Exchange() const
+         const dname_t& Exchange() const
          {
             return m_exchange;
          }
 
          friend std::ostream& operator<<(std::ostream& os, const rec_mx_t& rhs)
          {
-            return os << "[preference=" << rhs.Preference() << ", exchange=" << rhs.Exchange() << "]";
+            return util::print(os, rhs);
          }
 
          friend bool operator==(const rec_mx_t& lhs, const rec_mx_t& rhs)
@@ -58,13 +57,18 @@ namespace dns
 
       private:
          uint16_t m_preference;
-         std::string m_exchange;
+         dname_t m_exchange;
    };
 
+   inline void print_to(util::text_buffer_t& b, const rec_mx_t& r)
+   {
+      b << "[preference=" << r.Preference() << ", exchange=" << r.Exchange() << "]";
+   }
+
    inline void save_to(name_offset_tracker_t& tr, const rec_mx_t& r)
    {
       save_to(tr, r.Preference());
-      save_to(tr, label_list_t{r.Exchange()});
+      save_to(tr, r.Exchange());
    }
 
    template<>
@@ -76,7 +80,7 @@ namespace dns
          rec_mx_t r{};
 
          r.Preference(load_from<uint16_t>(tr, ii, end));
-         r.Exchange(load_from<label_list_t>(tr, ii, end).Name());
+         r.Exchange(load_from<dname_t>(tr, ii, end));
 
          return r;
       }
@@ -3,16 +3,15 @@
 #include <ostream>
 #include <string>
 
-#include "dns/detail/label_list.h"
-#include "dns/detail/label_list/save_to.h"
-#include "dns/detail/label_list/load_from.h"
+#include "dns/dname.h"
+#include "util/text_buffer.h"
 
 namespace dns
 {
    class rec_ptr_t
    {
       public:
-         explicit rec_ptr_t(std::string name)
+         explicit rec_ptr_t(dname_t name)
             : m_name(std::move(name))
          {
          }
@@ -22,19 +21,19 @@ namespace dns
          {
          }
 
-         void Name(std::string v)
+         void Name(dname_t v)
          {
             m_name = std::move(v);
          }
 
-         const std::string& Name() const
+         const dname_t& Name() const
          {
             return m_name;
          }
 
          friend std::ostream& operator<<(std::ostream& os, const rec_ptr_t& rhs)
          {
-            return os << "[" << rhs.Name() << "]";
+            return util::print(os, rhs);
          }
 
          friend bool operator==(const rec_ptr_t& lhs, const rec_ptr_t& rhs)
@@ -45,12 +44,17 @@ namespace dns
          static const rr_type_t m_type = dns::rr_type_t::rec_ptr;
 
       private:
-         std::string m_name;
+         dname_t m_name;
    };
 
+   inline void print_to(util::text_buffer_t& b, const rec_ptr_t& r)
+   {
+      b << "[" << r.Name() << "]";
+   }
+
    inline void save_to(name_offset_tracker_t& tr, const rec_ptr_t& r)
    {
-      save_to(tr, label_list_t{r.Name()});
+      save_to(tr, r.Name());
    }
 
    template<>
@@ -61,7 +65,7 @@ namespace dns
       {
          rec_ptr_t r{};
 
-         r.Name(load_from<label_list_t>(tr, ii, end).Name());
+         r.Name(load_from<dname_t>(tr, ii, end));
 
          return r;
       }
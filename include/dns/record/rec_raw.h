@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory_resource>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "dns/detail/name_offset_tracker.h"
+#include "dns/detail/bin_serialize.h"
+
+#include "util/oct_dump.h"
+#include "util/text_buffer.h"
+
+namespace dns
+{
+   /*
+    * Rdata of a type with no decoder of its own, kept as the bytes found on the wire.
+    */
+   class rec_raw_t
+   {
+      public:
+         explicit rec_raw_t(std::string_view bytes, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : m_bytes(bytes, mr)
+         {
+         }
+
+         rec_raw_t()
+            : rec_raw_t{std::string_view{}}
+         {
+         }
+
+         void Bytes(std::string_view v)
+         {
+            m_bytes.assign(v.data(), v.size());
+         }
+
+         std::string_view Bytes() const
+         {
+            return m_bytes;
+         }
+
+         friend std::ostream& operator<<(std::ostream& os, const rec_raw_t& rhs)
+         {
+            return util::print(os, rhs);
+         }
+
+         friend bool operator==(const rec_raw_t& lhs, const rec_raw_t& rhs)
+         {
+            return lhs.Bytes() == rhs.Bytes();
+         }
+
+      private:
+         friend struct LoadImpl<rec_raw_t>;
+
+         std::pmr::string m_bytes;
+   };
+
+   inline void print_to(util::text_buffer_t& b, const rec_raw_t& r)
+   {
+      util::DumpOct(b, r.Bytes().begin(), r.Bytes().end());
+   }
+
+   inline void save_to(name_offset_tracker_t& tr, const rec_raw_t& r)
+   {
+      auto&& bytes = r.Bytes();
+
+      tr.save(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+   }
+
+   template<>
+   struct LoadImpl<rec_raw_t>
+   {
+      template<class InputIterator>
+      static rec_raw_t impl(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
+      {
+         rec_raw_t r{std::string_view{}, tr.resource()};
+
+         r.m_bytes.assign(ii, end);
+         ii = end;
+
+         tr.save(reinterpret_cast<const uint8_t*>(r.m_bytes.data()), r.m_bytes.size());
+
+         return r;
+      }
+   };
+}
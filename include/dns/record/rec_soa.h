@@ -3,17 +3,16 @@
 #include <ostream>
 #include <string>
 
-#include "dns/detail/label_list.h"
-#include "dns/detail/label_list/save_to.h"
-#include "dns/detail/label_list/load_from.h"
+#include "dns/dname.h"
+#include "util/text_buffer.h"
 
 namespace dns
 {
    class rec_soa_t
    {
       public:
-         rec_soa_t(std::string mname,
-                   std::string rname,
+         rec_soa_t(dname_t mname,
+                   dname_t rname,
                    uint32_t serial,
                    uint32_t refresh_interval,
                    uint32_t retry_interval,
@@ -35,22 +34,22 @@ namespace dns
          {
          }
 
-         void MName(std::string v)
+         void MName(dname_t v)
          {
             m_mname = std::move(v);
          }
 
-         const std::string& MName() const
+         const dname_t& MName() const
          {
             return m_mname;
          }
 
-         void RName(std::string v)
+         void RName(dname_t v)
          {
             m_rname = std::move(v);
          }
 
-         const std::string& RName() const
+         const dname_t& RName() const
          {
             return m_rname;
          }
@@ -107,14 +106,7 @@ namespace dns
 
          friend std::ostream& operator<<(std::ostream& os, const rec_soa_t& rhs)
          {
-            return os << "[mname=" << rhs.MName()
-                   << ", rname="   << rhs.RName()
-                   << ", serial="  << rhs.Serial()
-                   << ", refresh=" << rhs.RefreshInterval()
-                   << ", retry="   << rhs.RetryInterval()
-                   << ", expire="  << rhs.ExpireInterval()
-                   << ", minimum=" << rhs.MinimumTTL()
-                   << "]";
+            return util::print(os, rhs);
          }
 
          friend bool operator==(const rec_soa_t& lhs, const rec_soa_t& rhs)
@@ -131,8 +123,8 @@ namespace dns
          static const rr_type_t m_type = dns::rr_type_t::rec_soa;
 
       private:
-         std::string m_mname;
-         std::string m_rname;
+         dname_t m_mname;
+         dname_t m_rname;
          uint32_t m_serial = 0;
          uint32_t m_refresh_interval = 0;
          uint32_t m_retry_interval = 0;
@@ -140,10 +132,22 @@ namespace dns
          uint32_t m_minimum_ttl = 0;
    };
 
+   inline void print_to(util::text_buffer_t& b, const rec_soa_t& r)
+   {
+      b << "[mname=" << r.MName()
+        << ", rname="   << r.RName()
+        << ", serial="  << r.Serial()
+        << ", refresh=" << r.RefreshInterval()
+        << ", retry="   << r.RetryInterval()
+        << ", expire="  << r.ExpireInterval()
+        << ", minimum=" << r.MinimumTTL()
+        << "]";
+   }
+
    inline void save_to(name_offset_tracker_t& tr, const rec_soa_t& r)
    {
-      save_to(tr, label_list_t{r.MName()});
-      save_to(tr, label_list_t{r.RName()});
+      save_to(tr, r.MName());
+      save_to(tr, r.RName());
       save_to(tr, static_cast<uint32_t>(r.Serial()));
       save_to(tr, static_cast<uint32_t>(r.RefreshInterval()));
       save_to(tr, static_cast<uint32_t>(r.RetryInterval()));
@@ -159,8 +163,8 @@ namespace dns
       {
          rec_soa_t r{};
 
-         r.MName(load_from<label_list_t>(tr, ii, end).Name());
-         r.RName(load_from<label_list_t>(tr, ii, end).Name());
+         r.MName(load_from<dname_t>(tr, ii, end));
+         r.RName(load_from<dname_t>(tr, ii, end));
          r.Serial(load_from<uint32_t>(tr, ii, end));
          r.RefreshInterval(load_from<uint32_t>(tr, ii, end));
          r.RetryInterval(load_from<uint32_t>(tr, ii, end));
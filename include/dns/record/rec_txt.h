@@ -1,62 +1,240 @@
 #pragma once
 
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
 #include <ostream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+
+#include "dns/rr_type.h"
+#include "dns/detail/name_offset_tracker.h"
+#include "dns/detail/bin_serialize.h"
+#include "dns/exception/bad_data_stream.h"
+
+#include "util/text_buffer.h"
 
 namespace dns
 {
+   /*
+    * Character strings as they are on the wire - each a length octet followed by that
+    * many bytes - iterated as (offset, length) views into the bytes, without a copy.
+    * Works as well over a record's own storage as straight over a received message.
+    */
+   class character_strings_t
+   {
+      public:
+         class iterator
+         {
+            public:
+               using iterator_category = std::forward_iterator_tag;
+               using value_type = std::string_view;
+               using difference_type = std::ptrdiff_t;
+               using pointer = const std::string_view*;
+               using reference = std::string_view;
+
+               iterator() = default;
+
+               explicit iterator(const uint8_t* p)
+                  : m_p(p)
+               {
+               }
+
+               std::string_view operator*() const
+               {
+                  return std::string_view{reinterpret_cast<const char*>(m_p + 1), m_p[0]};
+               }
+
+               iterator& operator++()
+               {
+                  m_p += 1 + m_p[0];
+                  return *this;
+               }
+
+               iterator operator++(int)
+               {
+                  iterator prev = *this;
+                  ++*this;
+                  return prev;
+               }
+
+               friend bool operator==(const iterator& lhs, const iterator& rhs)
+               {
+                  return lhs.m_p == rhs.m_p;
+               }
+
+               friend bool operator!=(const iterator& lhs, const iterator& rhs)
+               {
+                  return !(lhs == rhs);
+               }
+
+            private:
+               const uint8_t* m_p = nullptr;
+         };
+
+         character_strings_t() = default;
+
+         /*
+          * [p, p + size) must hold whole character strings, see valid().
+          */
+         character_strings_t(const uint8_t* p, std::size_t size)
+            : m_p(p)
+            , m_size(size)
+         {
+         }
+
+         // true if [p, p + size) splits into whole character strings
+         static bool valid(const uint8_t* p, std::size_t size)
+         {
+            std::size_t pos = 0;
+
+            while(pos < size)
+               pos += 1 + p[pos];
+
+            return pos == size;
+         }
+
+         iterator begin() const
+         {
+            return iterator{m_p};
+         }
+
+         iterator end() const
+         {
+            return iterator{m_p + m_size};
+         }
+
+         bool empty() const
+         {
+            return m_size == 0;
+         }
+
+         // the strings concatenated would be this long
+         std::size_t text_size() const
+         {
+            std::size_t n = 0;
+
+            for(auto&& s : *this)
+               n += s.size();
+
+            return n;
+         }
+
+      private:
+         const uint8_t* m_p = nullptr;
+         std::size_t m_size = 0;
+   };
+
+   /*
+    * TXT rdata, stored as received: the character strings, length octets and all, in one
+    * buffer. Decoding and encoding are a single copy each and keep the strings as they
+    * were; the strings joined are only put together by Text() or AppendText().
+    */
    class rec_txt_t
    {
       public:
-         rec_txt_t(std::string text)
-            : m_text(std::move(text))
+         // 'text' as a single string if it fits, else cut every 255 bytes
+         rec_txt_t(std::string_view text, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : m_wire(mr)
+         {
+            Text(text);
+         }
+
+         rec_txt_t(const char* text)
+            : rec_txt_t{std::string_view{text}}
          {
          }
 
          rec_txt_t()
-            : rec_txt_t{{}}
+            : rec_txt_t{std::string_view{}}
          {
          }
 
-         void Text(std::string v)
+         void Text(std::string_view v)
          {
-            m_text = std::move(v);
+            m_wire.clear();
+            m_wire.reserve(v.size() + (v.size() + 254) / 255);
+
+            for(std::size_t pos = 0; pos < v.size(); pos += 255)
+               AddString(v.substr(pos, 255));
          }
 
+         // the strings joined
          std::string Text() const
          {
-            return m_text;
+            std::string text;
+
+            AppendText(text);
+
+            return text;
+         }
+
+         // the strings joined onto the end of 'out', e.g. a buffer reused across records
+         void AppendText(std::string& out) const
+         {
+            out.reserve(out.size() + Strings().text_size());
+
+            for(auto&& s : Strings())
+               out.append(s.data(), s.size());
+         }
+
+         /*
+          * Appends one character string; throws std::length_error past 255 bytes.
+          */
+         void AddString(std::string_view s)
+         {
+            if(s.size() > 255)
+               throw std::length_error("character string too long");
+
+            m_wire.push_back(static_cast<char>(s.size()));
+            m_wire.append(s.data(), s.size());
+         }
+
+         character_strings_t Strings() const
+         {
+            return character_strings_t{reinterpret_cast<const uint8_t*>(m_wire.data()), m_wire.size()};
+         }
+
+         // the rdata as on the wire
+         std::string_view Wire() const
+         {
+            return m_wire;
          }
 
          friend std::ostream& operator<<(std::ostream& os, const rec_txt_t& rhs)
          {
-            return os << "[" << rhs.Text() << "]";
+            return util::print(os, rhs);
          }
 
          friend bool operator==(const rec_txt_t& lhs, const rec_txt_t& rhs)
          {
-            return lhs.Text() == rhs.Text();
+            return lhs.Wire() == rhs.Wire();
          }
 
          static const rr_type_t m_type = dns::rr_type_t::rec_txt;
 
       private:
-         std::string m_text;
+         friend struct LoadImpl<rec_txt_t>;
+
+         std::pmr::string m_wire;
    };
 
-   inline void save_to(name_offset_tracker_t& tr, const rec_txt_t& r)
+   inline void print_to(util::text_buffer_t& b, const rec_txt_t& r)
    {
-      auto&& text = r.Text();
-      auto&& begin = text.cbegin();
-      auto&& end = text.cend();
+      b << "[";
 
-      while( auto&& sz = static_cast<uint8_t>((end - begin > 255) ? 255 : (end - begin)) )
-      {
-         save_to(tr, static_cast<uint8_t>(sz));
+      for(auto&& s : r.Strings())
+         b << s;
 
-         for(; sz > 0; ++begin, --sz)
-            save_to(tr, static_cast<uint8_t>(*begin));
-      }
+      b << "]";
+   }
+
+   inline void save_to(name_offset_tracker_t& tr, const rec_txt_t& r)
+   {
+      auto&& wire = r.Wire();
+
+      tr.save(reinterpret_cast<const uint8_t*>(wire.data()), wire.size());
    }
 
    template<>
@@ -65,20 +243,26 @@ namespace dns
       template<class InputIterator>
       static rec_txt_t impl(name_offset_tracker_t& tr, InputIterator& ii, InputIterator end)
       {
-         rec_txt_t r{};
-
-         std::string buff;
+         rec_txt_t r{std::string_view{}, tr.resource()};
 
-         while( ii != end )
+         if constexpr(detail::is_contiguous_byte_iterator<InputIterator>::value)
          {
-            uint8_t sz = load_from<uint8_t>(tr, ii, end);
-            buff.reserve( buff.size() + sz );
-
-            for(uint8_t i = 0; i < sz; ++i)
-               buff.push_back( load_from<uint8_t>(tr, ii, end) );
+            if(ii != end)
+               r.m_wire.assign(reinterpret_cast<const char*>(detail::byte_pointer(ii)), end - ii);
          }
+         else
+         {
+            r.m_wire.assign(ii, end);
+         }
+
+         auto&& p = reinterpret_cast<const uint8_t*>(r.m_wire.data());
+
+         if(!character_strings_t::valid(p, r.m_wire.size()))
+            throw dns::exception::bad_data_stream("truncated", 1);
+
+         ii = end;
 
-         r.Text(buff);
+         tr.save(p, r.m_wire.size());
 
          return r;
       }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <ostream>
+#include <string_view>
+
+#include "util/text_buffer.h"
 
 namespace dns
 {
@@ -21,24 +24,40 @@ namespace dns
 
    };
 
-   std::ostream& operator<<(std::ostream& os, rr_class_t rhs)
+   // the mnemonic, empty for values without one
+   inline std::string_view mnemonic(rr_class_t rhs)
    {
       switch(rhs)
       {
          case rr_class_t::reserved:
-            return os << "reserved";
+            return "reserved";
          case rr_class_t::internet:
-            return os << "internet";
+            return "internet";
          case rr_class_t::chaos:
-            return os << "chaos";
+            return "chaos";
          case rr_class_t::hesiod:
-            return os << "hesiod";
+            return "hesiod";
          case rr_class_t::none:
-            return os << "none";
+            return "none";
          case rr_class_t::any:
-            return os << "any";
+            return "any";
       }
 
-      return os << static_cast<unsigned>(rhs);
+      return {};
+   }
+
+   inline void print_to(util::text_buffer_t& b, rr_class_t rhs)
+   {
+      auto&& name = mnemonic(rhs);
+
+      if(name.empty())
+         b << static_cast<unsigned>(rhs);
+      else
+         b << name;
+   }
+
+   inline std::ostream& operator<<(std::ostream& os, rr_class_t rhs)
+   {
+      return util::print(os, rhs);
    }
 }
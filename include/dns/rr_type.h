@@ -1,6 +1,9 @@
 #pragma once
 
 #include <ostream>
+#include <string_view>
+
+#include "util/text_buffer.h"
 
 namespace dns
 {
@@ -100,180 +103,196 @@ namespace dns
       /* reserved = 65535, */
    };
 
-   std::ostream& operator<<(std::ostream& os, rr_type_t rhs)
+   // the mnemonic, empty for values without one
+   inline std::string_view mnemonic(rr_type_t rhs)
    {
       switch(rhs)
       {
          case rr_type_t::rec_a:
-            return os << "a";
+            return "a";
          case rr_type_t::rec_ns:
-            return os << "ns";
+            return "ns";
          case rr_type_t::rec_md:
-            return os << "md";
+            return "md";
          case rr_type_t::rec_mf:
-            return os << "mf";
+            return "mf";
          case rr_type_t::rec_cname:
-            return os << "cname";
+            return "cname";
          case rr_type_t::rec_soa:
-            return os << "soa";
+            return "soa";
          case rr_type_t::rec_mb:
-            return os << "mb";
+            return "mb";
          case rr_type_t::rec_mg:
-            return os << "mg";
+            return "mg";
          case rr_type_t::rec_mr:
-            return os << "mr";
+            return "mr";
          case rr_type_t::rec_null:
-            return os << "null";
+            return "null";
          case rr_type_t::rec_wks:
-            return os << "wks";
+            return "wks";
          case rr_type_t::rec_ptr:
-            return os << "ptr";
+            return "ptr";
          case rr_type_t::rec_hinfo:
-            return os << "hinfo";
+            return "hinfo";
          case rr_type_t::rec_minfo:
-            return os << "minfo";
+            return "minfo";
          case rr_type_t::rec_mx:
-            return os << "mx";
+            return "mx";
          case rr_type_t::rec_txt:
-            return os << "txt";
+            return "txt";
          case rr_type_t::rec_rp:
-            return os << "rp";
+            return "rp";
          case rr_type_t::rec_afsdb:
-            return os << "afsdb";
+            return "afsdb";
          case rr_type_t::rec_x25:
-            return os << "x25";
+            return "x25";
          case rr_type_t::rec_isdn:
-            return os << "isdn";
+            return "isdn";
          case rr_type_t::rec_rt:
-            return os << "rt";
+            return "rt";
          case rr_type_t::rec_nsap:
-            return os << "nsap";
+            return "nsap";
          case rr_type_t::rec_nsap_ptr:
-            return os << "nsap_ptr";
+            return "nsap_ptr";
          case rr_type_t::rec_sig:
-            return os << "sig";
+            return "sig";
          case rr_type_t::rec_key:
-            return os << "key";
+            return "key";
          case rr_type_t::rec_px:
-            return os << "px";
+            return "px";
          case rr_type_t::rec_gpos:
-            return os << "gpos";
+            return "gpos";
          case rr_type_t::rec_aaaa:
-            return os << "aaaa";
+            return "aaaa";
          case rr_type_t::rec_loc:
-            return os << "loc";
+            return "loc";
          case rr_type_t::rec_nxt:
-            return os << "nxt";
+            return "nxt";
          case rr_type_t::rec_eid:
-            return os << "eid";
+            return "eid";
          case rr_type_t::rec_nimloc:
-            return os << "nimloc";
+            return "nimloc";
          case rr_type_t::rec_srv:
-            return os << "srv";
+            return "srv";
          case rr_type_t::rec_atma:
-            return os << "atma";
+            return "atma";
          case rr_type_t::rec_naptr:
-            return os << "naptr";
+            return "naptr";
          case rr_type_t::rec_kx:
-            return os << "kx";
+            return "kx";
          case rr_type_t::rec_cert:
-            return os << "cert";
+            return "cert";
          case rr_type_t::rec_a6:
-            return os << "a6";
+            return "a6";
          case rr_type_t::rec_dname:
-            return os << "dname";
+            return "dname";
          case rr_type_t::rec_sink:
-            return os << "sink";
+            return "sink";
          case rr_type_t::rec_opt:
-            return os << "opt";
+            return "opt";
          case rr_type_t::rec_apl:
-            return os << "apl";
+            return "apl";
          case rr_type_t::rec_ds:
-            return os << "ds";
+            return "ds";
          case rr_type_t::rec_sshfp:
-            return os << "sshfp";
+            return "sshfp";
          case rr_type_t::rec_ipseckey:
-            return os << "ipseckey";
+            return "ipseckey";
          case rr_type_t::rec_rrsig:
-            return os << "rrsig";
+            return "rrsig";
          case rr_type_t::rec_nsec:
-            return os << "nsec";
+            return "nsec";
          case rr_type_t::rec_dnskey:
-            return os << "dnskey";
+            return "dnskey";
          case rr_type_t::rec_dhcid:
-            return os << "dhcid";
+            return "dhcid";
          case rr_type_t::rec_nsec3:
-            return os << "nsec3";
+            return "nsec3";
          case rr_type_t::rec_nsec3param:
-            return os << "nsec3param";
+            return "nsec3param";
          case rr_type_t::rec_tlsa:
-            return os << "tlsa";
+            return "tlsa";
          case rr_type_t::rec_smimea:
-            return os << "smimea";
+            return "smimea";
          case rr_type_t::rec_hip:
-            return os << "hip";
+            return "hip";
          case rr_type_t::rec_ninfo:
-            return os << "ninfo";
+            return "ninfo";
          case rr_type_t::rec_rkey:
-            return os << "rkey";
+            return "rkey";
          case rr_type_t::rec_talink:
-            return os << "talink";
+            return "talink";
          case rr_type_t::rec_cds:
-            return os << "cds";
+            return "cds";
          case rr_type_t::rec_cdnskey:
-            return os << "cdnskey";
+            return "cdnskey";
          case rr_type_t::rec_openpgpkey:
-            return os << "openpgpkey";
+            return "openpgpkey";
          case rr_type_t::rec_csync:
-            return os << "csync";
+            return "csync";
          case rr_type_t::rec_spf:
-            return os << "spf";
+            return "spf";
          case rr_type_t::rec_uinfo:
-            return os << "uinfo";
+            return "uinfo";
          case rr_type_t::rec_uid:
-            return os << "uid";
+            return "uid";
          case rr_type_t::rec_gid:
-            return os << "gid";
+            return "gid";
          case rr_type_t::rec_unspec:
-            return os << "unspec";
+            return "unspec";
          case rr_type_t::rec_nid:
-            return os << "nid";
+            return "nid";
          case rr_type_t::rec_l32:
-            return os << "l32";
+            return "l32";
          case rr_type_t::rec_l64:
-            return os << "l64";
+            return "l64";
          case rr_type_t::rec_lp:
-            return os << "lp";
+            return "lp";
          case rr_type_t::rec_eui48:
-            return os << "eui48";
+            return "eui48";
          case rr_type_t::rec_eui64:
-            return os << "eui64";
+            return "eui64";
          case rr_type_t::rec_tkey:
-            return os << "tkey";
+            return "tkey";
          case rr_type_t::rec_tsig:
-            return os << "tsig";
+            return "tsig";
          case rr_type_t::rec_ixfr:
-            return os << "ixfr";
+            return "ixfr";
          case rr_type_t::rec_axfr:
-            return os << "axfr";
+            return "axfr";
          case rr_type_t::rec_mailb:
-            return os << "mailb";
+            return "mailb";
          case rr_type_t::rec_maila:
-            return os << "maila";
+            return "maila";
          case rr_type_t::rec_any:
-            return os << "any";
+            return "any";
          case rr_type_t::rec_uri:
-            return os << "uri";
+            return "uri";
          case rr_type_t::rec_caa:
-            return os << "caa";
+            return "caa";
          case rr_type_t::rec_avc:
-            return os << "avc";
+            return "avc";
          case rr_type_t::rec_ta:
-            return os << "ta";
+            return "ta";
          case rr_type_t::rec_dlv:
-            return os << "dlv";
+            return "dlv";
       }
 
-      return os << static_cast<unsigned>(rhs);
+      return {};
+   }
+
+   inline void print_to(util::text_buffer_t& b, rr_type_t rhs)
+   {
+      auto&& name = mnemonic(rhs);
+
+      if(name.empty())
+         b << static_cast<unsigned>(rhs);
+      else
+         b << name;
+   }
+
+   inline std::ostream& operator<<(std::ostream& os, rr_type_t rhs)
+   {
+      return util::print(os, rhs);
    }
 }
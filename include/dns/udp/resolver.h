@@ -1,6 +1,9 @@
 #pragma once
 
 #include "dns/message.h"
+#include "dns/query_template.h"
+#include "dns/message_view.h"
+#include "dns/detail/response_callback.h"
 
 #include <boost/asio.hpp>
 #include <list>
@@ -16,10 +19,32 @@ namespace dns::udp
          {
          }
 
+         /*
+          * Sends 'query' under an ID not used by any other query in flight - the ID set in
+          * its header is not the one sent.
+          */
          template<class F>
          void async_resolve(const message_t& query, F callback)
          {
-            m_active_queries.push_back( std::make_unique<query_handler<F>>( query, std::move(callback) ) );
+            async_resolve_queued( std::make_unique<query_handler<F>>( std::move(callback), query, m_query_ids.next() ) );
+         }
+
+         /*
+          * Queries 'qname' with an ID not used by any other query in flight, the rest
+          * coming from the pre-encoded 'query'.
+          */
+         template<class F>
+         void async_resolve(const query_template_t& query, const dname_t& qname, F callback)
+         {
+            async_resolve_queued( std::make_unique<query_handler<F>>( std::move(callback), query, qname, m_query_ids.next() ) );
+         }
+
+
+      private:
+         template<class HandlerT>
+         void async_resolve_queued(std::unique_ptr<HandlerT> handler)
+         {
+            m_active_queries.push_back( std::move(handler) );
 
             if(!m_connect_initiated)
             {
@@ -30,7 +55,7 @@ namespace dns::udp
 
                if(ec)
                {
-                  this->invoke_callback_resolve_next(ec, message_t{});
+                  this->invoke_callback_resolve_next(ec, message_view_t{});
                }
                else
                {
@@ -39,15 +64,14 @@ namespace dns::udp
             }
          }
 
-
-      private:
-         template<class EC, class MSG>
-         void invoke_callback_resolve_next(const EC& ec, const MSG& m)
+         template<class EC>
+         void invoke_callback_resolve_next(const EC& ec, const message_view_t& m)
          {
             if(!m_active_queries.empty())
             {
-               m_active_queries.front()->invoke_callback(ec, m);
-               
+               m_active_queries.front()->invoke_callback(ec, m, m_messages);
+
+               m_query_ids.release(m_active_queries.front()->m_id);
                m_active_queries.pop_front();
 
                this->async_resolve_next();
@@ -58,32 +82,17 @@ namespace dns::udp
          {
             if(!m_active_queries.empty())
             {
-               auto&& onReadResponse = [this](auto ec, auto sz_rx)
-               {
-                  if(sz_rx <= 0 && !ec)
-                  {
-                     this->invoke_callback_resolve_next(ec, message_t{});
-                  }
-                  else
-                  {
-                     dns::message_t response;
-                     response.load_from(m_active_queries.front()->m_buffer.begin(), m_active_queries.front()->m_buffer.end());
-
-                     this->invoke_callback_resolve_next(ec, response);
-                  }
-               };
-
-               auto&& onWriteQuery = [this, onReadResponse](auto ec, auto sz_tx)
+               auto&& onWriteQuery = [this](auto ec, auto sz_tx)
                {
                   if(ec)
                   {
-                     this->invoke_callback_resolve_next(ec, message_t{});
+                     this->invoke_callback_resolve_next(ec, message_view_t{});
                   }
                   else
                   {
                      m_active_queries.front()->m_buffer.resize(65535);
 
-                     m_socket.async_receive_from(boost::asio::buffer(m_active_queries.front()->m_buffer), m_endpoint, onReadResponse);
+                     this->async_receive_response();
                   }
                };
 
@@ -92,21 +101,63 @@ namespace dns::udp
             }
          }
 
+         /*
+          * Datagrams too short for a header or carrying another ID (late answers to earlier
+          * queries, or spoofed ones) are dropped, and the wait goes on.
+          */
+         void async_receive_response()
+         {
+            auto&& onReadResponse = [this](auto ec, auto sz_rx)
+            {
+               auto&& query = *m_active_queries.front();
+
+               if(ec || sz_rx <= 0)
+               {
+                  this->invoke_callback_resolve_next(ec, message_view_t{});
+               }
+               else if(sz_rx < detail::header_size || detail::peek_id(query.m_buffer.data()) != query.m_id)
+               {
+                  this->async_receive_response();
+               }
+               else
+               {
+                  auto&& response = detail::response_view(query.m_buffer.data(), sz_rx, ec);
+
+                  this->invoke_callback_resolve_next(ec, response);
+               }
+            };
+
+            m_socket.async_receive_from(boost::asio::buffer(m_active_queries.front()->m_buffer), m_endpoint, onReadResponse);
+         }
+
       private:
          boost::asio::ip::udp::socket m_socket;
          boost::asio::ip::udp::endpoint m_endpoint;
 
          bool m_connect_initiated = false;
 
+         detail::query_id_generator_t m_query_ids;
+
+         // what message_t callbacks get the response decoded into
+         detail::message_pool_t m_messages;
+
          struct query_handler_base
          {
-            query_handler_base(const message_t& query)
+            query_handler_base(const message_t& query, uint16_t id)
+               : m_id(id)
+            {
+               query.save_to(m_buffer);
+               detail::store_be16(m_buffer.data(), id);
+            }
+
+            query_handler_base(const query_template_t& query, const dname_t& qname, uint16_t id)
+               : m_id(id)
             {
-               query.save_to(std::back_inserter(m_buffer));
+               query.encode_to(id, qname, m_buffer);
             }
 
          public:
-            virtual void invoke_callback( const boost::system::error_code&, const dns::message_t& ) = 0;
+            virtual void invoke_callback( const boost::system::error_code&, const dns::message_view_t&, detail::message_pool_t& ) = 0;
             virtual ~query_handler_base() = default;
 
             query_handler_base() = default;
@@ -116,21 +167,23 @@ namespace dns::udp
             query_handler_base& operator=(query_handler_base&&) = default;
            
          public:
+            uint16_t m_id = 0;
             std::vector<uint8_t> m_buffer;
          };
 
          template<class F>
          struct query_handler : query_handler_base
          {
-            query_handler(const message_t& query, F callback)
-               : query_handler_base(query)
+            template<class... QueryT>
+            query_handler(F callback, const QueryT& ... query)
+               : query_handler_base(query...)
                , m_callback( std::move(callback) )
             {
             }
 
-            virtual void invoke_callback( const boost::system::error_code& ec, const dns::message_t& msg) final override
+            virtual void invoke_callback( const boost::system::error_code& ec, const dns::message_view_t& msg, detail::message_pool_t& messages) final override
             {
-               m_callback(ec, msg);
+               detail::invoke_response_callback(m_callback, ec, msg, messages);
             }
 
             F m_callback;
@@ -3,6 +3,9 @@
 #include "TypeList.h"
 #include "TypeMap.h"
 
+#include <array>
+#include <cstdint>
+#include <type_traits>
 #include <utility>
 
 namespace util
@@ -11,23 +14,26 @@ namespace util
 
    namespace detail
    {
+      template<typename LeftTypeMapT, typename RightTypeMapT>
+      struct TypeMapTLessComparator
+      {
+         constexpr static auto value = static_cast<int64_t>(ExtractKey_v<LeftTypeMapT>) < static_cast<int64_t>(ExtractKey_v<RightTypeMapT>);
+      };
+
+      /*
+       * Binary search over the sorted keys, unrolled at compile time.
+       */
       template<typename TypeMapListT>
-      struct TypeMapListSwitch
+      struct TypeMapListTreeSwitch
       {
          private:
-            template<typename LeftTypeMapT, typename RightTypeMapT>
-            struct TypeMapTLessComparator
-            {
-               constexpr static auto value = static_cast<int64_t>(ExtractKey_v<LeftTypeMapT>) < static_cast<int64_t>(ExtractKey_v<RightTypeMapT>);
-            };
-
             using SortedTypeMapListT = Sort_t<TypeMapListT, TypeMapTLessComparator>;
 
             constexpr static auto mid_pos = Size_v<SortedTypeMapListT> / 2;
 
             using TypeMapT = Access_t<SortedTypeMapListT, mid_pos>;
-            using LeftTypeMapListSwitchT  = TypeMapListSwitch< Slice_t<SortedTypeMapListT, 0, mid_pos> >;
-            using RightTypeMapListSwitchT = TypeMapListSwitch < Slice_t < SortedTypeMapListT, mid_pos + 1 > >;
+            using LeftTypeMapListSwitchT  = TypeMapListTreeSwitch< Slice_t<SortedTypeMapListT, 0, mid_pos> >;
+            using RightTypeMapListSwitchT = TypeMapListTreeSwitch < Slice_t < SortedTypeMapListT, mid_pos + 1 > >;
 
          public:
             template<template<typename> typename WorkFuncT, typename KeyT, typename... Args>
@@ -51,7 +57,7 @@ namespace util
       };
 
       template<>
-      struct TypeMapListSwitch< TypeList<> >
+      struct TypeMapListTreeSwitch< TypeList<> >
       {
          public:
             template<template<typename> typename WorkFuncT, typename KeyT, typename... Args>
@@ -64,11 +70,120 @@ namespace util
       };
    }
 
+   ////////////////////////////////////////////////////////
+
+   namespace detail
+   {
+      template<typename TypeMapListT>
+      struct TypeMapListTableSwitch;
+
+      /*
+       * The type mapped to 'Key', the first one if mapped more than once, void if none.
+       */
+      template<int64_t Key, typename... TypeMapT>
+      struct TypeMapFind
+      {
+         using type = void;
+      };
+
+      template<int64_t Key, typename TypeMapT, typename... RestT>
+      struct TypeMapFind<Key, TypeMapT, RestT...>
+      {
+         using type = std::conditional_t < static_cast<int64_t>(ExtractKey_v<TypeMapT>) == Key, ExtractType_t<TypeMapT>, typename TypeMapFind<Key, RestT...>::type >;
+      };
+
+      /*
+       * An array of 'span' handlers, one per key from min_key to max_key (the default one
+       * where no key is mapped), indexed by key - min_key. Keys outside it get the default.
+       */
+      template<typename... TypeMapT>
+      struct TypeMapListTableSwitch< TypeList<TypeMapT...> >
+      {
+         private:
+            using SortedTypeMapListT = Sort_t<TypeList<TypeMapT...>, TypeMapTLessComparator>;
+
+         public:
+            constexpr static int64_t min_key = static_cast<int64_t>(ExtractKey_v< Front_t<SortedTypeMapListT> >);
+            constexpr static int64_t max_key = static_cast<int64_t>(ExtractKey_v< Access_t<SortedTypeMapListT, Size_v<SortedTypeMapListT> - 1> >);
+            constexpr static std::size_t span = static_cast<std::size_t>(max_key - min_key) + 1;
+
+         private:
+            template<template<typename> typename WorkFuncT, typename... Args>
+            struct Table
+            {
+               using handler_t = void (*)(Args&& ...);
+
+               template<typename TypeT>
+               static void invoke(Args&& ... args)
+               {
+                  WorkFuncT<TypeT> wf{};
+
+                  wf(std::forward<Args>(args)...);
+               }
+
+               template<std::size_t... I>
+               constexpr static std::array<handler_t, span> make(std::index_sequence<I...>)
+               {
+                  return {{ &invoke< typename TypeMapFind<min_key + static_cast<int64_t>(I), TypeMapT...>::type >... }};
+               }
+
+               constexpr static std::array<handler_t, span> handlers = make(std::make_index_sequence<span>{});
+            };
+
+         public:
+            template<template<typename> typename WorkFuncT, typename KeyT, typename... Args>
+            static void dispatch(KeyT&& key, Args&& ... args)
+            {
+               using TableT = Table<WorkFuncT, Args...>;
+
+               // unsigned, so keys below min_key wrap around past the end as well
+               auto&& slot = static_cast<uint64_t>(static_cast<int64_t>(key)) - static_cast<uint64_t>(min_key);
+
+               if(slot < span)
+                  TableT::handlers[slot](std::forward<Args>(args)...);
+               else
+                  TableT::template invoke<void>(std::forward<Args>(args)...);
+            }
+      };
+
+      /*
+       * A table is used when at least a quarter of its slots would hold a key (and it is
+       * not too big), the binary search otherwise.
+       */
+      template<typename TypeMapListT>
+      struct TypeMapListSwitch
+      {
+         private:
+            template<typename T, bool is_empty = Size_v<T> == 0>
+            struct IsDense
+            {
+               constexpr static bool value = TypeMapListTableSwitch<T>::span <= 4 * Size_v<T> && TypeMapListTableSwitch<T>::span <= 1024;
+            };
+
+            template<typename T>
+            struct IsDense<T, true>
+            {
+               constexpr static bool value = false;
+            };
+
+         public:
+            constexpr static bool is_dense = IsDense<TypeMapListT>::value;
+
+            using type = Select_t< is_dense, TypeMapListTableSwitch<TypeMapListT>, TypeMapListTreeSwitch<TypeMapListT> >;
+      };
+   }
+
    template<typename... TypeMapT>
-   using TypeMapSwitch_t = detail::TypeMapListSwitch< TypeList<TypeMapT...> >;
+   using TypeMapSwitch_t = typename detail::TypeMapListSwitch< TypeList<TypeMapT...> >::type;
+
+   template<typename TypeMapListT>
+   using TypeMapListSwitch_t = typename detail::TypeMapListSwitch< TypeMapListT >::type;
+
+   template<typename TypeMapListT>
+   using TypeMapListTreeSwitch_t = detail::TypeMapListTreeSwitch< TypeMapListT >;
 
    template<typename TypeMapListT>
-   using TypeMapListSwitch_t = detail::TypeMapListSwitch< TypeMapListT >;
+   using TypeMapListTableSwitch_t = detail::TypeMapListTableSwitch< TypeMapListT >;
 
    ////////////////////////////////////////////////////////
 }
@@ -3,11 +3,40 @@
 #include <ostream>
 #include <experimental/optional>
 #include <cctype>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace util
 {
-   template<class Iterator>
-   inline std::ostream& DumpOct(std::ostream& os, Iterator begin, Iterator end)
+   // '\' and the octal digits of x, zero padded to 'width'
+   template<class OStream>
+   inline void PutOct(OStream& os, unsigned x, int width)
+   {
+      char digits[4];
+      int n = 0;
+
+      do
+      {
+         digits[n++] = static_cast<char>('0' + (x & 7));
+         x >>= 3;
+      }
+      while(x);
+
+      os << '\\';
+
+      for(; width > n; --width)
+         os << '0';
+
+      while(n > 0)
+         os << digits[--n];
+   }
+
+   // works with std::ostream as well as anything else taking chars and strings through <<
+   template<class OStream, class Iterator>
+   inline OStream& DumpOct(OStream& os, Iterator begin, Iterator end)
    {
       std::experimental::optional<unsigned> z;
 
@@ -21,13 +50,10 @@ namespace util
             {
                // if current char is a number character, ensure previous number is printed with zero padding
 
-               if(*z < 8)
-                  os << "\\00" << std::oct << *z;
-               else if(*z < 64)
-                  os << "\\0" << std::oct << *z;
+               PutOct(os, *z, 3);
             }
             else
-               os << "\\" << std::oct << *z;
+               PutOct(os, *z, 1);
 
             z = {};
          }
@@ -72,7 +98,7 @@ namespace util
       }
 
       if(z)
-         os << "\\" << std::oct << *z;
+         PutOct(os, *z, 1);
 
       return os;
    }
@@ -91,6 +117,13 @@ namespace util
       return oss.str();
    }
 
+   inline std::string oct_dump(std::string_view data)
+   {
+      std::ostringstream oss;
+      DumpOct(oss, data.begin(), data.end());
+      return oss.str();
+   }
+
    inline std::string oct_dump(uint32_t x)
    {
       unsigned char* b = reinterpret_cast<unsigned char*>(&x);
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace util
+{
+   /*
+    * A vector with room for its first N elements inside the object itself, moving to
+    * memory from its resource only when it grows past that (and keeping that memory
+    * across clear()).
+    *
+    * Copies and moves treat the resource as std::pmr::vector does: a copy gets the
+    * default resource, a move keeps the one of the vector moved from.
+    */
+   template<class T, std::size_t N>
+   class small_vector_t
+   {
+      static_assert(N > 0, "use std::pmr::vector");
+      static_assert(std::is_nothrow_move_constructible<T>::value, "elements are moved when growing");
+
+      public:
+         using value_type = T;
+         using size_type = std::size_t;
+         using iterator = T*;
+         using const_iterator = const T*;
+
+         static constexpr std::size_t inline_capacity = N;
+
+         explicit small_vector_t(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : m_resource(mr)
+         {
+         }
+
+         small_vector_t(const small_vector_t& rhs)
+         {
+            append_copy(rhs);
+         }
+
+         small_vector_t(small_vector_t&& rhs) noexcept
+            : m_resource(rhs.m_resource)
+         {
+            take(rhs);
+         }
+
+         small_vector_t& operator=(const small_vector_t& rhs)
+         {
+            if(this != &rhs)
+            {
+               clear();
+               append_copy(rhs);
+            }
+
+            return *this;
+         }
+
+         small_vector_t& operator=(small_vector_t&& rhs)
+         {
+            if(this != &rhs)
+            {
+               clear();
+
+               if(m_resource == rhs.m_resource)
+               {
+                  release();
+                  take(rhs);
+               }
+               else
+               {
+                  // cannot take memory of another resource; rhs keeps it, emptied
+                  reserve(rhs.m_size);
+
+                  for(auto&& v : rhs)
+                     ::new(static_cast<void*>(m_data + m_size++)) T(std::move(v));
+
+                  rhs.clear();
+               }
+            }
+
+            return *this;
+         }
+
+         ~small_vector_t()
+         {
+            clear();
+            release();
+         }
+
+         std::pmr::memory_resource* resource() const
+         {
+            return m_resource;
+         }
+
+         // true while the elements are still held inline
+         bool is_inline() const
+         {
+            return m_data == inline_data();
+         }
+
+         std::size_t size() const
+         {
+            return m_size;
+         }
+
+         std::size_t capacity() const
+         {
+            return m_capacity;
+         }
+
+         bool empty() const
+         {
+            return m_size == 0;
+         }
+
+         T* data()
+         {
+            return m_data;
+         }
+
+         const T* data() const
+         {
+            return m_data;
+         }
+
+         iterator begin()
+         {
+            return m_data;
+         }
+
+         iterator end()
+         {
+            return m_data + m_size;
+         }
+
+         const_iterator begin() const
+         {
+            return m_data;
+         }
+
+         const_iterator end() const
+         {
+            return m_data + m_size;
+         }
+
+         T& operator[](std::size_t i)
+         {
+            return m_data[i];
+         }
+
+         const T& operator[](std::size_t i) const
+         {
+            return m_data[i];
+         }
+
+         T& at(std::size_t i)
+         {
+            check_index(i);
+            return m_data[i];
+         }
+
+         const T& at(std::size_t i) const
+         {
+            check_index(i);
+            return m_data[i];
+         }
+
+         T& back()
+         {
+            return m_data[m_size - 1];
+         }
+
+         const T& back() const
+         {
+            return m_data[m_size - 1];
+         }
+
+         void reserve(std::size_t n)
+         {
+            if(n > m_capacity)
+               relocate(n);
+         }
+
+         template<class... Args>
+         T& emplace_back(Args&&... args)
+         {
+            if(m_size == m_capacity)
+            {
+               // made before the move, as args may refer to an element
+               T v(std::forward<Args>(args)...);
+
+               relocate(2 * m_capacity);
+
+               return *::new(static_cast<void*>(m_data + m_size++)) T(std::move(v));
+            }
+
+            return *::new(static_cast<void*>(m_data + m_size++)) T(std::forward<Args>(args)...);
+         }
+
+         void push_back(const T& v)
+         {
+            emplace_back(v);
+         }
+
+         void push_back(T&& v)
+         {
+            emplace_back(std::move(v));
+         }
+
+         void pop_back()
+         {
+            m_data[--m_size].~T();
+         }
+
+         void clear()
+         {
+            std::destroy(m_data, m_data + m_size);
+            m_size = 0;
+         }
+
+      private:
+         T* inline_data()
+         {
+            return reinterpret_cast<T*>(m_inline);
+         }
+
+         const T* inline_data() const
+         {
+            return reinterpret_cast<const T*>(m_inline);
+         }
+
+         void check_index(std::size_t i) const
+         {
+            if(i >= m_size)
+               throw std::out_of_range("small_vector_t::at");
+         }
+
+         void append_copy(const small_vector_t& rhs)
+         {
+            reserve(rhs.m_size);
+
+            for(auto&& v : rhs)
+            {
+               ::new(static_cast<void*>(m_data + m_size)) T(v);
+               ++m_size;
+            }
+         }
+
+         // moves the elements to memory of the resource with room for 'n'
+         void relocate(std::size_t n)
+         {
+            T* p = static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T)));
+
+            for(std::size_t i = 0; i < m_size; ++i)
+            {
+               ::new(static_cast<void*>(p + i)) T(std::move(m_data[i]));
+               m_data[i].~T();
+            }
+
+            release();
+
+            m_data = p;
+            m_capacity = n;
+         }
+
+         void release()
+         {
+            if(!is_inline())
+               m_resource->deallocate(m_data, m_capacity * sizeof(T), alignof(T));
+
+            m_data = inline_data();
+            m_capacity = N;
+         }
+
+         // the elements (or memory) of rhs, which is left empty and inline
+         void take(small_vector_t& rhs)
+         {
+            if(rhs.is_inline())
+            {
+               for(auto&& v : rhs)
+                  ::new(static_cast<void*>(m_data + m_size++)) T(std::move(v));
+
+               rhs.clear();
+            }
+            else
+            {
+               m_data = rhs.m_data;
+               m_size = rhs.m_size;
+               m_capacity = rhs.m_capacity;
+
+               rhs.m_data = rhs.inline_data();
+               rhs.m_size = 0;
+               rhs.m_capacity = N;
+            }
+         }
+
+      private:
+         std::pmr::memory_resource* m_resource = std::pmr::get_default_resource();
+         T* m_data = inline_data();
+         std::size_t m_size = 0;
+         std::size_t m_capacity = N;
+         alignas(T) unsigned char m_inline[N * sizeof(T)];
+   };
+}
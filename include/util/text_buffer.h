@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace util
+{
+   namespace detail
+   {
+      // "00", "01", ... "99" back to back
+      struct digit_pairs_t
+      {
+         constexpr digit_pairs_t()
+            : chars{}
+         {
+            for(auto i = 0; i < 100; ++i)
+            {
+               chars[2 * i + 0] = static_cast<char>('0' + i / 10);
+               chars[2 * i + 1] = static_cast<char>('0' + i % 10);
+            }
+         }
+
+         char chars[200];
+      };
+
+      // the decimal text of every octet, its length in the last byte
+      struct octet_text_t
+      {
+         constexpr octet_text_t()
+            : text{}
+         {
+            for(auto i = 0; i < 256; ++i)
+            {
+               auto&& t = text[i];
+
+               if(i >= 100)
+               {
+                  t[0] = static_cast<char>('0' + i / 100);
+                  t[1] = static_cast<char>('0' + i / 10 % 10);
+                  t[2] = static_cast<char>('0' + i % 10);
+                  t[3] = 3;
+               }
+               else if(i >= 10)
+               {
+                  t[0] = static_cast<char>('0' + i / 10);
+                  t[1] = static_cast<char>('0' + i % 10);
+                  t[3] = 2;
+               }
+               else
+               {
+                  t[0] = static_cast<char>('0' + i);
+                  t[3] = 1;
+               }
+            }
+         }
+
+         char text[256][4];
+      };
+
+      inline constexpr digit_pairs_t digit_pairs{};
+      inline constexpr octet_text_t octet_text{};
+   }
+
+   /*
+    * Append-only text, meant to be kept and clear()ed between uses so that once grown
+    * formatting into it allocates nothing. Integers and IPv4 addresses are converted with
+    * lookup tables instead of going through iostreams or lexical_cast.
+    *
+    * Anything with a print_to(text_buffer_t&, const T&) overload can be <<'d into it.
+    */
+   class text_buffer_t
+   {
+      public:
+         void clear()
+         {
+            m_size = 0;
+         }
+
+         const char* data() const
+         {
+            return m_buf.data();
+         }
+
+         std::size_t size() const
+         {
+            return m_size;
+         }
+
+         std::string_view view() const
+         {
+            return std::string_view{m_buf.data(), m_size};
+         }
+
+         std::string str() const
+         {
+            return std::string{view()};
+         }
+
+         text_buffer_t& append(const char* p, std::size_t n)
+         {
+            std::memcpy(grow(n), p, n);
+
+            return *this;
+         }
+
+         text_buffer_t& append(char c)
+         {
+            *grow(1) = c;
+
+            return *this;
+         }
+
+         text_buffer_t& append_uint(uint64_t v)
+         {
+            char tmp[20];
+            auto&& p = tmp + sizeof(tmp);
+
+            while(v >= 100)
+            {
+               p -= 2;
+               std::memcpy(p, detail::digit_pairs.chars + 2 * (v % 100), 2);
+               v /= 100;
+            }
+
+            if(v >= 10)
+            {
+               p -= 2;
+               std::memcpy(p, detail::digit_pairs.chars + 2 * v, 2);
+            }
+            else
+            {
+               *--p = static_cast<char>('0' + v);
+            }
+
+            return append(p, tmp + sizeof(tmp) - p);
+         }
+
+         text_buffer_t& append_int(int64_t v)
+         {
+            if(v < 0)
+            {
+               append('-');
+
+               return append_uint(0 - static_cast<uint64_t>(v));
+            }
+
+            return append_uint(static_cast<uint64_t>(v));
+         }
+
+         // dotted quad, most significant octet first
+         text_buffer_t& append_ipv4(uint32_t v)
+         {
+            char* const begin = grow(15);
+            char* p = begin;
+
+            for(auto shift = 24; shift >= 0; shift -= 8)
+            {
+               auto&& t = detail::octet_text.text[(v >> shift) & 0xFF];
+
+               std::memcpy(p, t, 3);
+               p += t[3];
+
+               if(shift > 0)
+                  *p++ = '.';
+            }
+
+            m_size -= 15 - (p - begin);
+
+            return *this;
+         }
+
+      private:
+         // room for 'n' more chars, counted as used
+         char* grow(std::size_t n)
+         {
+            if(m_size + n > m_buf.size())
+               m_buf.resize(std::max(m_size + n, std::max<std::size_t>(2 * m_buf.size(), 256)));
+
+            auto&& p = &m_buf[m_size];
+
+            m_size += n;
+
+            return p;
+         }
+
+      private:
+         std::string m_buf;
+         std::size_t m_size = 0;
+   };
+
+   inline text_buffer_t& operator<<(text_buffer_t& b, std::string_view s)
+   {
+      return b.append(s.data(), s.size());
+   }
+
+   inline text_buffer_t& operator<<(text_buffer_t& b, const std::string& s)
+   {
+      return b.append(s.data(), s.size());
+   }
+
+   inline text_buffer_t& operator<<(text_buffer_t& b, const char* s)
+   {
+      return b.append(s, std::strlen(s));
+   }
+
+   // chars are text, as with std::ostream
+   inline text_buffer_t& operator<<(text_buffer_t& b, char c)
+   {
+      return b.append(c);
+   }
+
+   inline text_buffer_t& operator<<(text_buffer_t& b, unsigned char c)
+   {
+      return b.append(static_cast<char>(c));
+   }
+
+   template<class T>
+   std::enable_if_t < std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, unsigned char>::value, text_buffer_t& >
+   operator<<(text_buffer_t& b, T v)
+   {
+      if(std::is_signed<T>::value)
+         return b.append_int(static_cast<int64_t>(v));
+      else
+         return b.append_uint(static_cast<uint64_t>(v));
+   }
+
+   template<class T>
+   auto operator<<(text_buffer_t& b, const T& v) -> decltype(print_to(b, v), b)
+   {
+      print_to(b, v);
+
+      return b;
+   }
+
+   /*
+    * Writes 'v' to 'os' in one go, formatted through a per thread (and per type) buffer.
+    */
+   template<class T>
+   std::ostream& print(std::ostream& os, const T& v)
+   {
+      thread_local text_buffer_t buffer;
+
+      buffer.clear();
+      buffer << v;
+
+      return os.write(buffer.data(), buffer.size());
+   }
+}
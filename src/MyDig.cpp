@@ -1,5 +1,6 @@
 #include "dns/tcp/resolver.h"
 #include "dns/udp/resolver.h"
+#include "dns/presentation.h"
 
 #include <iostream>
 #include <string>
@@ -43,6 +44,16 @@ int basic_dns(int argc, char** argv) try
       }
    }();
 
+   auto&& print_response = [](auto ec, const dns::message_t& msg)
+   {
+      static util::text_buffer_t buffer;
+
+      buffer.clear();
+      dns::print_zone_to(buffer, msg);
+
+      std::cout.write(buffer.data(), buffer.size());
+   };
+
    {
       auto&& io = boost::asio::io_service{};
 
@@ -54,10 +65,7 @@ int basic_dns(int argc, char** argv) try
 
          r.async_resolve(
             dns::make_query(qname, qtype),
-            [](auto ec, auto msg)
-         {
-            std::cout << msg;
-         });
+            print_response);
 
          io.run();
       }
@@ -69,10 +77,7 @@ int basic_dns(int argc, char** argv) try
 
          r.async_resolve(
             dns::make_query(qname, qtype),
-            [](auto ec, auto msg)
-         {
-            std::cout << msg;
-         });
+            print_response);
 
          io.run();
       }
@@ -7,6 +7,10 @@
 #include "test/test_context.h"
 
 #include <string>
+#include <type_traits>
+#include <typeinfo>
+
+using namespace std::string_literals;
 
 namespace
 {
@@ -40,6 +44,25 @@ namespace
       OPT6 = 36,
       OPT7 = 46,
    };
+
+   template<typename T>
+   struct NameOf
+   {
+      void operator()(std::string& name)
+      {
+         name = typeid(T*).name();
+      }
+   };
+
+   template<typename SwitchT>
+   std::string name_of(int key)
+   {
+      std::string name;
+
+      SwitchT::template dispatch<NameOf>(static_cast<ABC_t>(key), name);
+
+      return name;
+   }
 }
 
 BOOST_AUTO_TEST_CASE(basic_use)
@@ -97,3 +120,43 @@ BOOST_AUTO_TEST_CASE(basic_use)
 
    // How to verify if the switch is happing using binary search
 }
+
+BOOST_AUTO_TEST_CASE(picks_table_for_dense_keys)
+{
+   using namespace util;
+
+   using Dense = TypeList< TypeMap<ABC_t, ABC_t::OPT1, int>, TypeMap<ABC_t, ABC_t::OPT5, float>, TypeMap<ABC_t, ABC_t::OPT4, long> >;
+   using Sparse = TypeList< TypeMap<ABC_t, ABC_t::OPT2, int>, TypeMap<ABC_t, ABC_t::OPT7, float> >;
+   using Single = TypeList< TypeMap<ABC_t, ABC_t::OPT6, int> >;
+
+   BOOST_CHECK((std::is_same<TypeMapListSwitch_t<Dense>, TypeMapListTableSwitch_t<Dense>>::value));
+   BOOST_CHECK((std::is_same<TypeMapListSwitch_t<Sparse>, TypeMapListTreeSwitch_t<Sparse>>::value));
+   BOOST_CHECK((std::is_same<TypeMapListSwitch_t<Single>, TypeMapListTableSwitch_t<Single>>::value));
+   BOOST_CHECK((std::is_same<TypeMapSwitch_t<>, TypeMapListTreeSwitch_t<TypeList<>>>::value));
+
+   BOOST_CHECK_EQUAL(TypeMapListTableSwitch_t<Dense>::min_key, 25);
+   BOOST_CHECK_EQUAL(TypeMapListTableSwitch_t<Dense>::span, 5u);
+}
+
+BOOST_AUTO_TEST_CASE(table_and_tree_agree)
+{
+   using namespace util;
+
+   using Dense = TypeList< TypeMap<ABC_t, ABC_t::OPT1, int>, TypeMap<ABC_t, ABC_t::OPT5, float>, TypeMap<ABC_t, ABC_t::OPT4, long> >;
+   using All = TypeList < TypeMap<ABC_t, ABC_t::OPT1, int>, TypeMap<ABC_t, ABC_t::OPT2, long>, TypeMap<ABC_t, ABC_t::OPT3, char>, TypeMap<ABC_t, ABC_t::OPT4, short>,
+                          TypeMap<ABC_t, ABC_t::OPT5, float>, TypeMap<ABC_t, ABC_t::OPT6, double>, TypeMap<ABC_t, ABC_t::OPT7, std::string> >;
+
+   BOOST_CHECK_EQUAL(name_of<TypeMapListTableSwitch_t<Dense>>(25), typeid(int*).name());
+   BOOST_CHECK_EQUAL(name_of<TypeMapListTableSwitch_t<Dense>>(26), typeid(float*).name());
+   BOOST_CHECK_EQUAL(name_of<TypeMapListTableSwitch_t<Dense>>(29), typeid(long*).name());
+   BOOST_CHECK_EQUAL(name_of<TypeMapListTableSwitch_t<Dense>>(27), typeid(void*).name());
+
+   for(auto key = -70000; key < 70000; key += (key > -5 && key < 60) ? 1 : 997)
+   {
+      BOOST_TEST_CONTEXT(TEST_CONTEXT(std::to_string(key)))
+      {
+         BOOST_CHECK_EQUAL(name_of<TypeMapListTableSwitch_t<Dense>>(key), name_of<TypeMapListTreeSwitch_t<Dense>>(key));
+         BOOST_CHECK_EQUAL(name_of<TypeMapListTableSwitch_t<All>>(key), name_of<TypeMapListTreeSwitch_t<All>>(key));
+      }
+   }
+}
@@ -0,0 +1,256 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE batch_decoder_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/batch_decoder.h"
+#include "dns/message.h"
+
+#include "test/test_context.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace std::string_literals;
+
+namespace
+{
+   std::vector<uint8_t> make_response(uint16_t id, const std::string& qname, int answers)
+   {
+      auto&& m = dns::message_t{};
+
+      m.Header().ID(id);
+      m.Header().QR_Flag(true);
+      m.Header().QdCount(1);
+      m.Header().AnCount(answers);
+      m.Header().ArCount(1);
+
+      m.Question(dns::question_t{});
+      m.Question(0).Name(qname);
+      m.Question(0).Type(dns::rr_type_t::rec_mx);
+
+      for(auto i = 0; i < answers; ++i)
+      {
+         dns::answer_t r;
+         r.Name(qname);
+         r.Type(dns::rr_type_t::rec_mx);
+         r.TTL(300 + i);
+         r.Data(dns::rec_mx_t{static_cast<uint16_t>(i), "mx" + std::to_string(i) + "." + qname});
+         m.Answer(r);
+      }
+
+      {
+         dns::answer_t r;
+         r.Name("mx0." + qname);
+         r.Type(dns::rr_type_t::rec_a);
+         r.TTL(60);
+         r.Data(dns::rec_a_t{"10.0.0.1"});
+         m.Additional(r);
+      }
+
+      auto&& raw = std::vector<uint8_t>{};
+      m.save_to(raw);
+
+      return raw;
+   }
+
+   std::vector<dns::packet_t> packets_of(const std::vector<std::vector<uint8_t>>& raw)
+   {
+      auto&& packets = std::vector<dns::packet_t>{};
+
+      for(auto&& r : raw)
+         packets.push_back(dns::packet_t{r.data(), r.size()});
+
+      return packets;
+   }
+}
+
+BOOST_AUTO_TEST_CASE(columns_match_message_t)
+{
+   auto&& raw = std::vector<std::vector<uint8_t>>
+   {
+      make_response(1, "yahoo.com", 2),
+      make_response(2, "google.com", 0),
+      make_response(3, "example.org", 3),
+   };
+
+   raw[1].resize(raw[1].size() - 1); // malformed
+
+   auto&& packets = packets_of(raw);
+
+   auto&& batch = dns::batch_decoder_t{};
+
+   batch.decode(packets.data(), packets.size()); // THE TEST
+
+   BOOST_REQUIRE_EQUAL(batch.PacketCount(), 3);
+
+   BOOST_CHECK(!batch.Status()[0]);
+   BOOST_CHECK(batch.Status()[1].reason == dns::decode_errc_t::truncated);
+   BOOST_CHECK(!batch.Status()[2]);
+
+   BOOST_CHECK_EQUAL(batch.ID()[1], 2);
+   BOOST_CHECK_EQUAL(batch.QuestionBegin()[1], batch.QuestionBegin()[2]);
+   BOOST_CHECK_EQUAL(batch.RecordBegin()[1], batch.RecordBegin()[2]);
+
+   BOOST_CHECK_EQUAL(batch.QuestionCount(), 2);
+   BOOST_CHECK_EQUAL(batch.RecordCount(), 3 + 4);
+
+   for(auto p : { 0, 2 })
+   {
+      BOOST_TEST_CONTEXT("packet " << p)
+      {
+         auto&& m = dns::message_t{};
+         m.load_from(raw[p].begin(), raw[p].end());
+
+         BOOST_CHECK_EQUAL(batch.ID()[p], m.Header().ID());
+         BOOST_CHECK_EQUAL(batch.Flags()[p], m.Header().Flags());
+
+         auto&& q = batch.QuestionBegin()[p];
+
+         BOOST_REQUIRE_EQUAL(batch.QuestionBegin()[p + 1] - q, 1);
+         BOOST_CHECK_EQUAL(batch.Name(batch.QuestionName()[q]), m.Question(0).Name());
+         BOOST_CHECK(batch.QuestionType()[q] == m.Question(0).Type());
+         BOOST_CHECK(batch.QuestionClass()[q] == m.Question(0).Class());
+
+         auto&& first = batch.RecordBegin()[p];
+
+         BOOST_REQUIRE_EQUAL(batch.RecordBegin()[p + 1] - first, m.Header().AnCount() + 1u);
+
+         for(std::size_t i = 0; i < m.Header().AnCount(); ++i)
+         {
+            auto&& r = first + i;
+
+            BOOST_CHECK_EQUAL(batch.RecordPacket()[r], p);
+            BOOST_CHECK(batch.RecordSection()[r] == dns::section_t::answer);
+            BOOST_CHECK_EQUAL(batch.Name(batch.RecordOwner()[r]), m.Answer(i).Name());
+            BOOST_CHECK(batch.RecordType()[r] == m.Answer(i).Type());
+            BOOST_CHECK(batch.RecordClass()[r] == m.Answer(i).Class());
+            BOOST_CHECK_EQUAL(batch.RecordTTL()[r], m.Answer(i).TTL());
+
+            // the owner points back at the question name - pooled once
+            BOOST_CHECK_EQUAL(batch.RecordOwner()[r].offset, batch.QuestionName()[q].offset);
+
+            auto&& rdata = raw[p].data() + batch.RecordDataOffset()[r];
+            auto&& tr = dns::name_offset_tracker_t::read_in_place(raw[p].data(), batch.RecordDataOffset()[r]);
+
+            BOOST_CHECK(dns::load_from<dns::rec_mx_t>(tr, rdata, rdata + batch.RecordDataLength()[r]) == m.Answer(i).Data<dns::rec_mx_t>());
+         }
+
+         auto&& ar = first + m.Header().AnCount();
+
+         BOOST_CHECK(batch.RecordSection()[ar] == dns::section_t::additional);
+         BOOST_CHECK_EQUAL(batch.Name(batch.RecordOwner()[ar]), m.Additional(0).Name());
+         BOOST_CHECK_EQUAL(batch.RecordDataLength()[ar], 4);
+      }
+   }
+
+   batch.clear();
+
+   BOOST_CHECK_EQUAL(batch.PacketCount(), 0);
+   BOOST_CHECK_EQUAL(batch.RecordCount(), 0);
+   BOOST_CHECK_EQUAL(batch.RecordBegin().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_chunks_match_serial)
+{
+   auto&& raw = std::vector<std::vector<uint8_t>>{};
+
+   for(auto i = 0; i < 1000; ++i)
+      raw.push_back(make_response(i, "host" + std::to_string(i) + ".example.com", i % 4));
+
+   auto&& packets = packets_of(raw);
+
+   auto&& serial = dns::batch_decoder_t{};
+   serial.decode(packets.data(), packets.size());
+
+   auto&& chunks = std::deque<dns::batch_decoder_t>(3);
+
+   dns::batch_decoder_t::decode_parallel(packets.data(), packets.size(), chunks.begin(), chunks.end()); // THE TEST
+
+   std::size_t packet = 0;
+   std::size_t record = 0;
+
+   for(auto&& c : chunks)
+   {
+      for(std::size_t p = 0; p < c.PacketCount(); ++p, ++packet)
+         BOOST_CHECK_EQUAL(c.ID()[p], serial.ID()[packet]);
+
+      for(std::size_t r = 0; r < c.RecordCount(); ++r, ++record)
+      {
+         BOOST_CHECK_EQUAL(c.RecordTTL()[r], serial.RecordTTL()[record]);
+         BOOST_CHECK_EQUAL(c.NameWire(c.RecordOwner()[r]), serial.NameWire(serial.RecordOwner()[record]));
+      }
+   }
+
+   BOOST_CHECK_EQUAL(packet, serial.PacketCount());
+   BOOST_CHECK_EQUAL(record, serial.RecordCount());
+}
+
+BOOST_AUTO_TEST_CASE(small_calls_take_no_more_memory)
+{
+   // what the arena takes from upstream
+   struct counting_resource_t : std::pmr::memory_resource
+   {
+      std::size_t bytes = 0;
+
+      void* do_allocate(std::size_t n, std::size_t align) override
+      {
+         bytes += n;
+         return std::pmr::new_delete_resource()->allocate(n, align);
+      }
+
+      void do_deallocate(void* p, std::size_t n, std::size_t align) override
+      {
+         std::pmr::new_delete_resource()->deallocate(p, n, align);
+      }
+
+      bool do_is_equal(const std::pmr::memory_resource& rhs) const noexcept override
+      {
+         return this == &rhs;
+      }
+   };
+
+   auto&& raw = std::vector<std::vector<uint8_t>>{};
+
+   for(auto i = 0; i < 2000; ++i)
+      raw.push_back(make_response(i, "host" + std::to_string(i) + ".example.com", i % 4));
+
+   auto&& packets = packets_of(raw);
+
+   auto&& once = counting_resource_t{};
+   auto&& one_by_one = counting_resource_t{};
+
+   {
+      auto&& batch = dns::batch_decoder_t{&once};
+      batch.decode(packets.data(), packets.size());
+   }
+
+   {
+      auto&& batch = dns::batch_decoder_t{&one_by_one};
+
+      for(std::size_t i = 0; i < packets.size(); ++i)
+         batch.decode(packets.data() + i, 1); // THE TEST
+
+      BOOST_CHECK_EQUAL(batch.PacketCount(), packets.size());
+   }
+
+   BOOST_CHECK_LE(one_by_one.bytes, 4 * once.bytes);
+}
+
+BOOST_AUTO_TEST_CASE(packets_past_the_offset_range)
+{
+   auto&& raw = make_response(7, "yahoo.com", 1);
+   raw.resize(dns::batch_decoder_t::max_packet_size + 1);
+
+   auto&& packet = dns::packet_t{raw.data(), raw.size()};
+
+   auto&& batch = dns::batch_decoder_t{};
+
+   batch.decode(packet); // THE TEST
+
+   BOOST_REQUIRE_EQUAL(batch.PacketCount(), 1);
+   BOOST_CHECK(batch.Status()[0].reason == dns::decode_errc_t::too_long);
+   BOOST_CHECK_EQUAL(batch.ID()[0], 7);
+   BOOST_CHECK_EQUAL(batch.RecordCount(), 0);
+   BOOST_CHECK_EQUAL(batch.QuestionCount(), 0);
+}
@@ -0,0 +1,204 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE dname_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/dname.h"
+
+#include "test/exception_info.h"
+#include "test/test_context.h"
+#include "util/oct_dump.h"
+
+#include <string>
+#include <sstream>
+#include <unordered_set>
+
+using namespace std::string_literals;
+
+BOOST_AUTO_TEST_CASE(dns_from_text)
+{
+   struct
+   {
+      std::string test_context;
+      std::string input_text;
+
+      exception_info_t expected_exception;
+      std::string expected_wire;
+      std::size_t expected_label_count;
+      std::string expected_text;
+   }
+   TestData[] =
+   {
+      {
+         TEST_CONTEXT("root"),
+         "",
+
+         exception_info(),
+         "\0"s, 0, "",
+      },
+
+      {
+         TEST_CONTEXT("root (absolute)"),
+         ".",
+
+         exception_info(),
+         "\0"s, 0, "",
+      },
+
+      {
+         TEST_CONTEXT("simple case"),
+         "www.yahoo.com",
+
+         exception_info(),
+         "\3www\5yahoo\3com\0"s, 3, "www.yahoo.com",
+      },
+
+      {
+         TEST_CONTEXT("with extra ending dots - they are ignored"),
+         "www.Yahoo.com..",
+
+         exception_info(),
+         "\3www\5Yahoo\3com\0"s, 3, "www.Yahoo.com",
+      },
+
+      {
+         TEST_CONTEXT("with extra dots in the middle"),
+         "www..yahoo.com",
+
+         exception_info<dns::exception::bad_name>("wrong format"s, 1),
+         "", 0, "",
+      },
+
+      {
+         TEST_CONTEXT("beyond 63 label limit"),
+         "www." + std::string(64, 'x') + ".com",
+
+         exception_info<dns::exception::bad_name>("length too long"s, 1),
+         "", 0, "",
+      },
+
+      {
+         TEST_CONTEXT("at the RFC limit of 255"),
+         std::string(63, 'a') + "." + std::string(63, 'b') + "." + std::string(63, 'c') + "." + std::string(61, 'd'),
+
+         exception_info(),
+         "\77"s + std::string(63, 'a') + "\77"s + std::string(63, 'b') + "\77"s + std::string(63, 'c') + "\75"s + std::string(61, 'd') + "\0"s, 4,
+         std::string(63, 'a') + "." + std::string(63, 'b') + "." + std::string(63, 'c') + "." + std::string(61, 'd'),
+      },
+
+      {
+         TEST_CONTEXT("beyond the RFC limit of 255"),
+         std::string(63, 'a') + "." + std::string(63, 'b') + "." + std::string(63, 'c') + "." + std::string(62, 'd'),
+
+         exception_info<dns::exception::bad_name>("length too long"s, 2),
+         "", 0, "",
+      },
+   };
+
+   /////////////////////////////////////////////////////
+
+   for(auto Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         if(Datum.expected_exception)
+         {
+            BOOST_CHECK_EXCEPTION(dns::dname_t{Datum.input_text}, std::exception, Datum.expected_exception); // THE TEST
+         }
+         else
+         {
+            auto&& n = dns::dname_t{Datum.input_text}; // THE TEST
+
+            BOOST_CHECK_EQUAL(util::oct_dump(std::string(n.WireData(), n.WireData() + n.WireSize())), util::oct_dump(Datum.expected_wire));
+            BOOST_CHECK_EQUAL(n.LabelCount(), Datum.expected_label_count);
+            BOOST_CHECK_EQUAL(n.Name(), Datum.expected_text);
+            BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << n).str(), Datum.expected_text);
+            BOOST_CHECK(n == Datum.expected_text);
+         }
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(dns_compare_and_hash)
+{
+   auto&& a = dns::dname_t{"WWW.Yahoo.COM"};
+   auto&& b = dns::dname_t{"www.yahoo.com."};
+
+   BOOST_CHECK(a == b);
+   BOOST_CHECK(a == "www.yahoo.com");
+   BOOST_CHECK(a == "www.yahoo.com.");
+   BOOST_CHECK(!(a == "www.yahoo.co"));
+   BOOST_CHECK(!(a == "www-yahoo.com"));
+   BOOST_CHECK(a != dns::dname_t{"www.yahoo.org"});
+   BOOST_CHECK(a != dns::dname_t{"ww.wyahoo.com"});
+
+   BOOST_CHECK_EQUAL(a.Hash(), b.Hash());
+   BOOST_CHECK_EQUAL(a.Name(), "WWW.Yahoo.COM"); // case is preserved
+
+   auto&& names = std::unordered_set<dns::dname_t>{ a, b, dns::dname_t{"yahoo.com"} };
+   BOOST_CHECK_EQUAL(names.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(dns_subdomain)
+{
+   struct
+   {
+      std::string test_context;
+      std::string input_name;
+      std::string input_parent;
+
+      bool expected;
+   }
+   TestData[] =
+   {
+      { TEST_CONTEXT("same name"),                 "www.yahoo.com", "www.yahoo.com", true,  },
+      { TEST_CONTEXT("direct parent"),             "www.yahoo.com", "yahoo.com",     true,  },
+      { TEST_CONTEXT("parent of different case"),  "www.yahoo.com", "YAHOO.com",     true,  },
+      { TEST_CONTEXT("root is parent of all"),     "www.yahoo.com", "",              true,  },
+      { TEST_CONTEXT("partial label is no parent"), "www.yahoo.com", "ahoo.com",     false, },
+      { TEST_CONTEXT("child is no parent"),        "yahoo.com",     "www.yahoo.com", false, },
+      { TEST_CONTEXT("sibling is no parent"),      "www.yahoo.com", "yahoo.org",     false, },
+   };
+
+   /////////////////////////////////////////////////////
+
+   for(auto Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         BOOST_CHECK_EQUAL(dns::dname_t{Datum.input_name}.IsSubdomainOf(dns::dname_t{Datum.input_parent}), Datum.expected); // THE TEST
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(dns_save_to_and_load_from)
+{
+   auto&& tr = dns::name_offset_tracker_t{};
+
+   dns::save_to(tr, dns::dname_t{"www.yahoo.com"});
+   dns::save_to(tr, dns::dname_t{"mail.yahoo.com"});
+   dns::save_to(tr, dns::dname_t{"www.yahoo.com"});
+
+   auto&& raw = tr.store();
+
+   BOOST_CHECK_EQUAL(util::oct_dump(raw), util::oct_dump("\3www\5yahoo\3com\0\4mail\300\4\300\0"s));
+
+   auto&& in_tr = dns::name_offset_tracker_t{};
+   auto&& b = raw.cbegin();
+   auto&& e = raw.cend();
+
+   BOOST_CHECK_EQUAL(dns::load_from<dns::dname_t>(in_tr, b, e), "www.yahoo.com");
+   BOOST_CHECK_EQUAL(dns::load_from<dns::dname_t>(in_tr, b, e), "mail.yahoo.com");
+   BOOST_CHECK_EQUAL(dns::load_from<dns::dname_t>(in_tr, b, e), "www.yahoo.com");
+   BOOST_CHECK(b == e);
+}
+
+BOOST_AUTO_TEST_CASE(dns_load_from_beyond_limit)
+{
+   auto&& raw = "\77"s + std::string(63, 'a') + "\77"s + std::string(63, 'b') + "\77"s + std::string(63, 'c') + "\76"s + std::string(62, 'd') + "\0"s;
+
+   auto&& tr = dns::name_offset_tracker_t{};
+   auto&& b = raw.cbegin();
+   auto&& e = raw.cend();
+
+   BOOST_CHECK_EXCEPTION(dns::load_from<dns::dname_t>(tr, b, e), std::exception, exception_info<dns::exception::bad_data_stream>("length too long"s, 2));
+}
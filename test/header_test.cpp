@@ -11,6 +11,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <list>
 #include <string>
 #include <sstream>
 
@@ -225,7 +226,7 @@ BOOST_AUTO_TEST_CASE(dns_save_to)
                BOOST_CHECK_EQUAL(util::oct_dump(temp_tr.store()), util::oct_dump(Datum.expected_raw_data));
             }
 
-            BOOST_CHECK_NO_THROW(BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pH).str(), Datum.expected_stream));
+            BOOST_CHECK_NO_THROW(BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pH).str(), Datum.expected_stream));
          }
       }
    }
@@ -505,7 +506,7 @@ BOOST_AUTO_TEST_CASE(dns_load_from)
                BOOST_CHECK_EQUAL(util::oct_dump(temp_tr.store()), util::oct_dump(Datum.input_raw_data.substr(0, Datum.expected_distance)));
             }
 
-            BOOST_CHECK_NO_THROW(BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pH).str(), Datum.expected_stream));
+            BOOST_CHECK_NO_THROW(BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pH).str(), Datum.expected_stream));
 
             // More Check
             {
@@ -532,3 +533,142 @@ BOOST_AUTO_TEST_CASE(dns_load_from)
       }
    }
 }
+
+BOOST_AUTO_TEST_CASE(dns_flags_word)
+{
+   struct
+   {
+      std::string test_context;
+
+      uint16_t input_Flags;
+
+      bool expected_QR_Flag;
+      bool expected_AA_Flag;
+      bool expected_TC_Flag;
+      bool expected_RD_Flag;
+      bool expected_RA_Flag;
+      bool expected_AD_Flag;
+      bool expected_CD_Flag;
+
+      dns::op_code_t expected_OpCode;
+      dns::r_code_t expected_RCode;
+   }
+   TestData[] =
+   {
+      {
+         TEST_CONTEXT("no flags"),
+         0x0000,
+         false, false, false, false, false, false, false,
+         dns::op_code_t::query, dns::r_code_t::no_error,
+      },
+
+      {
+         TEST_CONTEXT("query flags"),
+         0x0120,
+         false, false, false, true, false, true, false,
+         dns::op_code_t::query, dns::r_code_t::no_error,
+      },
+
+      {
+         TEST_CONTEXT("truncated response"),
+         0x8383,
+         true, false, true, true, true, false, false,
+         dns::op_code_t::query, dns::r_code_t::nx_domain,
+      },
+
+      {
+         TEST_CONTEXT("all flags, status update"),
+         0x97B9,
+         true, true, true, true, true, true, true,
+         dns::op_code_t::status, dns::r_code_t::not_auth,
+      },
+   };
+
+   /////////////////////////////////////////////////////
+
+   for(auto Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         {
+            auto&& h = dns::header_t{};
+
+            h.Flags(Datum.input_Flags); // THE TEST
+
+            BOOST_CHECK_EQUAL(h.QR_Flag(), Datum.expected_QR_Flag);
+            BOOST_CHECK_EQUAL(h.AA_Flag(), Datum.expected_AA_Flag);
+            BOOST_CHECK_EQUAL(h.TC_Flag(), Datum.expected_TC_Flag);
+            BOOST_CHECK_EQUAL(h.RD_Flag(), Datum.expected_RD_Flag);
+            BOOST_CHECK_EQUAL(h.RA_Flag(), Datum.expected_RA_Flag);
+            BOOST_CHECK_EQUAL(h.AD_Flag(), Datum.expected_AD_Flag);
+            BOOST_CHECK_EQUAL(h.CD_Flag(), Datum.expected_CD_Flag);
+            BOOST_CHECK_EQUAL(h.OpCode(), Datum.expected_OpCode);
+            BOOST_CHECK_EQUAL(h.RCode(), Datum.expected_RCode);
+         }
+
+         {
+            auto&& h = dns::header_t{};
+
+            h.ID(0xFFFF);
+            h.QdCount(0xFFFF);
+
+            h.QR_Flag(Datum.expected_QR_Flag);
+            h.AA_Flag(Datum.expected_AA_Flag);
+            h.TC_Flag(Datum.expected_TC_Flag);
+            h.RD_Flag(Datum.expected_RD_Flag);
+            h.RA_Flag(Datum.expected_RA_Flag);
+            h.AD_Flag(Datum.expected_AD_Flag);
+            h.CD_Flag(Datum.expected_CD_Flag);
+            h.OpCode(Datum.expected_OpCode);
+            h.RCode(Datum.expected_RCode);
+
+            BOOST_CHECK_EQUAL(h.Flags(), Datum.input_Flags); // THE TEST
+            BOOST_CHECK_EQUAL(h.ID(), 0xFFFF);
+            BOOST_CHECK_EQUAL(h.QdCount(), 0xFFFF);
+         }
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(dns_load_from_any_iterator)
+{
+   auto&& raw = "\x50\x06\x83\x83\x00\x01\x00\x02\x00\x03\x00\x04"s;
+
+   auto&& contiguous = [&]
+   {
+      auto&& b = raw.cbegin();
+      dns::name_offset_tracker_t tr;
+
+      auto&& h = dns::load_from<dns::header_t>(tr, b, raw.cend());
+
+      BOOST_CHECK(b == raw.cend());
+      BOOST_CHECK_EQUAL(util::oct_dump(tr.store()), util::oct_dump(raw));
+
+      return h;
+   }();
+
+   auto&& linked = [&]
+   {
+      auto&& l = std::list<char>(raw.begin(), raw.end());
+      auto&& b = l.cbegin();
+      dns::name_offset_tracker_t tr;
+
+      auto&& h = dns::load_from<dns::header_t>(tr, b, l.cend());
+
+      BOOST_CHECK(b == l.cend());
+      BOOST_CHECK_EQUAL(util::oct_dump(tr.store()), util::oct_dump(raw));
+
+      return h;
+   }();
+
+   BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << contiguous).str(), static_cast<std::ostringstream&&>(std::ostringstream() << linked).str());
+   BOOST_CHECK_EQUAL(contiguous.Flags(), 0x8383);
+
+   {
+      auto&& truncated = raw.substr(0, 11);
+      auto&& b = truncated.cbegin();
+      dns::name_offset_tracker_t tr;
+
+      BOOST_CHECK_THROW(dns::load_from<dns::header_t>(tr, b, truncated.cend()), dns::exception::bad_data_stream);
+   }
+}
@@ -204,13 +204,53 @@ BOOST_AUTO_TEST_CASE(dns_save_to)
       },
 
       {
-         TEST_CONTEXT("a domain way above RFC limit of 255 is supported too"),
+         TEST_CONTEXT("at RFC limit of 255"),
+         0,
+         "",
+         std::string(077, 'w') + '.' + std::string(077, 'a') + '.' + std::string(077, 'b') + '.' + std::string(075, 'c'),
+
+         exception_info(),
+         "\77"s + std::string(077, 'w') + "\077"s + std::string(077, 'a') + "\077"s + std::string(077, 'b') + "\075"s + std::string(075, 'c') + "\0"s,
+      },
+
+      {
+         TEST_CONTEXT("beyond RFC limit of 255"),
+         0,
+         "",
+         std::string(077, 'w') + '.' + std::string(077, 'a') + '.' + std::string(077, 'b') + '.' + std::string(076, 'c'),
+
+         exception_info<dns::exception::bad_name>("length too long"s, 2),
+         "",
+      },
+
+      {
+         TEST_CONTEXT("a domain way above RFC limit of 255"),
          0,
          "",
          std::string(077, 'w') + '.' + std::string(077, 'w') + '.' + std::string(077, 'a') + '.' + std::string(077, 'b') + '.' + std::string(075, 'c'),
 
+         exception_info<dns::exception::bad_name>("length too long"s, 2),
+         "",
+      },
+
+      {
+         TEST_CONTEXT("at label count limit of 127"),
+         0,
+         "",
+         [] { auto&& s = std::string{}; for(auto i = 0; i < 127; ++i) s += "a."; return s; }(),
+
          exception_info(),
-         "\77"s + std::string(077, 'w') + "\77"s + std::string(077, 'w') + "\077"s + std::string(077, 'a') + "\077"s + std::string(077, 'b') + "\075"s + std::string(075, 'c') + "\0"s,
+         [] { auto&& s = std::string{}; for(auto i = 0; i < 127; ++i) s += "\1a"; return s + "\0"s; }(),
+      },
+
+      {
+         TEST_CONTEXT("beyond label count limit of 127"),
+         0,
+         "",
+         [] { auto&& s = std::string{}; for(auto i = 0; i < 128; ++i) s += "a."; return s; }(),
+
+         exception_info<dns::exception::bad_name>("length too long"s, 2),
+         "",
       },
    };
 
@@ -236,7 +276,7 @@ BOOST_AUTO_TEST_CASE(dns_save_to)
 
                BOOST_CHECK_EQUAL(pLL->Name(), input);
 
-               BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pLL).str(), "[" + input + "]");
+               BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pLL).str(), "[" + input + "]");
 
                BOOST_CHECK_NO_THROW(dns::save_to(tr, *pLL));   // THE TEST (PART 1)
             }
@@ -251,7 +291,7 @@ BOOST_AUTO_TEST_CASE(dns_save_to)
 
             BOOST_CHECK_EQUAL(pLL->Name(), input);
 
-            BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pLL).str(), "[" + input + "]");
+            BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pLL).str(), "[" + input + "]");
 
             if(Datum.expected_exception)
             {
@@ -402,6 +442,24 @@ BOOST_AUTO_TEST_CASE(dns_load_from)
          },
       },
 
+      {
+         TEST_CONTEXT("ptr_offset pointing to itself"),
+         std::string(45,'#'), "\3www\300\61"s,
+
+         {
+            { exception_info<dns::exception::bad_data_stream>("bad offset"s, 1), "", 6, },
+         },
+      },
+
+      {
+         TEST_CONTEXT("chain of ptr_offsets each pointing further back"),
+         std::string(45,'#') + "\3com\0\5yahoo\300\55\3www\300\62"s, "\3ftp\300\72"s,
+
+         {
+            { exception_info(), "ftp.www.yahoo.com", 6, },
+         },
+      },
+
       {
          TEST_CONTEXT("bad length in data (first label > 63)"),
          std::string(0,'#'), "\100www\5yahoo\3com\0ABCD"s,
@@ -445,6 +503,33 @@ BOOST_AUTO_TEST_CASE(dns_load_from)
             { exception_info<dns::exception::bad_data_stream>("truncated"s, 2), "", 15, },
          },
       },
+
+      {
+         TEST_CONTEXT("at RFC limit of 255"),
+         std::string(0,'#'), "\77"s + std::string(63, 'a') + "\77"s + std::string(63, 'b') + "\77"s + std::string(63, 'c') + "\75"s + std::string(61, 'd') + "\0"s,
+
+         {
+            { exception_info(), std::string(63, 'a') + "." + std::string(63, 'b') + "." + std::string(63, 'c') + "." + std::string(61, 'd'), 255, },
+         },
+      },
+
+      {
+         TEST_CONTEXT("beyond RFC limit of 255"),
+         std::string(0,'#'), "\77"s + std::string(63, 'a') + "\77"s + std::string(63, 'b') + "\77"s + std::string(63, 'c') + "\76"s + std::string(62, 'd') + "\0"s,
+
+         {
+            { exception_info<dns::exception::bad_data_stream>("length too long"s, 2), "", 257, },
+         },
+      },
+
+      {
+         TEST_CONTEXT("beyond RFC limit of 255 through ptr_offset"),
+         "\77"s + std::string(63, 'a') + "\77"s + std::string(63, 'b') + "\77"s + std::string(63, 'c') + "\0"s, "\76"s + std::string(62, 'd') + "\300\0"s,
+
+         {
+            { exception_info<dns::exception::bad_data_stream>("length too long"s, 2), "", 65, },
+         },
+      },
    };
 
    /////////////////////////////////////////////////////
@@ -481,9 +566,48 @@ BOOST_AUTO_TEST_CASE(dns_load_from)
 
                BOOST_CHECK_NO_THROW(BOOST_CHECK_EQUAL(pLL->Name(), expected.name));
 
-               BOOST_CHECK_NO_THROW(BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pLL).str(), "[" + expected.name + "]"));
+               BOOST_CHECK_NO_THROW(BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pLL).str(), "[" + expected.name + "]"));
             }
          }
       }
    }
 }
+
+BOOST_AUTO_TEST_CASE(dns_save_to_many_shared_suffixes)
+{
+   auto&& tr = dns::name_offset_tracker_t{};
+
+   for(int i = 0; i < 2000; ++i)
+      BOOST_REQUIRE_NO_THROW(dns::save_to(tr, dns::label_list_t{"host" + std::to_string(i % 500) + ".example.com"}));   // THE TEST
+
+   auto&& raw = tr.store();
+
+   // only the first name is written in full, the next 499 are "hostN" + pointer, the rest are bare pointers
+   BOOST_CHECK_EQUAL(raw.size(), std::size_t{19} + 9 * 8 + 90 * 9 + 400 * 10 + 1500 * 2);
+
+   auto&& b = raw.begin();
+   auto&& e = raw.end();
+   auto&& rtr = dns::name_offset_tracker_t{};
+
+   for(int i = 0; i < 2000; ++i)
+      BOOST_REQUIRE_EQUAL(dns::load_from<dns::label_list_t>(rtr, b, e).Name(), "host" + std::to_string(i % 500) + ".example.com");
+
+   BOOST_CHECK(b == e);
+}
+
+BOOST_AUTO_TEST_CASE(dns_save_to_table_reused_across_messages)
+{
+   {
+      auto&& tr = dns::name_offset_tracker_t{};
+
+      dns::save_to(tr, dns::label_list_t{"www.yahoo.com"});
+      dns::save_to(tr, dns::label_list_t{"www.google.com"});
+   }
+
+   auto&& tr = dns::name_offset_tracker_t{};
+
+   dns::save_to(tr, dns::label_list_t{"www.gmail.com"});   // same offsets as the previous message, different names
+   dns::save_to(tr, dns::label_list_t{"www.yahoo.com"});   // THE TEST
+
+   BOOST_CHECK_EQUAL(util::oct_dump(tr.store()), util::oct_dump("\3www\5gmail\3com\0\3www\5yahoo\300\12"s));
+}
@@ -0,0 +1,221 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE message_builder_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/message_builder.h"
+
+#include "test/test_context.h"
+#include "util/oct_dump.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std::string_literals;
+
+namespace
+{
+   dns::answer_t make_record(const char* name, dns::rr_type_t type, uint32_t ttl, const dns::rdata_t& rdata)
+   {
+      dns::answer_t r;
+      r.Name(name);
+      r.Type(type);
+      r.TTL(ttl);
+      r.Data(rdata);
+      return r;
+   }
+
+   // the message the builder is given below, as a message_t
+   dns::message_t sample_response()
+   {
+      auto&& m = dns::message_t{};
+
+      m.Header().ID(0x1234);
+      m.Header().QR_Flag(true);
+      m.Header().AA_Flag(true);
+      m.Header().RD_Flag(true);
+      m.Header().RA_Flag(true);
+      m.Header().QdCount(1);
+      m.Header().AnCount(3);
+      m.Header().NsCount(1);
+      m.Header().ArCount(2);
+
+      m.Question(dns::question_t{});
+      m.Question(0).Name("yahoo.com");
+      m.Question(0).Type(dns::rr_type_t::rec_mx);
+
+      m.Answer(make_record("yahoo.com", dns::rr_type_t::rec_mx, 1800, dns::rec_mx_t{1, "mta5.am0.yahoodns.net"}));
+      m.Answer(make_record("yahoo.com", dns::rr_type_t::rec_mx, 1800, dns::rec_mx_t{5, "mta6.am0.yahoodns.net"}));
+      m.Answer(make_record("yahoo.com", dns::rr_type_t::rec_txt, 300, dns::rec_txt_t{"v=spf1 redirect=_spf.mail.yahoo.com ~all"}));
+      m.Authority(make_record("yahoo.com", dns::rr_type_t::rec_ns, 172800, dns::rec_ns_t{"ns1.yahoo.com"}));
+      m.Additional(make_record("ns1.yahoo.com", dns::rr_type_t::rec_a, 1209600, dns::rec_a_t{"68.180.131.16"}));
+      m.Additional(make_record("yahoo.com", dns::rr_type_t::rec_rrsig, 300, dns::rec_raw_t{"\x01\x02\x03"s}));
+
+      return m;
+   }
+
+   void build_sample_response(dns::message_builder_t& b)
+   {
+      b.WithID(0x1234).WithAuthoritative().WithRecursion().WithRecursionAvailable()
+       .AddQuestionNamed("yahoo.com").WithQType(dns::rr_type_t::rec_mx)
+       .AddAnswer("yahoo.com").WithTTL(1800).WithData(dns::rec_mx_t{1, "mta5.am0.yahoodns.net"})
+       .AddAnswer("yahoo.com").WithTTL(1800).WithData(dns::rec_mx_t{5, "mta6.am0.yahoodns.net"})
+       .AddAnswer("yahoo.com").WithData(dns::rec_txt_t{"v=spf1 redirect=_spf.mail.yahoo.com ~all"}).WithTTL(300)
+       .AddAuthority("yahoo.com").WithTTL(172800).WithData(dns::rec_ns_t{"ns1.yahoo.com"})
+       .AddAdditional("ns1.yahoo.com").WithTTL(1209600).WithData(dns::rec_a_t{"68.180.131.16"})
+       .AddAdditional("yahoo.com").WithTTL(300).WithData(dns::rr_type_t::rec_rrsig, dns::rec_raw_t{"\x01\x02\x03"s});
+   }
+}
+
+BOOST_AUTO_TEST_CASE(builds_what_message_t_encodes)
+{
+   auto&& expected = std::vector<uint8_t>{};
+   sample_response().save_to(expected);
+
+   {
+      auto&& out = std::vector<uint8_t>{};
+      auto&& b = dns::response(out);
+
+      build_sample_response(b); // THE TEST
+
+      BOOST_CHECK_EQUAL(b.size(), expected.size());
+      BOOST_CHECK_EQUAL(util::oct_dump(out), util::oct_dump(expected));
+   }
+
+   {
+      // after a prefix, e.g. the TCP length - compression offsets are from the message start
+
+      auto&& out = std::vector<uint8_t>{0xAB, 0xCD};
+      auto&& b = dns::response(out);
+
+      build_sample_response(b); // THE TEST
+
+      BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin() + 2, out.end())), util::oct_dump(expected));
+   }
+
+   {
+      auto&& out = std::vector<uint8_t>(expected.size() + 4, 0xEE);
+      auto&& b = dns::response(out.data(), expected.size());
+
+      build_sample_response(b); // THE TEST - exactly enough
+
+      BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin(), out.begin() + b.size())), util::oct_dump(expected));
+      BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin() + expected.size(), out.end())), util::oct_dump("\xEE\xEE\xEE\xEE"s));
+   }
+
+   for(std::size_t capacity = 0; capacity < expected.size(); ++capacity)
+   {
+      BOOST_TEST_CONTEXT(TEST_CONTEXT(std::to_string(capacity)))
+      {
+         auto&& out = std::vector<uint8_t>(expected.size(), 0xEE);
+
+         BOOST_CHECK_EXCEPTION(auto&& b = dns::response(out.data(), capacity); build_sample_response(b), dns::exception::bad_buffer_size, // THE TEST
+                               [](const auto & e) { return e.what() == "buffer too small"s && e.code() == 1; });
+
+         BOOST_CHECK(std::all_of(out.begin() + capacity, out.end(), [](uint8_t c) { return c == 0xEE; }));
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(whole_message_after_every_call)
+{
+   auto&& out = std::vector<uint8_t>{};
+   auto&& b = dns::request(out);
+
+   auto&& decoded = [&out]()
+   {
+      auto&& m = dns::message_t{};
+      m.load_from(out.cbegin(), out.cend());
+      return m;
+   };
+
+   b.WithID(0x4321).WithRecursion();
+
+   BOOST_CHECK_EQUAL(decoded().Header().ID(), 0x4321);
+   BOOST_CHECK(decoded().Header().RD_Flag());
+   BOOST_CHECK(!decoded().Header().QR_Flag());
+
+   b.AddQuestionNamed("example.com"); // THE TEST
+
+   BOOST_CHECK_EQUAL(decoded().Header().QdCount(), 1);
+   BOOST_CHECK_EQUAL(decoded().Question(0).Type(), dns::rr_type_t::rec_a);
+
+   b.WithQType(dns::rr_type_t::rec_txt).WithQClass(dns::rr_class_t::chaos); // THE TEST
+
+   BOOST_CHECK_EQUAL(decoded().Question(0).Name().Name(), "example.com");
+   BOOST_CHECK_EQUAL(decoded().Question(0).Type(), dns::rr_type_t::rec_txt);
+   BOOST_CHECK_EQUAL(decoded().Question(0).Class(), dns::rr_class_t::chaos);
+
+   b.AddQuestionNamed("www.example.com").WithQType(dns::rr_type_t::rec_aaaa); // THE TEST
+
+   BOOST_CHECK_EQUAL(decoded().Header().QdCount(), 2);
+   BOOST_CHECK_EQUAL(decoded().Question(1).Name().Name(), "www.example.com");
+   BOOST_CHECK_EQUAL(decoded().Question(1).Type(), dns::rr_type_t::rec_aaaa);
+   BOOST_CHECK_EQUAL(decoded().Question(0).Type(), dns::rr_type_t::rec_txt);
+}
+
+BOOST_AUTO_TEST_CASE(compresses_across_other_encodes)
+{
+   auto&& expected = std::vector<uint8_t>{};
+   sample_response().save_to(expected);
+
+   auto&& out = std::vector<uint8_t>{};
+   auto&& b = dns::response(out);
+
+   b.WithID(0x1234).WithAuthoritative().WithRecursion().WithRecursionAvailable()
+    .AddQuestionNamed("yahoo.com").WithQType(dns::rr_type_t::rec_mx)
+    .AddAnswer("yahoo.com").WithTTL(1800).WithData(dns::rec_mx_t{1, "mta5.am0.yahoodns.net"});
+
+   // other messages encoded on the thread meanwhile
+
+   auto&& other = dns::message_t{};
+   other.Answer(make_record("www.example.org", dns::rr_type_t::rec_cname, 60, dns::rec_cname_t{"example.org"}));
+
+   auto&& other_raw = std::vector<uint8_t>{};
+   other.save_to(other_raw);
+
+   BOOST_CHECK_EQUAL(other.encoded_size(), other_raw.size());
+
+   b.AddAnswer("yahoo.com").WithTTL(1800).WithData(dns::rec_mx_t{5, "mta6.am0.yahoodns.net"})     // THE TEST
+    .AddAnswer("yahoo.com").WithData(dns::rec_txt_t{"v=spf1 redirect=_spf.mail.yahoo.com ~all"}).WithTTL(300)
+    .AddAuthority("yahoo.com").WithTTL(172800).WithData(dns::rec_ns_t{"ns1.yahoo.com"})
+    .AddAdditional("ns1.yahoo.com").WithTTL(1209600).WithData(dns::rec_a_t{"68.180.131.16"})
+    .AddAdditional("yahoo.com").WithTTL(300).WithData(dns::rr_type_t::rec_rrsig, dns::rec_raw_t{"\x01\x02\x03"s});
+
+   BOOST_CHECK_EQUAL(util::oct_dump(out), util::oct_dump(expected));
+}
+
+BOOST_AUTO_TEST_CASE(calls_out_of_order)
+{
+   struct
+   {
+      std::string test_context;
+
+      std::function<void(dns::message_builder_t&)> build;
+      int expected_code;
+   }
+   TestData[] =
+   {
+      { TEST_CONTEXT("question after records"), [](auto&& b) { b.AddAnswer("n.com").AddQuestionNamed("n.com"); }, 1 },
+      { TEST_CONTEXT("question type before any question"), [](auto&& b) { b.WithQType(dns::rr_type_t::rec_mx); }, 2 },
+      { TEST_CONTEXT("question type after records"), [](auto&& b) { b.AddQuestionNamed("n.com").AddAnswer("n.com").WithQType(dns::rr_type_t::rec_mx); }, 2 },
+      { TEST_CONTEXT("TTL before any record"), [](auto&& b) { b.AddQuestionNamed("n.com").WithTTL(1); }, 3 },
+      { TEST_CONTEXT("data before any record"), [](auto&& b) { b.WithData(dns::rec_a_t{"1.2.3.4"}); }, 3 },
+      { TEST_CONTEXT("answer after authority"), [](auto&& b) { b.AddAuthority("n.com").AddAnswer("n.com"); }, 4 },
+      { TEST_CONTEXT("authority after additional"), [](auto&& b) { b.AddAdditional("n.com").AddAuthority("n.com"); }, 4 },
+      { TEST_CONTEXT("data twice"), [](auto&& b) { b.AddAnswer("n.com").WithData(dns::rec_a_t{"1.2.3.4"}).WithData(dns::rec_a_t{"1.2.3.4"}); }, 5 },
+   };
+
+   for(auto&& data : TestData)
+   {
+      BOOST_TEST_CONTEXT(data.test_context)
+      {
+         auto&& out = std::vector<uint8_t>{};
+         auto&& b = dns::response(out);
+
+         BOOST_CHECK_EXCEPTION(data.build(b), dns::exception::bad_build_order, // THE TEST
+                               [&data](const auto & e) { return e.code() == data.expected_code; });
+      }
+   }
+}
@@ -0,0 +1,185 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE message_pool_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/detail/message_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+   std::size_t allocation_count = 0;
+}
+
+void* operator new(std::size_t n)
+{
+   ++allocation_count;
+
+   if(auto&& p = std::malloc(n ? n : 1))
+      return p;
+
+   throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+   std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+   std::free(p);
+}
+
+// what std::pmr::new_delete_resource() allocates with
+
+void* operator new(std::size_t n, std::align_val_t a)
+{
+   ++allocation_count;
+
+   std::size_t align = std::max<std::size_t>(static_cast<std::size_t>(a), sizeof(void*));
+
+   if(auto&& p = std::aligned_alloc(align, (std::max<std::size_t>(n, 1) + align - 1) / align * align))
+      return p;
+
+   throw std::bad_alloc{};
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+   std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+   std::free(p);
+}
+
+namespace
+{
+   dns::answer_t make_answer(const char* name, dns::rr_type_t type)
+   {
+      dns::answer_t r;
+      r.Name(name);
+      r.Type(type);
+      r.TTL(300);
+      return r;
+   }
+
+   std::vector<uint8_t> sample_response(std::size_t answers)
+   {
+      auto&& m = dns::message_t{};
+
+      m.Header().ID(0x1234);
+      m.Header().QR_Flag(true);
+      m.Header().QdCount(1);
+      m.Header().AnCount(answers);
+      m.Header().ArCount(2);
+
+      m.Question(dns::question_t{});
+      m.Question(0).Name("yahoo.com");
+      m.Question(0).Type(dns::rr_type_t::rec_mx);
+
+      for(std::size_t i = 0; i < answers; ++i)
+      {
+         auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_mx);
+         r.Data(dns::rec_mx_t{static_cast<uint16_t>(i), "mta" + std::to_string(i) + ".am0.yahoodns.net"});
+         m.Answer(r);
+      }
+
+      {
+         // rdata of more than one character string, well past any small string buffer
+         auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_txt);
+         r.Data(dns::rec_txt_t{std::string(600, 'x')});
+         m.Additional(r);
+      }
+
+      {
+         auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_rrsig);
+         r.Data(dns::rec_raw_t{std::string(100, '\x01')});
+         m.Additional(r);
+      }
+
+      auto&& raw = std::vector<uint8_t>{};
+      m.save_to(raw);
+
+      return raw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE(steady_state_decode_allocates_nothing)
+{
+   auto&& raw = sample_response(5);
+   auto&& smaller = sample_response(2);
+
+   auto&& pool = dns::detail::message_pool_t{};
+
+   for(auto i = 0; i < 2; ++i)
+   {
+      auto&& m = pool.acquire();
+      m->load_from(raw.cbegin(), raw.cend());
+   }
+
+   std::size_t before = allocation_count;
+   std::size_t decoded = 0;
+
+   for(auto i = 0; i < 100; ++i)
+   {
+      auto&& m = pool.acquire();
+      m->load_from((i % 2 ? raw : smaller).cbegin(), (i % 2 ? raw : smaller).cend());
+
+      decoded += m->Additional(0).Data<dns::rec_txt_t>().Wire().size();
+   }
+
+   BOOST_CHECK_EQUAL(allocation_count - before, 0u); // THE TEST
+   BOOST_CHECK_EQUAL(decoded, 100 * 603u);
+}
+
+BOOST_AUTO_TEST_CASE(messages_come_back_empty)
+{
+   auto&& raw = sample_response(3);
+
+   auto&& pool = dns::detail::message_pool_t{};
+
+   const dns::message_t* first = nullptr;
+
+   {
+      auto&& m = pool.acquire();
+      m->load_from(raw.cbegin(), raw.cend());
+
+      first = &*m;
+   }
+
+   BOOST_CHECK_EQUAL(pool.free_count(), 1u);
+
+   auto&& m = pool.acquire();
+
+   BOOST_CHECK(&*m == first); // THE TEST
+   BOOST_CHECK_EQUAL(m->Header().ID(), 0);
+   BOOST_CHECK_EQUAL(m->Header().AnCount(), 0);
+   BOOST_CHECK_THROW(m->Question(0), std::out_of_range);
+   BOOST_CHECK_THROW(m->Answer(0), std::out_of_range);
+   BOOST_CHECK_THROW(m->Additional(0), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(leases_held_at_once_are_distinct)
+{
+   auto&& pool = dns::detail::message_pool_t{};
+
+   {
+      auto&& leases = std::vector<dns::detail::message_pool_t::lease_t>{};
+
+      for(std::size_t i = 0; i < dns::detail::message_pool_t::max_free + 2; ++i)
+         leases.push_back(pool.acquire());
+
+      for(std::size_t i = 1; i < leases.size(); ++i)
+         BOOST_CHECK(&*leases[i] != &*leases[i - 1]); // THE TEST
+   }
+
+   BOOST_CHECK_EQUAL(pool.free_count(), dns::detail::message_pool_t::max_free);
+}
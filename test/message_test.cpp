@@ -0,0 +1,636 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE message_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/message.h"
+
+#include "test/test_context.h"
+#include "util/oct_dump.h"
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+
+using namespace std::string_literals;
+
+namespace
+{
+   dns::message_t sample_response()
+   {
+      auto&& m = dns::message_t{};
+
+      m.Header().ID(0x1234);
+      m.Header().QR_Flag(true);
+      m.Header().QdCount(1);
+      m.Header().AnCount(1);
+
+      m.Question(dns::question_t{});
+      m.Question(0).Name("yahoo.com");
+      m.Question(0).Type(dns::rr_type_t::rec_mx);
+
+      dns::answer_t r;
+      r.Name("yahoo.com");
+      r.Type(dns::rr_type_t::rec_mx);
+      r.TTL(300);
+      r.Data(dns::rec_mx_t{1, "mta5.yahoo.com"});
+      m.Answer(r);
+
+      return m;
+   }
+}
+
+BOOST_AUTO_TEST_CASE(save_to_appends_in_place)
+{
+   auto&& m = sample_response();
+
+   auto&& expected = std::vector<uint8_t>{};
+   m.save_to(std::back_inserter(expected));
+
+   BOOST_CHECK_EQUAL(util::oct_dump(expected),
+                     util::oct_dump("\x12\x34\x80\0\0\1\0\1\0\0\0\0\5yahoo\3com\0\0\17\0\1\300\14\0\17\0\1\0\0\1\54\0\11\0\1\4mta5\300\14"s));
+
+   {
+      auto&& out = std::vector<uint8_t>{};
+
+      m.save_to(out); // THE TEST
+
+      BOOST_CHECK_EQUAL(util::oct_dump(out), util::oct_dump(expected));
+   }
+
+   {
+      auto&& out = std::vector<uint8_t>{ 0xAB, 0xCD }; // e.g. the TCP length prefix
+
+      m.save_to(out); // THE TEST - compression offsets stay relative to the message
+
+      BOOST_REQUIRE_EQUAL(out.size(), expected.size() + 2);
+      BOOST_CHECK_EQUAL(out[0], 0xAB);
+      BOOST_CHECK_EQUAL(out[1], 0xCD);
+      BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin() + 2, out.end())), util::oct_dump(expected));
+   }
+}
+
+BOOST_AUTO_TEST_CASE(save_to_fixed_buffer)
+{
+   auto&& m = sample_response();
+
+   auto&& expected = std::vector<uint8_t>{};
+   m.save_to(expected);
+
+   BOOST_CHECK_EQUAL(m.encoded_size(), expected.size()); // THE TEST - compression included
+
+   {
+      auto&& out = std::vector<uint8_t>(expected.size() + 4, 0xEE);
+
+      BOOST_CHECK_EQUAL(m.save_to(out.data(), expected.size()), expected.size()); // THE TEST - exactly enough
+
+      BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin(), out.begin() + expected.size())), util::oct_dump(expected));
+      BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin() + expected.size(), out.end())), util::oct_dump("\xEE\xEE\xEE\xEE"s));
+   }
+
+   {
+      auto&& out = std::vector<uint8_t>(expected.size() + 2, 0xEE);
+
+      BOOST_CHECK_EQUAL(m.save_framed_to(out.data(), out.size()), out.size()); // THE TEST
+
+      BOOST_CHECK_EQUAL(out[0], 0);
+      BOOST_CHECK_EQUAL(out[1], expected.size());
+      BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin() + 2, out.end())), util::oct_dump(expected));
+   }
+
+   for(std::size_t capacity = 0; capacity < expected.size(); ++capacity)
+   {
+      BOOST_TEST_CONTEXT(TEST_CONTEXT(std::to_string(capacity)))
+      {
+         auto&& out = std::vector<uint8_t>(expected.size(), 0xEE);
+
+         BOOST_CHECK_EXCEPTION(m.save_to(out.data(), capacity), dns::exception::bad_buffer_size, // THE TEST
+                               [](const auto & e) { return e.what() == "buffer too small"s && e.code() == 1; });
+
+         BOOST_CHECK(std::all_of(out.begin() + capacity, out.end(), [](uint8_t c) { return c == 0xEE; }));
+      }
+   }
+
+   {
+      uint8_t out[1];
+
+      BOOST_CHECK_THROW(m.save_framed_to(out, sizeof(out)), dns::exception::bad_buffer_size);
+   }
+}
+
+BOOST_AUTO_TEST_CASE(encoded_size_agrees_with_save_to)
+{
+   auto&& rng = std::mt19937{4321};
+
+   // few labels, so that names share suffixes - and differ in case only at times
+   auto&& random_name = [&rng]()
+   {
+      const char* labels[] = { "a", "b", "mx", "MX", "yahoo", "com", "Com", "example" };
+
+      auto&& name = std::string{};
+
+      for(auto n = 1 + rng() % 4; n > 0; --n)
+         name += std::string{labels[rng() % 8]} + (n > 1 ? "." : "");
+
+      return name;
+   };
+
+   for(auto i = 0; i < 200; ++i)
+   {
+      BOOST_TEST_CONTEXT("message " << i)
+      {
+         auto&& m = dns::message_t{};
+
+         m.Question(dns::question_t{});
+         m.Question(0).Name(random_name());
+
+         // the last ones past what the compression table takes
+         for(auto n = i < 190 ? rng() % 20 : 400 + rng() % 100; n > 0; --n)
+         {
+            dns::answer_t r;
+            r.Name(i < 190 ? random_name() : "host" + std::to_string(n) + "." + random_name());
+
+            switch(rng() % 4)
+            {
+               case 0:
+                  r.Type(dns::rr_type_t::rec_mx);
+                  r.Data(dns::rec_mx_t{10, random_name()});
+                  break;
+               case 1:
+                  r.Type(dns::rr_type_t::rec_cname);
+                  r.Data(dns::rec_cname_t{random_name()});
+                  break;
+               case 2:
+                  r.Type(dns::rr_type_t::rec_soa);
+                  r.Data(dns::rec_soa_t{random_name(), random_name(), 1, 2, 3, 4, 5});
+                  break;
+               default:
+                  r.Type(dns::rr_type_t::rec_a);
+                  r.Data(dns::rec_a_t{"192.0.2.1"});
+                  break;
+            }
+
+            m.Answer(r);
+         }
+
+         auto&& expected = std::vector<uint8_t>{};
+         m.save_to(expected);
+
+         BOOST_CHECK_EQUAL(m.encoded_size(), expected.size()); // THE TEST
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(save_truncated_to_budget)
+{
+   auto&& make_record = [](const char* name, dns::rr_type_t type, auto&& rdata)
+   {
+      dns::answer_t r;
+      r.Name(name);
+      r.Type(type);
+      r.TTL(300);
+      r.Data(rdata);
+      return r;
+   };
+
+   // the RRsets, in order: MX x3, TXT | NS x2 | A, A (different owners)
+   const struct
+   {
+      int section;
+      std::vector<dns::answer_t> records;
+   }
+   rrsets[] =
+   {
+      { 0, {
+            make_record("yahoo.com", dns::rr_type_t::rec_mx, dns::rec_mx_t{1, "mta5.am0.yahoodns.net"}),
+            make_record("yahoo.com", dns::rr_type_t::rec_mx, dns::rec_mx_t{1, "mta6.am0.yahoodns.net"}),
+            make_record("yahoo.com", dns::rr_type_t::rec_mx, dns::rec_mx_t{1, "mta7.am0.yahoodns.net"}),
+         }
+      },
+      { 0, { make_record("yahoo.com", dns::rr_type_t::rec_txt, dns::rec_txt_t{"v=spf1 redirect=_spf.mail.yahoo.com ~all"}) } },
+      { 1, {
+            make_record("yahoo.com", dns::rr_type_t::rec_ns, dns::rec_ns_t{"ns1.yahoo.com"}),
+            make_record("yahoo.com", dns::rr_type_t::rec_ns, dns::rec_ns_t{"ns2.yahoo.com"}),
+         }
+      },
+      { 2, { make_record("ns1.yahoo.com", dns::rr_type_t::rec_a, dns::rec_a_t{"68.180.131.16"}) } },
+      { 2, { make_record("ns2.yahoo.com", dns::rr_type_t::rec_a, dns::rec_a_t{"68.142.255.16"}) } },
+   };
+
+   // the message holding the first 'n' RRsets, as it should come out when cut after them
+   auto&& make_message = [&rrsets](std::size_t n)
+   {
+      auto&& m = dns::message_t{};
+
+      m.Header().ID(0x1234);
+      m.Header().QR_Flag(true);
+      m.Header().QdCount(1);
+
+      m.Question(dns::question_t{});
+      m.Question(0).Name("yahoo.com");
+      m.Question(0).Type(dns::rr_type_t::rec_mx);
+
+      uint16_t counts[3] = {};
+
+      for(std::size_t i = 0; i < n; ++i)
+      {
+         for(auto&& r : rrsets[i].records)
+         {
+            if(rrsets[i].section == 0)
+               m.Answer(r);
+            else if(rrsets[i].section == 1)
+               m.Authority(r);
+            else
+               m.Additional(r);
+
+            ++counts[rrsets[i].section];
+         }
+      }
+
+      m.Header().AnCount(counts[0]);
+      m.Header().NsCount(counts[1]);
+      m.Header().ArCount(counts[2]);
+      m.Header().TC_Flag(n < 3);
+
+      return m;
+   };
+
+   auto&& count = std::size(rrsets);
+   auto&& m = make_message(count);
+
+   auto&& full = std::vector<uint8_t>{};
+   m.save_to(full);
+
+   auto&& question_only = std::vector<uint8_t>{};
+   make_message(0).save_to(question_only);
+
+   for(std::size_t budget = question_only.size(); budget <= full.size() + 1; ++budget)
+   {
+      BOOST_TEST_CONTEXT(TEST_CONTEXT(std::to_string(budget)))
+      {
+         // the most RRsets that fit
+         auto&& fit = std::size_t{0};
+         auto&& expected = std::vector<uint8_t>{};
+
+         for(std::size_t n = 0; n <= count; ++n)
+         {
+            auto&& e = std::vector<uint8_t>{};
+            make_message(n).save_to(e);
+
+            if(e.size() > budget)
+               break;
+
+            fit = n;
+            expected = e;
+         }
+
+         auto&& out = std::vector<uint8_t>(full.size() + 2, 0xEE);
+
+         auto&& sz = m.save_truncated_to(out.data(), budget); // THE TEST
+
+         BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin(), out.begin() + sz)), util::oct_dump(expected));
+         BOOST_CHECK(std::all_of(out.begin() + budget, out.end(), [](uint8_t c) { return c == 0xEE; }));
+
+         auto&& h = dns::detail::load_header(out.data());
+
+         BOOST_CHECK_EQUAL(h.TC_Flag(), fit < 3);
+
+         if(fit == count)
+            BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin(), out.begin() + sz)), util::oct_dump(full));
+      }
+   }
+
+   for(std::size_t budget = 0; budget < question_only.size(); ++budget)
+   {
+      BOOST_TEST_CONTEXT(TEST_CONTEXT(std::to_string(budget)))
+      {
+         auto&& out = std::vector<uint8_t>(full.size(), 0xEE);
+
+         BOOST_CHECK_EXCEPTION(m.save_truncated_to(out.data(), budget), dns::exception::bad_buffer_size, // THE TEST
+                               [](const auto & e) { return e.what() == "buffer too small"s && e.code() == 1; });
+
+         BOOST_CHECK(std::all_of(out.begin() + budget, out.end(), [](uint8_t c) { return c == 0xEE; }));
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(save_to_and_load_from)
+{
+   auto&& m = sample_response();
+
+   auto&& raw = std::vector<uint8_t>{};
+   m.save_to(raw);
+
+   auto&& m1 = dns::message_t{};
+   BOOST_CHECK(m1.load_from(raw.begin(), raw.end()) == raw.end()); // THE TEST
+
+   BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << m1).str(),
+                     static_cast<std::ostringstream&&>(std::ostringstream() << m).str());
+}
+
+BOOST_AUTO_TEST_CASE(load_from_in_place_and_copied_agree)
+{
+   auto&& m = sample_response();
+
+   auto&& raw = std::vector<uint8_t>{};
+   m.save_to(raw);
+
+   auto&& in_place = dns::message_t{};
+   BOOST_CHECK(in_place.load_from(raw.data(), raw.data() + raw.size()) == raw.data() + raw.size()); // THE TEST
+
+   auto&& linked = std::list<uint8_t>(raw.begin(), raw.end());
+
+   auto&& copied = dns::message_t{};
+   BOOST_CHECK(copied.load_from(linked.begin(), linked.end()) == linked.end()); // THE TEST
+
+   // single pass
+   auto&& stream = std::istringstream{std::string(raw.begin(), raw.end())};
+
+   auto&& streamed = dns::message_t{};
+   BOOST_CHECK(streamed.load_from(std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}) == std::istreambuf_iterator<char>{}); // THE TEST
+
+   BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << in_place).str(),
+                     static_cast<std::ostringstream&&>(std::ostringstream() << copied).str());
+   BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << in_place).str(),
+                     static_cast<std::ostringstream&&>(std::ostringstream() << streamed).str());
+   BOOST_CHECK_EQUAL(in_place.Answer(0).Data<dns::rec_mx_t>().Exchange(), "mta5.yahoo.com");
+
+   for(std::size_t sz = raw.size() - 1; sz > 0; sz -= 7)
+   {
+      BOOST_TEST_CONTEXT("truncated to " << sz)
+      {
+         auto&& m1 = dns::message_t{};
+
+         BOOST_CHECK_THROW(m1.load_from(raw.data(), raw.data() + sz), dns::exception::bad_data_stream);
+      }
+
+      if(sz < 7)
+         break;
+   }
+}
+
+BOOST_AUTO_TEST_CASE(load_from_into_arena)
+{
+   auto&& m = sample_response();
+
+   {
+      dns::answer_t r;
+      r.Name("yahoo.com");
+      r.Type(dns::rr_type_t::rec_txt);
+      r.TTL(300);
+      r.Data(dns::rec_txt_t{"v=spf1 redirect=_spf.mail.yahoo.com ~all"});
+      m.Answer(r);
+
+      m.Header().AnCount(2);
+   }
+
+   auto&& raw = std::vector<uint8_t>{};
+   m.save_to(raw);
+
+   // no upstream - every allocation made while decoding must come out of the buffer
+
+   alignas(std::max_align_t) static char buffer[16 * 1024];
+   auto&& arena = std::pmr::monotonic_buffer_resource{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+
+   auto&& m1 = dns::message_t{&arena};
+   BOOST_CHECK(m1.load_from(raw.begin(), raw.end()) == raw.end()); // THE TEST
+
+   BOOST_CHECK(m1.resource() == &arena);
+   BOOST_CHECK_EQUAL(m1.Answer(1).Data<dns::rec_txt_t>().Text(), "v=spf1 redirect=_spf.mail.yahoo.com ~all");
+
+   BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << m1).str(),
+                     static_cast<std::ostringstream&&>(std::ostringstream() << m).str());
+}
+
+BOOST_AUTO_TEST_CASE(header_counts_not_trusted_byte_by_byte)
+{
+   // a bare header claiming 65535 answers - room for them would be megabytes
+   auto&& raw = std::vector<uint8_t>{ 0, 1, 0x81, 0x80, 0, 0, 0xFF, 0xFF, 0, 0, 0, 0 };
+   auto&& linked = std::list<uint8_t>(raw.begin(), raw.end());
+
+   alignas(std::max_align_t) static char buffer[16 * 1024];
+   auto&& arena = std::pmr::monotonic_buffer_resource{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+
+   auto&& m = dns::message_t{&arena};
+
+   BOOST_CHECK_EXCEPTION(m.load_from(linked.begin(), linked.end()), dns::exception::bad_data_stream, // THE TEST
+                         [](const auto & e) { return e.what() == "truncated"s; });
+
+   BOOST_CHECK_EXCEPTION(m.load_from(raw.begin(), raw.end()), dns::exception::bad_data_stream,
+                         [](const auto & e) { return e.what() == "truncated"s; });
+}
+
+BOOST_AUTO_TEST_CASE(clear_and_load_again)
+{
+   auto&& m = sample_response();
+
+   {
+      dns::answer_t r;
+      r.Name("yahoo.com");
+      r.Type(dns::rr_type_t::rec_txt);
+      r.TTL(300);
+      r.Data(dns::rec_txt_t{"v=spf1 redirect=_spf.mail.yahoo.com ~all"});
+      m.Additional(r);
+
+      m.Header().ArCount(1);
+   }
+
+   auto&& raw = std::vector<uint8_t>{};
+   m.save_to(raw);
+
+   auto&& m1 = dns::message_t{};
+   m1.load_from(raw.cbegin(), raw.cend());
+
+   m1.clear(); // THE TEST
+
+   BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << m1).str(),
+                     static_cast<std::ostringstream&&>(std::ostringstream() << dns::message_t{}).str());
+
+   m1.load_from(raw.cbegin(), raw.cend());
+
+   BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << m1).str(),
+                     static_cast<std::ostringstream&&>(std::ostringstream() << m).str());
+}
+
+BOOST_AUTO_TEST_CASE(try_load_from_reports_reason_and_offset)
+{
+   struct
+   {
+      std::string test_context;
+      std::string input_raw_data;
+
+      dns::decode_errc_t expected_reason;
+      std::size_t expected_offset;
+   }
+   TestData[] =
+   {
+      {
+         TEST_CONTEXT("good"),
+         "\x12\x34\x81\x80\x00\x01\x00\x01\x00\x00\x00\x00\5yahoo\3com\0\0\1\0\1\300\14\0\1\0\1\0\0\0\1\0\4\1\2\3\4"s,
+         dns::decode_errc_t::ok, 0,
+      },
+
+      {
+         TEST_CONTEXT("truncated header"),
+         "\x12\x34\x81\x80\x00\x01"s,
+         dns::decode_errc_t::truncated, 0,
+      },
+
+      {
+         TEST_CONTEXT("question with truncated name"),
+         "\x12\x34\x81\x80\x00\x01\x00\x00\x00\x00\x00\x00\5yahoo\3co"s,
+         dns::decode_errc_t::name_truncated, 12,
+      },
+
+      {
+         TEST_CONTEXT("question with bad label length"),
+         "\x12\x34\x81\x80\x00\x01\x00\x00\x00\x00\x00\x00\5yahoo\103com\0\0\1\0\1"s,
+         dns::decode_errc_t::label_too_long, 12,
+      },
+
+      {
+         TEST_CONTEXT("answer with forward pointer"),
+         "\x12\x34\x81\x80\x00\x00\x00\x01\x00\x00\x00\x00\300\40\0\1\0\1\0\0\0\1\0\4\1\2\3\4"s,
+         dns::decode_errc_t::bad_pointer, 12,
+      },
+
+      {
+         TEST_CONTEXT("answer with rdata beyond the end"),
+         "\x12\x34\x81\x80\x00\x00\x00\x01\x00\x00\x00\x00\5yahoo\3com\0\0\1\0\1\0\0\0\1\0\4\1\2\3"s,
+         dns::decode_errc_t::truncated, 33,
+      },
+
+      {
+         TEST_CONTEXT("a record with 5 bytes of rdata"),
+         "\x12\x34\x81\x80\x00\x00\x00\x01\x00\x00\x00\x00\5yahoo\3com\0\0\1\0\1\0\0\0\1\0\5\1\2\3\4\5"s,
+         dns::decode_errc_t::bad_rdata, 37,
+      },
+
+      {
+         TEST_CONTEXT("mx record with truncated exchange"),
+         "\x12\x34\x81\x80\x00\x00\x00\x01\x00\x00\x00\x00\5yahoo\3com\0\0\17\0\1\0\0\0\1\0\5\0\1\3mta"s,
+         dns::decode_errc_t::name_truncated, 35,
+      },
+
+      {
+         TEST_CONTEXT("txt record with a string past the rdata"),
+         "\x12\x34\x81\x80\x00\x00\x00\x01\x00\x00\x00\x00\5yahoo\3com\0\0\20\0\1\0\0\0\1\0\3\5ab"s,
+         dns::decode_errc_t::truncated, 33,
+      },
+   };
+
+   /////////////////////////////////////////////////////
+
+   for(auto Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         auto&& m = sample_response();
+         auto&& before = static_cast<std::ostringstream&&>(std::ostringstream() << m).str();
+
+         auto&& data = reinterpret_cast<const uint8_t*>(Datum.input_raw_data.data());
+
+         dns::decode_status_t status;
+         BOOST_REQUIRE_NO_THROW(status = m.try_load_from(data, Datum.input_raw_data.size())); // THE TEST
+
+         BOOST_CHECK(status.reason == Datum.expected_reason);
+         BOOST_CHECK_EQUAL(status.offset, Datum.expected_offset);
+         BOOST_CHECK_EQUAL(static_cast<bool>(status), Datum.expected_reason != dns::decode_errc_t::ok);
+         BOOST_CHECK(status.code() == Datum.expected_reason);
+
+         if(status)
+         {
+            BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << m).str(), before);
+            BOOST_CHECK_THROW(m.load_from(Datum.input_raw_data.begin(), Datum.input_raw_data.end()), dns::exception::bad_data_stream);
+         }
+         else
+         {
+            BOOST_CHECK_EQUAL(m.Header().ID(), 0x1234);
+            BOOST_CHECK(m.load_from(Datum.input_raw_data.begin(), Datum.input_raw_data.end()) == Datum.input_raw_data.end());
+         }
+      }
+   }
+
+   BOOST_CHECK_EQUAL(dns::make_error_code(dns::decode_errc_t::bad_pointer).message(), "bad compression pointer");
+}
+
+/*
+ * Whatever the bytes, try_load_from does not throw, and it fails exactly when the
+ * byte by byte decoder (which does not go through it) throws.
+ */
+BOOST_AUTO_TEST_CASE(messages_past_the_offset_range_refused)
+{
+   // well formed, but the last answer's owner pointer lies past offset 65535
+   auto&& raw = "\x12\x34\x81\x80\0\1\0\2\0\0\0\0\5yahoo\3com\0\0\1\0\1"s;
+
+   raw += "\xC0\x0C\0\x2E\0\1\0\0\0\1\xFF\xF0"s + std::string(0xFFF0, '\x01');
+   raw += "\xC0\x0C\0\1\0\1\0\0\0\1\0\4\1\2\3\4"s;
+
+   BOOST_REQUIRE_GT(raw.size(), 65535u);
+
+   auto&& data = reinterpret_cast<const uint8_t*>(raw.data());
+
+   dns::decode_status_t status;
+   auto&& m = dns::message_t{};
+
+   BOOST_REQUIRE_NO_THROW(status = m.try_load_from(data, raw.size())); // THE TEST
+   BOOST_CHECK(status.reason == dns::decode_errc_t::too_long);
+   BOOST_CHECK(m.Answers().empty());
+
+   BOOST_CHECK_EXCEPTION(m.load_from(raw.cbegin(), raw.cend()), dns::exception::bad_data_stream, // THE TEST
+                         [](const auto & e) { return e.what() == "length too long"s && e.code() == 1; });
+}
+
+BOOST_AUTO_TEST_CASE(try_load_from_agrees_with_throwing_decoder)
+{
+   auto&& m = sample_response();
+
+   {
+      dns::answer_t r;
+      r.Name("yahoo.com");
+      r.Type(dns::rr_type_t::rec_soa);
+      r.Data(dns::rec_soa_t{"ns1.yahoo.com", "hostmaster.yahoo.com", 1, 2, 3, 4, 5});
+      m.Authority(r);
+      m.Header().NsCount(1);
+   }
+
+   auto&& raw = std::vector<uint8_t>{};
+   m.save_to(raw);
+
+   auto&& rng = std::mt19937{12345};
+
+   for(auto i = 0; i < 20000; ++i)
+   {
+      std::vector<uint8_t> mutated = raw;
+      auto&& n = 1 + rng() % 3;
+
+      for(auto j = 0u; j < n; ++j)
+         mutated[rng() % mutated.size()] = static_cast<uint8_t>(rng());
+
+      std::size_t cut = std::min<std::size_t>(rng() % 8, mutated.size());
+      mutated.erase(mutated.end() - cut, mutated.end());
+
+      dns::decode_status_t status;
+      auto&& m1 = dns::message_t{};
+
+      BOOST_REQUIRE_NO_THROW(status = m1.try_load_from(mutated.data(), mutated.size())); // THE TEST
+
+      auto&& linked = std::list<uint8_t>(mutated.begin(), mutated.end());
+      auto&& threw = false;
+
+      try
+      {
+         dns::message_t{}.load_from(linked.begin(), linked.end());
+      }
+      catch(const dns::exception::bad_data_stream&)
+      {
+         threw = true;
+      }
+
+      BOOST_REQUIRE_MESSAGE(static_cast<bool>(status) == threw, "iteration " << i << ", reason " << dns::mnemonic(status.reason));
+   }
+}
@@ -0,0 +1,332 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE message_view_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/message.h"
+#include "dns/message_view.h"
+#include "dns/detail/response_callback.h"
+
+#include "test/exception_info.h"
+#include "test/test_context.h"
+#include "util/oct_dump.h"
+
+#include <string>
+#include <sstream>
+#include <vector>
+
+using namespace std::string_literals;
+
+namespace
+{
+   dns::answer_t make_answer(std::string name, dns::rr_type_t type, uint32_t ttl)
+   {
+      dns::answer_t r;
+
+      r.Name(name);
+      r.Type(type);
+      r.Class(dns::rr_class_t::internet);
+      r.TTL(ttl);
+
+      return r;
+   }
+
+   std::vector<uint8_t> sample_response()
+   {
+      auto&& m = dns::message_t{};
+
+      m.Header().ID(0x1234);
+      m.Header().QR_Flag(true);
+      m.Header().RD_Flag(true);
+      m.Header().RA_Flag(true);
+      m.Header().QdCount(1);
+      m.Header().AnCount(2);
+      m.Header().NsCount(1);
+      m.Header().ArCount(1);
+
+      m.Question(dns::question_t{});
+      m.Question(0).Name("yahoo.com");
+      m.Question(0).Type(dns::rr_type_t::rec_mx);
+      m.Question(0).Class(dns::rr_class_t::internet);
+
+      {
+         auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_mx, 300);
+         r.Data(dns::rec_mx_t{1, "mta5.am0.yahoodns.net"});
+         m.Answer(r);
+      }
+
+      {
+         auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_mx, 300);
+         r.Data(dns::rec_mx_t{5, "mta6.am0.yahoodns.net"});
+         m.Answer(r);
+      }
+
+      {
+         auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_ns, 600);
+         r.Data(dns::rec_ns_t{"ns1.yahoo.com"});
+         m.Authority(r);
+      }
+
+      {
+         auto&& r = make_answer("ns1.yahoo.com", dns::rr_type_t::rec_a, 900);
+         r.Data(dns::rec_a_t{"68.180.131.16"});
+         m.Additional(r);
+      }
+
+      auto&& raw = std::vector<uint8_t>{};
+      m.save_to(std::back_inserter(raw));
+      return raw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE(sections_and_lazy_decode)
+{
+   auto&& raw = sample_response();
+   raw.push_back('#'); // excess data is not part of the message
+
+   auto&& v = dns::message_view_t{raw};
+
+   BOOST_CHECK(!v.empty());
+   BOOST_CHECK_EQUAL(v.size(), raw.size() - 1);
+
+   BOOST_CHECK_EQUAL(v.Header().ID(), 0x1234);
+   BOOST_CHECK_EQUAL(v.Header().QR_Flag(), true);
+   BOOST_CHECK_EQUAL(v.Header().RA_Flag(), true);
+
+   BOOST_REQUIRE_EQUAL(v.Questions().size(), 1);
+   for(auto&& q : v.Questions())
+   {
+      BOOST_CHECK_EQUAL(q.Name().Name(), "yahoo.com");
+      BOOST_CHECK_EQUAL(q.Type(), dns::rr_type_t::rec_mx);
+      BOOST_CHECK_EQUAL(q.Class(), dns::rr_class_t::internet);
+   }
+
+   {
+      auto&& expected = std::vector<dns::rec_mx_t>{ dns::rec_mx_t{1, "mta5.am0.yahoodns.net"}, dns::rec_mx_t{5, "mta6.am0.yahoodns.net"} };
+      auto&& i = 0u;
+
+      BOOST_REQUIRE_EQUAL(v.Answers().size(), 2);
+      for(auto&& r : v.Answers())
+      {
+         BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << r.Name()).str(), "yahoo.com");
+         BOOST_CHECK_EQUAL(r.Type(), dns::rr_type_t::rec_mx);
+         BOOST_CHECK_EQUAL(r.TTL(), 300u);
+         BOOST_CHECK_EQUAL(r.Data<dns::rec_mx_t>(), expected.at(i++));
+      }
+      BOOST_CHECK_EQUAL(i, 2u);
+   }
+
+   BOOST_REQUIRE_EQUAL(v.Authorities().size(), 1);
+   BOOST_CHECK_EQUAL((*v.Authorities().begin()).Data<dns::rec_ns_t>(), dns::rec_ns_t{"ns1.yahoo.com"});
+
+   BOOST_REQUIRE_EQUAL(v.Additionals().size(), 1);
+   {
+      auto&& r = *v.Additionals().begin();
+
+      BOOST_CHECK_EQUAL(r.Name().Name(), "ns1.yahoo.com");
+      BOOST_CHECK_EQUAL(r.DataLength(), 4);
+      BOOST_CHECK_EQUAL(r.Data<dns::rec_a_t>(), dns::rec_a_t{"68.180.131.16"});
+   }
+}
+
+BOOST_AUTO_TEST_CASE(typed_record_iteration)
+{
+   auto&& m = dns::message_t{};
+
+   m.Header().QR_Flag(true);
+   m.Header().AnCount(4);
+   m.Header().ArCount(2);
+
+   {
+      auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_mx, 300);
+      r.Data(dns::rec_mx_t{1, "mta5.am0.yahoodns.net"});
+      m.Answer(r);
+   }
+
+   {
+      // rdata no MX decoder could take - it must not be looked at
+      auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_rrsig, 300);
+      r.Data(dns::rec_raw_t{"\xFF\xFF\xFF"s});
+      m.Answer(r);
+   }
+
+   {
+      auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_mx, 300);
+      r.Data(dns::rec_mx_t{5, "mta6.am0.yahoodns.net"});
+      m.Answer(r);
+   }
+
+   {
+      auto&& r = make_answer("yahoo.com", dns::rr_type_t::rec_txt, 300);
+      r.Data(dns::rec_txt_t{"v=spf1 -all"});
+      m.Answer(r);
+   }
+
+   {
+      auto&& r = make_answer("mta5.am0.yahoodns.net", dns::rr_type_t::rec_a, 900);
+      r.Data(dns::rec_a_t{"68.180.131.16"});
+      m.Additional(r);
+   }
+
+   {
+      auto&& r = make_answer("mta6.am0.yahoodns.net", dns::rr_type_t::rec_a, 900);
+      r.Data(dns::rec_a_t{"68.180.131.17"});
+      m.Additional(r);
+   }
+
+   auto&& raw = std::vector<uint8_t>{};
+   m.save_to(raw);
+
+   auto&& v = dns::message_view_t{raw};
+
+   {
+      auto&& exchanges = std::vector<std::string>{};
+
+      dns::for_each_record<dns::rec_mx_t>(v.Answers(), [&exchanges](const dns::rec_mx_t& mx) // THE TEST
+      {
+         exchanges.push_back(mx.Exchange().Name());
+      });
+
+      BOOST_CHECK_EQUAL(exchanges.size(), 2u);
+      BOOST_CHECK_EQUAL(exchanges.at(0), "mta5.am0.yahoodns.net");
+      BOOST_CHECK_EQUAL(exchanges.at(1), "mta6.am0.yahoodns.net");
+   }
+
+   {
+      auto&& owners = std::vector<std::string>{};
+
+      dns::for_each_record<dns::rec_a_t>(v.Additionals(), [&owners](auto&& a, auto&& r) // THE TEST
+      {
+         owners.push_back(r.Name().Name() + " " + a.DotAddress());
+      });
+
+      BOOST_CHECK_EQUAL(owners.size(), 2u);
+      BOOST_CHECK_EQUAL(owners.at(1), "mta6.am0.yahoodns.net 68.180.131.17");
+   }
+
+   BOOST_CHECK_EQUAL(dns::first_record<dns::rec_txt_t>(v.Answers()).value().Text(), "v=spf1 -all"); // THE TEST
+   BOOST_CHECK_EQUAL(dns::first_record<dns::rec_a_t>(v.Additionals()).value().DotAddress(), "68.180.131.16");
+   BOOST_CHECK(!dns::first_record<dns::rec_soa_t>(v.Answers()));
+   BOOST_CHECK(!dns::first_record<dns::rec_a_t>(v.Answers()));
+}
+
+BOOST_AUTO_TEST_CASE(negative_construction)
+{
+   struct
+   {
+      std::string test_context;
+      std::string input_raw_data;
+
+      exception_info_t expected_exception;
+   }
+   TestData[] =
+   {
+      {
+         TEST_CONTEXT("truncated header"),
+         "\x12\x34\x81\x80\x00\x01\x00\x00\x00"s,
+
+         exception_info<dns::exception::bad_data_stream>("truncated"s, 1),
+      },
+
+      {
+         TEST_CONTEXT("question with truncated name"),
+         "\x12\x34\x81\x80\x00\x01\x00\x00\x00\x00\x00\x00\5yahoo\3co"s,
+
+         exception_info<dns::exception::bad_data_stream>("truncated"s, 2),
+      },
+
+      {
+         TEST_CONTEXT("question with bad label length"),
+         "\x12\x34\x81\x80\x00\x01\x00\x00\x00\x00\x00\x00\5yahoo\103com\0\0\1\0\1"s,
+
+         exception_info<dns::exception::bad_data_stream>("length too long"s, 2),
+      },
+
+      {
+         TEST_CONTEXT("question with missing type"),
+         "\x12\x34\x81\x80\x00\x01\x00\x00\x00\x00\x00\x00\5yahoo\3com\0\0"s,
+
+         exception_info<dns::exception::bad_data_stream>("truncated"s, 1),
+      },
+
+      {
+         TEST_CONTEXT("answer with rdata beyond the end"),
+         "\x12\x34\x81\x80\x00\x00\x00\x01\x00\x00\x00\x00\5yahoo\3com\0\0\1\0\1\0\0\0\1\0\4\1\2\3"s,
+
+         exception_info<dns::exception::bad_data_stream>("truncated"s, 1),
+      },
+
+      {
+         TEST_CONTEXT("more records announced than present"),
+         "\x12\x34\x81\x80\x00\x00\x00\x02\x00\x00\x00\x00\5yahoo\3com\0\0\1\0\1\0\0\0\1\0\4\1\2\3\4"s,
+
+         exception_info<dns::exception::bad_data_stream>("truncated"s, 2),
+      },
+   };
+
+   /////////////////////////////////////////////////////
+
+   for(auto Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         BOOST_CHECK_EXCEPTION(dns::message_view_t{Datum.input_raw_data}, std::exception, Datum.expected_exception); // THE TEST
+
+         dns::decode_status_t status;
+         auto&& v = dns::message_view_t{reinterpret_cast<const uint8_t*>(Datum.input_raw_data.data()), Datum.input_raw_data.size(), status}; // THE TEST
+
+         BOOST_CHECK(status);
+         BOOST_CHECK(v.empty());
+         BOOST_CHECK_EXCEPTION(throw_if_failed(status), std::exception, Datum.expected_exception);
+
+         // what the resolvers hand their callbacks
+
+         auto&& ec = boost::system::error_code{};
+         auto&& response = dns::detail::response_view(reinterpret_cast<const uint8_t*>(Datum.input_raw_data.data()), Datum.input_raw_data.size(), ec); // THE TEST
+
+         BOOST_CHECK(ec);
+         BOOST_CHECK(response.empty());
+         BOOST_CHECK_EQUAL(ec.value(), static_cast<int>(status.reason));
+         BOOST_CHECK_EQUAL(ec.message(), status.code().message());
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(bad_pointer_detected_on_access)
+{
+   auto&& raw = "\x12\x34\x81\x80\x00\x00\x00\x01\x00\x00\x00\x00\300\40\0\1\0\1\0\0\0\1\0\4\1\2\3\4"s;
+
+   auto&& v = dns::message_view_t{raw};
+
+   BOOST_REQUIRE_EQUAL(v.Answers().size(), 1);
+   BOOST_CHECK_EQUAL((*v.Answers().begin()).Type(), dns::rr_type_t::rec_a);
+   BOOST_CHECK_EXCEPTION((*v.Answers().begin()).Name().Name(), std::exception, exception_info<dns::exception::bad_data_stream>("bad offset"s, 1));
+}
+
+BOOST_AUTO_TEST_CASE(rdata_length_disagreeing_with_content)
+{
+   // an A record with RDLENGTH 5
+   auto&& raw = "\x12\x34\x81\x80\x00\x00\x00\x01\x00\x00\x00\x00\0\0\1\0\1\0\0\0\1\0\5\1\2\3\4\5"s;
+
+   auto&& v = dns::message_view_t{raw};
+   auto&& expected = exception_info<dns::exception::bad_data_stream>("bad record"s, 5);
+
+   BOOST_REQUIRE_EQUAL(v.Answers().size(), 1);
+   BOOST_CHECK_EXCEPTION((*v.Answers().begin()).Data<dns::rec_a_t>(), std::exception, expected); // THE TEST
+   BOOST_CHECK_EXCEPTION(dns::first_record<dns::rec_a_t>(v.Answers()), std::exception, expected);
+   BOOST_CHECK_EXCEPTION(dns::for_each_record<dns::rec_a_t>(v.Answers(), [](auto&&) {}), std::exception, expected);
+
+   // as message_t has it
+   BOOST_CHECK_EXCEPTION(dns::message_t{}.load_from(raw.cbegin(), raw.cend()), std::exception, expected);
+}
+
+BOOST_AUTO_TEST_CASE(views_past_the_offset_range_refused)
+{
+   auto&& raw = std::vector<uint8_t>(65536, 0);
+
+   dns::decode_status_t status;
+   auto&& v = dns::message_view_t{raw.data(), raw.size(), status}; // THE TEST
+
+   BOOST_CHECK(status.reason == dns::decode_errc_t::too_long);
+   BOOST_CHECK(v.empty());
+   BOOST_CHECK_THROW(dns::message_view_t{raw}, dns::exception::bad_data_stream);
+}
@@ -0,0 +1,354 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE name_kernel_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/detail/name_kernel.h"
+
+#include "test/test_context.h"
+#include "util/oct_dump.h"
+
+#include <string>
+#include <vector>
+
+using namespace std::string_literals;
+
+namespace
+{
+   // names of every length up to the limit, mixed case, with a few dots and odd bytes in them
+   std::vector<std::string> sample_inputs()
+   {
+      auto&& result = std::vector<std::string>{};
+      auto&& seed = 12345u;
+
+      for(std::size_t n = 0; n <= 255; ++n)
+      {
+         auto&& s = std::string{};
+
+         for(std::size_t i = 0; i < n; ++i)
+         {
+            seed = seed * 1103515245u + 12345u;
+
+            auto&& r = (seed >> 16) % 64;
+
+            if(r < 26)
+               s += static_cast<char>('A' + r);
+            else if(r < 52)
+               s += static_cast<char>('a' + r - 26);
+            else if(r < 58)
+               s += '.';
+            else if(r < 60)
+               s += '-';
+            else
+               s += static_cast<char>((seed >> 8) & 0xFF);
+         }
+
+         result.push_back(s);
+      }
+
+      return result;
+   }
+
+   const uint8_t* bytes(const std::string& s)
+   {
+      return reinterpret_cast<const uint8_t*>(s.data());
+   }
+
+   template<class Isa>
+   void check_against_scalar(const std::string& context, Isa isa)
+   {
+      namespace scalar = dns::detail::name_kernel::scalar;
+
+      BOOST_TEST_CONTEXT(context)
+      {
+         for(auto&& s : sample_inputs())
+         {
+            BOOST_TEST_CONTEXT(util::oct_dump(s))
+            {
+               auto&& upper = s;
+               for(auto&& c : upper)
+                  c = (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+
+               BOOST_CHECK_EQUAL(isa.hash(bytes(s), s.size(), 7), scalar::hash(bytes(s), s.size(), 7));
+               BOOST_CHECK_EQUAL(isa.equal_nocase(bytes(s), bytes(upper), s.size()), scalar::equal_nocase(bytes(s), bytes(upper), s.size()));
+
+               auto&& out = std::string(s.size(), '\0');
+               auto&& expected_out = std::string(s.size(), '\0');
+
+               isa.lowercase(bytes(s), s.size(), reinterpret_cast<uint8_t*>(&out[0]));
+               scalar::lowercase(bytes(s), s.size(), reinterpret_cast<uint8_t*>(&expected_out[0]));
+
+               BOOST_CHECK_EQUAL(util::oct_dump(out), util::oct_dump(expected_out));
+
+               auto&& dots = dns::detail::name_kernel::position_map_t{};
+               auto&& expected_dots = dns::detail::name_kernel::position_map_t{};
+
+               out.assign(s.size() + 1, '\0');
+               expected_out.assign(s.size() + 1, '\0');
+
+               isa.scan_text(bytes(s), s.size(), reinterpret_cast<uint8_t*>(&out[0]), dots);
+               scalar::scan_text(bytes(s), s.size(), reinterpret_cast<uint8_t*>(&expected_out[0]), expected_dots);
+
+               BOOST_CHECK_EQUAL(util::oct_dump(out), util::oct_dump(expected_out));
+
+               for(auto k = 0; k < 4; ++k)
+                  BOOST_CHECK_EQUAL(dots.w[k], expected_dots.w[k]);
+            }
+         }
+      }
+   }
+
+#if defined(DNS_NAME_KERNEL_X86)
+   struct sse2_t
+   {
+      static uint64_t hash(const uint8_t* p, std::size_t n, uint64_t seed) { return dns::detail::name_kernel::sse2::hash(p, n, seed); }
+      static bool equal_nocase(const uint8_t* a, const uint8_t* b, std::size_t n) { return dns::detail::name_kernel::sse2::equal_nocase(a, b, n); }
+      static void lowercase(const uint8_t* in, std::size_t n, uint8_t* out) { dns::detail::name_kernel::sse2::lowercase(in, n, out); }
+      static void scan_text(const uint8_t* in, std::size_t n, uint8_t* out, dns::detail::name_kernel::position_map_t& dots) { dns::detail::name_kernel::sse2::scan_text(in, n, out, dots); }
+   };
+
+   struct avx2_t
+   {
+      static uint64_t hash(const uint8_t* p, std::size_t n, uint64_t seed) { return dns::detail::name_kernel::avx2::hash(p, n, seed); }
+      static bool equal_nocase(const uint8_t* a, const uint8_t* b, std::size_t n) { return dns::detail::name_kernel::avx2::equal_nocase(a, b, n); }
+      static void lowercase(const uint8_t* in, std::size_t n, uint8_t* out) { dns::detail::name_kernel::avx2::lowercase(in, n, out); }
+      static void scan_text(const uint8_t* in, std::size_t n, uint8_t* out, dns::detail::name_kernel::position_map_t& dots) { dns::detail::name_kernel::avx2::scan_text(in, n, out, dots); }
+   };
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(scan_text_name)
+{
+   struct
+   {
+      std::string test_context;
+      std::string input_text;
+
+      dns::detail::name_status_t expected_status;
+      std::string expected_wire;
+      int expected_label_count;
+   }
+   TestData[] =
+   {
+      {
+         TEST_CONTEXT("root"),
+         "",
+         dns::detail::name_status_t::ok, "\0"s, 0,
+      },
+
+      {
+         TEST_CONTEXT("root (absolute)"),
+         "..",
+         dns::detail::name_status_t::ok, "\0"s, 0,
+      },
+
+      {
+         TEST_CONTEXT("case preserved"),
+         "WWW.Yahoo.com.",
+         dns::detail::name_status_t::ok, "\3WWW\5Yahoo\3com\0"s, 3,
+      },
+
+      {
+         TEST_CONTEXT("underscore and hyphen"),
+         "_dmarc.my-site.org",
+         dns::detail::name_status_t::ok, "\6_dmarc\7my-site\3org\0"s, 3,
+      },
+
+      {
+         TEST_CONTEXT("odd characters are kept"),
+         "a b.c*m",
+         dns::detail::name_status_t::ok, "\3a b\3c*m\0"s, 2,
+      },
+
+      {
+         TEST_CONTEXT("long enough for vector blocks"),
+         std::string(40, 'X') + "." + std::string(20, 'y') + ".Z",
+         dns::detail::name_status_t::ok, "\50"s + std::string(40, 'X') + "\24"s + std::string(20, 'y') + "\1Z\0"s, 3,
+      },
+
+      {
+         TEST_CONTEXT("leading dot"),
+         ".yahoo.com",
+         dns::detail::name_status_t::empty_label, "", 0,
+      },
+
+      {
+         TEST_CONTEXT("double dot"),
+         "yahoo..com",
+         dns::detail::name_status_t::empty_label, "", 1,
+      },
+
+      {
+         TEST_CONTEXT("label of 64"),
+         std::string(64, 'a') + ".com",
+         dns::detail::name_status_t::label_too_long, "", 0,
+      },
+
+      {
+         TEST_CONTEXT("name of 256"),
+         std::string(63, 'a') + "." + std::string(63, 'b') + "." + std::string(63, 'c') + "." + std::string(62, 'd'),
+         dns::detail::name_status_t::name_too_long, "", 0,
+      },
+   };
+
+   /////////////////////////////////////////////////////
+
+   for(auto Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         uint8_t wire[255];
+         uint8_t label_offsets[127];
+
+         auto&& r = dns::detail::scan_text_name(Datum.input_text.data(), Datum.input_text.size(), wire, label_offsets); // THE TEST
+
+         BOOST_CHECK(r.status == Datum.expected_status);
+         BOOST_CHECK_EQUAL(r.label_count, Datum.expected_label_count);
+
+         if(r.status == dns::detail::name_status_t::ok)
+         {
+            BOOST_CHECK_EQUAL(util::oct_dump(std::string(wire, wire + r.wire_size)), util::oct_dump(Datum.expected_wire));
+
+            for(auto i = 0; i < r.label_count; ++i)
+               BOOST_CHECK_LT(wire[label_offsets[i]], 64);
+         }
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(scan_wire_name)
+{
+   struct
+   {
+      std::string test_context;
+      std::string input_wire;
+
+      dns::detail::name_status_t expected_status;
+      std::size_t expected_size;
+      std::size_t expected_wire_size;
+      std::size_t expected_label_count;
+      bool expected_compressed;
+   }
+   TestData[] =
+   {
+      {
+         TEST_CONTEXT("root"),
+         "\0"s,
+         dns::detail::name_status_t::ok, 1, 1, 0, false,
+      },
+
+      {
+         TEST_CONTEXT("simple case, with what follows left alone"),
+         "\3www\5yahoo\3com\0\0\1"s,
+         dns::detail::name_status_t::ok, 15, 15, 3, false,
+      },
+
+      {
+         TEST_CONTEXT("closed by a pointer"),
+         "\3www\300\14\0"s,
+         dns::detail::name_status_t::ok, 6, 5, 1, true,
+      },
+
+      {
+         TEST_CONTEXT("pointer only"),
+         "\300\14"s,
+         dns::detail::name_status_t::ok, 2, 1, 0, true,
+      },
+
+      {
+         TEST_CONTEXT("empty"),
+         ""s,
+         dns::detail::name_status_t::truncated, 0, 1, 0, false,
+      },
+
+      {
+         TEST_CONTEXT("label cut short"),
+         "\3www\5yah"s,
+         dns::detail::name_status_t::truncated, 0, 11, 2, false,
+      },
+
+      {
+         TEST_CONTEXT("no root label"),
+         "\3www"s,
+         dns::detail::name_status_t::truncated, 0, 5, 1, false,
+      },
+
+      {
+         TEST_CONTEXT("pointer cut short"),
+         "\3www\300"s,
+         dns::detail::name_status_t::truncated, 0, 5, 1, false,
+      },
+
+      {
+         TEST_CONTEXT("label of 64"),
+         "\100"s + std::string(64, 'a') + "\0"s,
+         dns::detail::name_status_t::label_too_long, 0, 1, 0, false,
+      },
+
+      {
+         TEST_CONTEXT("reserved label type"),
+         "\3www\200\0"s,
+         dns::detail::name_status_t::label_too_long, 0, 5, 1, false,
+      },
+
+      {
+         TEST_CONTEXT("name of 255"),
+         "\77"s + std::string(63, 'a') + "\77"s + std::string(63, 'b') + "\77"s + std::string(63, 'c') + "\75"s + std::string(61, 'd') + "\0"s,
+         dns::detail::name_status_t::ok, 255, 255, 4, false,
+      },
+
+      {
+         TEST_CONTEXT("name of 256"),
+         "\77"s + std::string(63, 'a') + "\77"s + std::string(63, 'b') + "\77"s + std::string(63, 'c') + "\76"s + std::string(62, 'd') + "\0"s,
+         dns::detail::name_status_t::name_too_long, 0, 256, 4, false,
+      },
+   };
+
+   /////////////////////////////////////////////////////
+
+   for(auto Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         auto&& r = dns::detail::scan_wire_name(bytes(Datum.input_wire), Datum.input_wire.size()); // THE TEST
+
+         BOOST_CHECK(r.status == Datum.expected_status);
+         BOOST_CHECK_EQUAL(r.size, Datum.expected_size);
+         BOOST_CHECK_EQUAL(r.wire_size, Datum.expected_wire_size);
+         BOOST_CHECK_EQUAL(r.label_count, Datum.expected_label_count);
+         BOOST_CHECK_EQUAL(r.compressed, Datum.expected_compressed);
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(hash_ignores_case)
+{
+   auto&& a = "\3WWW\5Yahoo\3COM\0"s;
+   auto&& b = "\3www\5yahoo\3com\0"s;
+   auto&& c = "\3www\5yahoo\3con\0"s;
+
+   BOOST_CHECK_EQUAL(dns::detail::name_hash(bytes(a), a.size()), dns::detail::name_hash(bytes(b), b.size()));
+   BOOST_CHECK_NE(dns::detail::name_hash(bytes(b), b.size()), dns::detail::name_hash(bytes(c), c.size()));
+   BOOST_CHECK_NE(dns::detail::name_hash(bytes(b), b.size(), 1), dns::detail::name_hash(bytes(b), b.size(), 2));
+
+   BOOST_CHECK(dns::detail::equal_nocase(bytes(a), bytes(b), a.size()));
+   BOOST_CHECK(!dns::detail::equal_nocase(bytes(b), bytes(c), b.size()));
+
+   // '@' and '[' sit right next to 'A' and 'Z'
+   auto&& d = "@[`{"s;
+   auto&& e = "`{@["s;
+   BOOST_CHECK(!dns::detail::equal_nocase(bytes(d), bytes(e), d.size()));
+}
+
+BOOST_AUTO_TEST_CASE(vector_versions_match_scalar)
+{
+#if defined(DNS_NAME_KERNEL_X86)
+   check_against_scalar("sse2", sse2_t{});
+
+   if(dns::detail::name_kernel::has_avx2())
+      check_against_scalar("avx2", avx2_t{});
+   else
+      BOOST_TEST_MESSAGE("no AVX2 on this CPU, not checked");
+#else
+   BOOST_TEST_MESSAGE("scalar only on this platform");
+#endif
+}
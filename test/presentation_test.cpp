@@ -0,0 +1,233 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE presentation_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/presentation.h"
+
+#include "test/test_context.h"
+
+#include <string>
+
+using namespace std::string_literals;
+
+namespace
+{
+   template<class T>
+   std::string zone_text(const T& v)
+   {
+      util::text_buffer_t b;
+
+      dns::print_zone_to(b, v);
+
+      return b.str();
+   }
+
+   dns::answer_t make_answer(dns::dname_t name, dns::rr_type_t type, dns::rdata_t rdata, int32_t ttl = 300)
+   {
+      dns::answer_t r;
+
+      r.Name(std::move(name));
+      r.Type(type);
+      r.TTL(ttl);
+      std::visit([&r](auto&& rec) { r.Data(std::move(rec)); }, std::move(rdata));
+
+      return r;
+   }
+}
+
+BOOST_AUTO_TEST_CASE(names)
+{
+   struct
+   {
+      std::string test_context;
+
+      dns::dname_t name;
+      std::string expected;
+   }
+   TestData[] =
+   {
+      { TEST_CONTEXT("root"), "", "." },
+      { TEST_CONTEXT("plain"), "www.Yahoo.com", "www.Yahoo.com." },
+      { TEST_CONTEXT("special characters are escaped"), dns::dname_t{}, "a\\.b\\\\c\\ d.\\;\\@\\$\\(\\)\\\".com." },
+      { TEST_CONTEXT("non printable as decimal"), dns::dname_t{}, "\\000\\009\\127\\255x.com." },
+   };
+
+   // labels holding characters which cannot be given in dotted text
+   {
+      auto&& tr = dns::name_offset_tracker_t{};
+      auto&& raw = "\7a.b\\c d\6;@$()\"\3com\0"s;
+      auto&& b = raw.cbegin();
+      TestData[2].name = dns::load_from<dns::dname_t>(tr, b, raw.cend());
+   }
+   {
+      auto&& tr = dns::name_offset_tracker_t{};
+      auto&& raw = "\5\0\11\177\377x\3com\0"s;
+      auto&& b = raw.cbegin();
+      TestData[3].name = dns::load_from<dns::dname_t>(tr, b, raw.cend());
+   }
+
+   for(auto&& Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         BOOST_CHECK_EQUAL(zone_text(Datum.name), Datum.expected); // THE TEST
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(records)
+{
+   struct
+   {
+      std::string test_context;
+
+      dns::answer_t answer;
+      std::string expected;
+   }
+   TestData[] =
+   {
+      {
+         TEST_CONTEXT("a"),
+         make_answer("yahoo.com", dns::rr_type_t::rec_a, dns::rec_a_t{"98.137.11.163"}, 1800),
+         "yahoo.com.\t1800\tIN\tA\t98.137.11.163\n",
+      },
+      {
+         TEST_CONTEXT("mx"),
+         make_answer("yahoo.com", dns::rr_type_t::rec_mx, dns::rec_mx_t{1, "mta5.am0.yahoodns.net"}),
+         "yahoo.com.\t300\tIN\tMX\t1 mta5.am0.yahoodns.net.\n",
+      },
+      {
+         TEST_CONTEXT("ns"),
+         make_answer("yahoo.com", dns::rr_type_t::rec_ns, dns::rec_ns_t{"ns1.yahoo.com"}),
+         "yahoo.com.\t300\tIN\tNS\tns1.yahoo.com.\n",
+      },
+      {
+         TEST_CONTEXT("cname"),
+         make_answer("www.yahoo.com", dns::rr_type_t::rec_cname, dns::rec_cname_t{"new-fp-shed.wg1.b.yahoo.com"}),
+         "www.yahoo.com.\t300\tIN\tCNAME\tnew-fp-shed.wg1.b.yahoo.com.\n",
+      },
+      {
+         TEST_CONTEXT("ptr"),
+         make_answer("4.220.58.216.in-addr.arpa", dns::rr_type_t::rec_ptr, dns::rec_ptr_t{"syd09s01-in-f4.1e100.net"}),
+         "4.220.58.216.in-addr.arpa.\t300\tIN\tPTR\tsyd09s01-in-f4.1e100.net.\n",
+      },
+      {
+         TEST_CONTEXT("soa"),
+         make_answer("yahoo.com", dns::rr_type_t::rec_soa, dns::rec_soa_t{"ns1.yahoo.com", "hostmaster.yahoo-inc.com", 2017010101, 3600, 300, 1814400, 600}),
+         "yahoo.com.\t300\tIN\tSOA\tns1.yahoo.com. hostmaster.yahoo-inc.com. 2017010101 3600 300 1814400 600\n",
+      },
+      {
+         TEST_CONTEXT("txt, quotes and backslashes escaped"),
+         make_answer("yahoo.com", dns::rr_type_t::rec_txt, dns::rec_txt_t{"v=spf1 \"q\" a\\b\n"}),
+         "yahoo.com.\t300\tIN\tTXT\t\"v=spf1 \\\"q\\\" a\\\\b\\010\"\n",
+      },
+      {
+         TEST_CONTEXT("txt, empty"),
+         make_answer("yahoo.com", dns::rr_type_t::rec_txt, dns::rec_txt_t{""}),
+         "yahoo.com.\t300\tIN\tTXT\t\"\"\n",
+      },
+      {
+         TEST_CONTEXT("txt, longer than a character string"),
+         make_answer("yahoo.com", dns::rr_type_t::rec_txt, dns::rec_txt_t{std::string(300, 'x')}),
+         "yahoo.com.\t300\tIN\tTXT\t\"" + std::string(255, 'x') + "\" \"" + std::string(45, 'x') + "\"\n",
+      },
+      {
+         TEST_CONTEXT("txt, strings as received"),
+         make_answer("yahoo.com", dns::rr_type_t::rec_txt, []
+         {
+            auto&& r = dns::rec_txt_t{};
+            r.AddString("v=spf1");
+            r.AddString(" ~all");
+            return r;
+         }()),
+         "yahoo.com.\t300\tIN\tTXT\t\"v=spf1\" \" ~all\"\n",
+      },
+      {
+         TEST_CONTEXT("known type without a presentation form here"),
+         make_answer("yahoo.com", dns::rr_type_t::rec_aaaa, dns::rec_raw_t{"\x20\x01\x0d\xb8\0\0\0\0\0\0\0\0\0\0\0\1"s}),
+         "yahoo.com.\t300\tIN\tAAAA\t\\# 16 20010DB8000000000000000000000001\n",
+      },
+      {
+         TEST_CONTEXT("unknown type, empty rdata"),
+         make_answer("yahoo.com", static_cast<dns::rr_type_t>(65280), dns::rec_raw_t{""}),
+         "yahoo.com.\t300\tIN\tTYPE65280\t\\# 0\n",
+      },
+   };
+
+   for(auto&& Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         BOOST_CHECK_EQUAL(zone_text(Datum.answer), Datum.expected); // THE TEST
+      }
+   }
+
+   auto&& chaos = make_answer("version.bind", dns::rr_type_t::rec_txt, dns::rec_txt_t{"9.9"}, 0);
+   chaos.Class(dns::rr_class_t::chaos);
+
+   BOOST_CHECK_EQUAL(zone_text(chaos), "version.bind.\t0\tCH\tTXT\t\"9.9\"\n");
+   BOOST_CHECK_EQUAL(zone_text(dns::rr_type_t::rec_nsap_ptr), "NSAP-PTR");
+   BOOST_CHECK_EQUAL(zone_text(static_cast<dns::rr_class_t>(42)), "CLASS42");
+}
+
+BOOST_AUTO_TEST_CASE(message)
+{
+   auto&& m = dns::message_t{};
+
+   m.Header().ID(4660);
+   m.Header().QR_Flag(true);
+   m.Header().RD_Flag(true);
+   m.Header().RA_Flag(true);
+   m.Header().RCode(dns::r_code_t::nx_domain);
+   m.Header().QdCount(1);
+   m.Header().NsCount(1);
+
+   m.Question(dns::question_t{});
+   m.Question(0).Name("nope.yahoo.com");
+   m.Question(0).Type(dns::rr_type_t::rec_mx);
+
+   m.Authority(make_answer("yahoo.com", dns::rr_type_t::rec_soa, dns::rec_soa_t{"ns1.yahoo.com", "hostmaster.yahoo-inc.com", 1, 2, 3, 4, 5}, 600));
+
+   BOOST_CHECK_EQUAL(zone_text(m), // THE TEST
+                     ";; ->>HEADER<<- opcode: QUERY, status: NXDOMAIN, id: 4660\n"
+                     ";; flags: qr rd ra; QUERY: 1, ANSWER: 0, AUTHORITY: 1, ADDITIONAL: 0\n"
+                     "\n"
+                     ";; QUESTION SECTION:\n"
+                     ";nope.yahoo.com.\t\tIN\tMX\n"
+                     "\n"
+                     ";; AUTHORITY SECTION:\n"
+                     "yahoo.com.\t600\tIN\tSOA\tns1.yahoo.com. hostmaster.yahoo-inc.com. 1 2 3 4 5\n");
+}
+
+BOOST_AUTO_TEST_CASE(message_with_counts_not_matching_sections)
+{
+   auto&& m = dns::message_t{};
+
+   m.Header().ID(1);
+   m.Header().QdCount(0);
+   m.Header().AnCount(3);
+
+   m.Question(dns::question_t{});
+   m.Question(0).Name("yahoo.com");
+
+   m.Answer(make_answer("yahoo.com", dns::rr_type_t::rec_a, dns::rec_a_t{"68.180.131.16"}));
+   m.Additional(make_answer("ns1.yahoo.com", dns::rr_type_t::rec_a, dns::rec_a_t{"68.180.131.17"}));
+
+   BOOST_CHECK_EQUAL(zone_text(m), // THE TEST - what is held, under the header as it is
+                     ";; ->>HEADER<<- opcode: QUERY, status: NOERROR, id: 1\n"
+                     ";; flags:; QUERY: 0, ANSWER: 3, AUTHORITY: 0, ADDITIONAL: 0\n"
+                     "\n"
+                     ";; QUESTION SECTION:\n"
+                     ";yahoo.com.\t\tIN\tA\n"
+                     "\n"
+                     ";; ANSWER SECTION:\n"
+                     "yahoo.com.\t300\tIN\tA\t68.180.131.16\n"
+                     "\n"
+                     ";; ADDITIONAL SECTION:\n"
+                     "ns1.yahoo.com.\t300\tIN\tA\t68.180.131.17\n");
+
+   BOOST_CHECK_EQUAL(m.Questions().size(), 1);
+   BOOST_CHECK_EQUAL(m.Answers().size(), 1);
+   BOOST_CHECK(m.Authorities().empty());
+   BOOST_CHECK_EQUAL(m.Additionals().size(), 1);
+}
@@ -0,0 +1,87 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE query_id_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/detail/query_id.h"
+
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(chacha20_block_rfc7539)
+{
+   // RFC 7539, section 2.3.2
+
+   const uint32_t key[8] = { 0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c, 0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c };
+   const uint32_t nonce[3] = { 0x09000000, 0x4a000000, 0x00000000 };
+
+   const uint32_t expected[16] =
+   {
+      0xe4e7f110, 0x15593bd1, 0x1fdd0f50, 0xc47120a3,
+      0xc7f4d1c7, 0x0368c033, 0x9aaa2204, 0x4e6cd4c3,
+      0x466482d2, 0x09aa9f07, 0x05d7c214, 0xa2028bd9,
+      0xd19c12b5, 0xb94e16de, 0xe883d0cb, 0x4e3c50a2,
+   };
+
+   uint32_t out[16];
+
+   dns::detail::chacha::block(key, 1, nonce, out); // THE TEST
+
+   BOOST_CHECK_EQUAL_COLLECTIONS(out, out + 16, expected, expected + 16);
+}
+
+BOOST_AUTO_TEST_CASE(next_skips_ids_in_flight)
+{
+   auto&& gen = dns::detail::query_id_generator_t{};
+
+   auto&& ids = std::set<uint16_t>{};
+
+   for(auto i = 0; i < 20000; ++i)
+   {
+      auto&& id = gen.next(); // THE TEST
+
+      BOOST_REQUIRE(ids.insert(id).second);
+      BOOST_REQUIRE(gen.in_flight(id));
+   }
+
+   BOOST_CHECK_EQUAL(gen.in_flight_count(), 20000u);
+
+   for(auto&& id : ids)
+      gen.release(id);
+
+   BOOST_CHECK_EQUAL(gen.in_flight_count(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(next_finds_the_last_free_id)
+{
+   auto&& gen = dns::detail::query_id_generator_t{};
+
+   for(uint32_t id = 0; id <= 0xFFFF; ++id)
+      if(id != 0x1234)
+         gen.reserve(static_cast<uint16_t>(id));
+
+   BOOST_CHECK_EQUAL(gen.next(), 0x1234); // THE TEST
+
+   BOOST_CHECK_THROW(gen.next(), std::length_error); // THE TEST - none left
+
+   gen.release(7);
+
+   BOOST_CHECK_EQUAL(gen.next(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(generators_are_independent)
+{
+   auto&& a = dns::detail::query_id_generator_t{};
+   auto&& b = dns::detail::query_id_generator_t{};
+
+   auto&& sa = std::vector<uint16_t>{};
+   auto&& sb = std::vector<uint16_t>{};
+
+   for(auto i = 0; i < 64; ++i)
+   {
+      sa.push_back(a.random());
+      sb.push_back(b.random());
+   }
+
+   BOOST_CHECK(sa != sb); // THE TEST - each keyed on its own
+}
@@ -0,0 +1,125 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE query_template_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/query_template.h"
+#include "dns/message.h"
+
+#include "test/test_context.h"
+#include "util/oct_dump.h"
+
+#include <string>
+#include <vector>
+
+using namespace std::string_literals;
+
+namespace
+{
+   std::vector<uint8_t> encode_message(uint16_t id, const std::string& qname, dns::rr_type_t qtype, dns::rr_class_t qclass, const dns::header_t& flags)
+   {
+      auto&& m = dns::message_t{};
+
+      m.Header() = flags;
+      m.Header().ID(id);
+      m.Header().QdCount(1);
+
+      m.Question(dns::question_t{});
+      m.Question(0).Name(qname);
+      m.Question(0).Type(qtype);
+      m.Question(0).Class(qclass);
+
+      auto&& out = std::vector<uint8_t>{};
+      m.save_to(out);
+
+      return out;
+   }
+}
+
+BOOST_AUTO_TEST_CASE(same_as_message_encoding)
+{
+   auto&& cd_flags = dns::header_t{};
+   cd_flags.CD_Flag(true);
+   cd_flags.ID(0xFFFF);   // ignored, as are the counts
+   cd_flags.AnCount(3);
+
+   struct
+   {
+      std::string test_context;
+
+      uint16_t id;
+      std::string qname;
+      dns::rr_type_t qtype;
+      dns::rr_class_t qclass;
+      dns::header_t flags;
+   }
+   TestData[] =
+   {
+      {
+         TEST_CONTEXT("mx query"),
+         0x1234, "yahoo.com", dns::rr_type_t::rec_mx, dns::rr_class_t::internet, dns::query_template_t::query_flags(),
+      },
+      {
+         TEST_CONTEXT("root name"),
+         0, "", dns::rr_type_t::rec_ns, dns::rr_class_t::internet, dns::query_template_t::query_flags(),
+      },
+      {
+         TEST_CONTEXT("other class and flags"),
+         0xABCD, "www.Example.org", dns::rr_type_t::rec_txt, dns::rr_class_t::chaos, cd_flags,
+      },
+   };
+
+   for(auto&& Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         auto&& tmpl = dns::query_template_t{Datum.qtype, Datum.qclass, Datum.flags};
+
+         dns::header_t expected_flags = Datum.flags;
+         expected_flags.AnCount(0);
+
+         auto&& expected = encode_message(Datum.id, Datum.qname, Datum.qtype, Datum.qclass, expected_flags);
+
+         auto&& out = std::vector<uint8_t>{ 0xAB };
+         tmpl.encode_to(Datum.id, Datum.qname, out); // THE TEST - appends
+
+         BOOST_REQUIRE_EQUAL(out.size(), expected.size() + 1);
+         BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(out.begin() + 1, out.end())), util::oct_dump(expected));
+         BOOST_CHECK_EQUAL(tmpl.encoded_size(Datum.qname), expected.size());
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(reused_for_many_names)
+{
+   auto&& tmpl = dns::query_template_t{dns::rr_type_t::rec_a};
+
+   uint8_t buffer[dns::query_template_t::max_size];
+
+   for(auto&& name : { "a.com", "mail.yahoo.com", "x", "yahoo.com" })
+   {
+      BOOST_TEST_CONTEXT(name)
+      {
+         auto&& sz = tmpl.encode_to(7, name, buffer, sizeof(buffer)); // THE TEST
+
+         auto&& expected = encode_message(7, name, dns::rr_type_t::rec_a, dns::rr_class_t::internet, dns::query_template_t::query_flags());
+
+         BOOST_CHECK_EQUAL(util::oct_dump(std::vector<uint8_t>(buffer, buffer + sz)), util::oct_dump(expected));
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(buffer_too_small)
+{
+   auto&& tmpl = dns::query_template_t{dns::rr_type_t::rec_a};
+
+   auto&& out = std::vector<uint8_t>(32, 0xEE);
+
+   BOOST_CHECK_EQUAL(tmpl.encoded_size("yahoo.com"), 27u);
+
+   BOOST_CHECK_EXCEPTION(tmpl.encode_to(1, "yahoo.com", out.data(), 26), dns::exception::bad_buffer_size, // THE TEST
+                         [](const auto & e) { return e.what() == "buffer too small"s && e.code() == 1; });
+
+   BOOST_CHECK_EQUAL(util::oct_dump(out), util::oct_dump(std::vector<uint8_t>(32, 0xEE)));
+
+   BOOST_CHECK_EQUAL(tmpl.encode_to(1, "yahoo.com", out.data(), 27), 27u);
+}
@@ -58,7 +58,7 @@ BOOST_AUTO_TEST_CASE(dns_save_to)
          BOOST_CHECK_EQUAL(pQ->Type(), Datum.input_Type);
          BOOST_CHECK_EQUAL(pQ->Class(), Datum.input_Class);
 
-         BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pQ).str(), Datum.expected_stream);
+         BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pQ).str(), Datum.expected_stream);
 
          {
             auto&& tr = dns::name_offset_tracker_t{};
@@ -116,7 +116,7 @@ BOOST_AUTO_TEST_CASE(dns_load_from)
          BOOST_CHECK_EQUAL(pQ->Class(), Datum.expected_Class);
 
          BOOST_CHECK_EQUAL(std::distance(Datum.input_raw_data.begin(), b), Datum.expected_distance);
-         BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pQ).str(), Datum.expected_stream);
+         BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pQ).str(), Datum.expected_stream);
       }
    }
 }
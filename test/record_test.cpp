@@ -13,6 +13,7 @@
 
 #include <string>
 #include <sstream>
+#include <vector>
 
 using namespace std::string_literals;
 
@@ -26,7 +27,7 @@ BOOST_AUTO_TEST_CASE(dns_save_to_and_load_from)
       dns::rr_type_t input_Type;
       dns::rr_class_t input_Class;
       uint32_t input_TTL;
-      boost::any input_Rec;
+      dns::rdata_t input_Rec;
 
       std::string expected_raw_data;
       std::string expected_stream;
@@ -88,6 +89,14 @@ BOOST_AUTO_TEST_CASE(dns_save_to_and_load_from)
          "\6google\n_domainkey\tprotodave\3com\0\0\20\0\1\0\2\0\1\1\234\377v=DKIM1; k=rsa; p=MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAhArxYH88+A76Gk7/8ENefN5RhMFhoYJp8T3KLPYYpejDI45PKWTO+2r8ZJZOtuk7tsG07bmJyU8PFvU48Lf1xtb4WcFxKKjd7N5MF6JcHD51Xb8XDAJA2ldqxH4hBbw9dRjsT7WBFXbp2x6MSWxgi9f1w+7Z2IFG+AtUjrf8/9N3gLieaZKZT1SEhR8TnhfOm\233FG0LfMyS0YtfHKrkUkBCEmWBPisB2CcZBShKr6/T8/UB/oZF8XMRd0NOsru9MGx9Yp89jIYS5YRuvbA0/TLgOOiqrSU5Ms1egMwfFyy4BMDUKayZzF6BxNPc/+UoFrYHKRZpyD/kEd4FXNEddlksQIDAQAB"s,
          "{ Name=google._domainkey.protodave.com, Type=txt, Class=internet, TTL=131073, REC=[v=DKIM1; k=rsa; p=MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAhArxYH88+A76Gk7/8ENefN5RhMFhoYJp8T3KLPYYpejDI45PKWTO+2r8ZJZOtuk7tsG07bmJyU8PFvU48Lf1xtb4WcFxKKjd7N5MF6JcHD51Xb8XDAJA2ldqxH4hBbw9dRjsT7WBFXbp2x6MSWxgi9f1w+7Z2IFG+AtUjrf8/9N3gLieaZKZT1SEhR8TnhfOmFG0LfMyS0YtfHKrkUkBCEmWBPisB2CcZBShKr6/T8/UB/oZF8XMRd0NOsru9MGx9Yp89jIYS5YRuvbA0/TLgOOiqrSU5Ms1egMwfFyy4BMDUKayZzF6BxNPc/+UoFrYHKRZpyD/kEd4FXNEddlksQIDAQAB] }",
       },
+
+      {
+         TEST_CONTEXT("unknown type is kept raw"),
+         "www.google.com", dns::rr_type_t::rec_aaaa, dns::rr_class_t::internet, 131073u, dns::rec_raw_t{" \1\r\270\0\0\0\0\0\0\0\0\0\0\0\1"s},
+
+         "\3www\6google\3com\0\0\34\0\1\0\2\0\1\0\20 \1\r\270\0\0\0\0\0\0\0\0\0\0\0\1"s,
+         "{ Name=www.google.com, Type=aaaa, Class=internet, TTL=131073, REC= \\1\\r\\270\\0\\0\\0\\0\\0\\0\\0\\0\\0\\0\\0\\1 }",
+      },
    };
 
    /////////////////////////////////////////////////////
@@ -109,7 +118,7 @@ BOOST_AUTO_TEST_CASE(dns_save_to_and_load_from)
          BOOST_CHECK_EQUAL(pR->Class(), Datum.input_Class);
          BOOST_CHECK_EQUAL(pR->TTL(), Datum.input_TTL);
 
-         BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pR).str(), Datum.expected_stream);
+         BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pR).str(), Datum.expected_stream);
 
          {
             auto raw_data = std::string{};
@@ -135,7 +144,7 @@ BOOST_AUTO_TEST_CASE(dns_save_to_and_load_from)
 
                BOOST_CHECK_NO_THROW(*pR1 = dns::load_from<dns::answer_t>(tr, b, e));   // THE SECOND TEST
 
-               BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pR1).str(), Datum.expected_stream);
+               BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pR1).str(), Datum.expected_stream);
 
                BOOST_CHECK_EQUAL(*pR1, *pR);
             }
@@ -160,7 +169,7 @@ BOOST_AUTO_TEST_CASE(dns_negative_load_from)
       dns::rr_type_t expected_Type;
       dns::rr_class_t expected_Class;
       uint32_t expected_TTL;
-      boost::any expected_Rec;
+      dns::rdata_t expected_Rec;
       std::string expected_stream;
    }
    TestData[] =
@@ -189,6 +198,22 @@ BOOST_AUTO_TEST_CASE(dns_negative_load_from)
          exception_info<dns::exception::bad_data_stream>("truncated"s, 1),
          34,
       },
+
+      {
+         TEST_CONTEXT("Bad load case (rdata not fully used by the record)"),
+         "\3www\6google\3com\0\0\1\0\1\0\2\0\1\0\5\330:\334\4\0"s,
+
+         exception_info<dns::exception::bad_data_stream>("bad record"s, 5),
+         31,
+      },
+
+      {
+         TEST_CONTEXT("Bad load case (record reading beyond its rdata)"),
+         "\3www\6google\3com\0\0\1\0\1\0\2\0\1\0\3\330:\334\4"s,
+
+         exception_info<dns::exception::bad_data_stream>("truncated"s, 1),
+         29,
+      },
    };
 
    /////////////////////////////////////////////////////
@@ -221,11 +246,11 @@ BOOST_AUTO_TEST_CASE(dns_negative_load_from)
             switch(Datum.expected_Type)
             {
                case dns::rr_type_t::rec_mx:
-                  BOOST_CHECK_EQUAL(pR->Data<dns::rec_mx_t>(), boost::any_cast<dns::rec_mx_t>(Datum.expected_Rec));
+                  BOOST_CHECK_EQUAL(pR->Data<dns::rec_mx_t>(), std::get<dns::rec_mx_t>(Datum.expected_Rec));
                   break;
 
                case dns::rr_type_t::rec_cname:
-                  BOOST_CHECK_EQUAL(pR->Data<dns::rec_cname_t>(), boost::any_cast<dns::rec_cname_t>(Datum.expected_Rec));
+                  BOOST_CHECK_EQUAL(pR->Data<dns::rec_cname_t>(), std::get<dns::rec_cname_t>(Datum.expected_Rec));
                   break;
 
                default:
@@ -233,8 +258,191 @@ BOOST_AUTO_TEST_CASE(dns_negative_load_from)
             }
 
             BOOST_CHECK_EQUAL(std::distance(Datum.input_raw_data.begin(), b), Datum.expected_distance);
-            BOOST_CHECK_EQUAL(static_cast<std::ostringstream&>(std::ostringstream() << *pR).str(), Datum.expected_stream);
+            BOOST_CHECK_EQUAL(static_cast<std::ostringstream&&>(std::ostringstream() << *pR).str(), Datum.expected_stream);
+         }
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(dns_rdata_by_reference_and_visit)
+{
+   auto&& r = dns::answer_t{};
+
+   r.Type(dns::rr_type_t::rec_mx);
+   r.Data(dns::rec_mx_t{10, "mx1.yahoo.com"});
+
+   r.Data<dns::rec_mx_t>().Preference(20);
+
+   BOOST_CHECK_EQUAL(r.Data<dns::rec_mx_t>().Preference(), 20);
+   BOOST_CHECK_EQUAL(&r.Data<dns::rec_mx_t>(), &std::get<dns::rec_mx_t>(r.RData()));
+
+   auto&& visited = std::string{};
+
+   r.Visit([&visited](auto&& rec)
+   {
+      visited = static_cast<std::ostringstream&&>(std::ostringstream() << rec).str();
+   });
+
+   BOOST_CHECK_EQUAL(visited, "[preference=20, exchange=mx1.yahoo.com]");
+
+   BOOST_CHECK_THROW(r.Data<dns::rec_a_t>(), std::bad_variant_access);
+}
+
+BOOST_AUTO_TEST_CASE(dns_rdata_of_another_type)
+{
+   struct
+   {
+      std::string test_context;
+
+      dns::rr_type_t type;
+      dns::rdata_t rdata;
+      bool expected_match;
+   }
+   TestData[] =
+   {
+      { TEST_CONTEXT("matching"), dns::rr_type_t::rec_mx, dns::rec_mx_t{10, "mx1.yahoo.com"}, true },
+      { TEST_CONTEXT("raw bytes, of any type"), dns::rr_type_t::rec_rrsig, dns::rec_raw_t{"\x01\x02"s}, true },
+      { TEST_CONTEXT("raw bytes of a known type"), dns::rr_type_t::rec_mx, dns::rec_raw_t{}, true },
+      { TEST_CONTEXT("A data in an MX record"), dns::rr_type_t::rec_mx, dns::rec_a_t{"1.2.3.4"}, false },
+      { TEST_CONTEXT("NS data in a CNAME record"), dns::rr_type_t::rec_cname, dns::rec_ns_t{"ns1.yahoo.com"}, false },
+   };
+
+   for(auto&& Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         auto&& r = dns::answer_t{};
+
+         r.Name("yahoo.com");
+         r.Type(Datum.type);
+         r.Data(Datum.rdata);
+
+         BOOST_CHECK_EQUAL(r.DataMatchesType(), Datum.expected_match); // THE TEST
+
+         auto&& tr = dns::name_offset_tracker_t{};
+
+         if(Datum.expected_match)
+         {
+            BOOST_CHECK_NO_THROW(save_to(tr, r));
+            BOOST_CHECK(r == r);
+         }
+         else
+         {
+            auto&& is_mismatch = [](const auto & e) { return e.what() == "rdata not of the record type"s && e.code() == 1; };
+
+            BOOST_CHECK_EXCEPTION(save_to(tr, r), dns::exception::bad_record_type, is_mismatch); // THE TEST
+            BOOST_CHECK_EQUAL(tr.current_offset(), 0);
+
+            BOOST_CHECK_EXCEPTION((void)(r == r), dns::exception::bad_record_type, is_mismatch); // THE TEST
+         }
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(dns_txt_keeps_character_strings)
+{
+   struct
+   {
+      std::string test_context;
+
+      std::string input_rdata;
+
+      std::vector<std::string> expected_strings;
+      std::string expected_text;
+   }
+   TestData[] =
+   {
+      {
+         TEST_CONTEXT("no strings"),
+         ""s,
+         {},
+         "",
+      },
+
+      {
+         TEST_CONTEXT("one empty string"),
+         "\0"s,
+         { "" },
+         "",
+      },
+
+      {
+         TEST_CONTEXT("one string"),
+         "\6v=spf1"s,
+         { "v=spf1" },
+         "v=spf1",
+      },
+
+      {
+         TEST_CONTEXT("strings split short of 255"),
+         "\6v=spf1\14 include:a.b\5 ~all"s,
+         { "v=spf1", " include:a.b", " ~all" },
+         "v=spf1 include:a.b ~all",
+      },
+   };
+
+   /////////////////////////////////////////////////////
+
+   for(auto Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         auto&& b = Datum.input_rdata.cbegin();
+         auto&& tr = dns::name_offset_tracker_t{};
+
+         auto&& r = dns::load_from<dns::rec_txt_t>(tr, b, Datum.input_rdata.cend()); // THE TEST
+
+         BOOST_CHECK(b == Datum.input_rdata.cend());
+
+         auto&& strings = std::vector<std::string>{};
+         for(auto&& s : r.Strings())
+            strings.emplace_back(s);
+
+         BOOST_CHECK_EQUAL_COLLECTIONS(strings.begin(), strings.end(), Datum.expected_strings.begin(), Datum.expected_strings.end());
+         BOOST_CHECK_EQUAL(r.Text(), Datum.expected_text);
+         BOOST_CHECK_EQUAL(r.Strings().text_size(), Datum.expected_text.size());
+
+         {
+            auto&& text = "prefix "s;
+
+            r.AppendText(text);
+
+            BOOST_CHECK_EQUAL(text, "prefix " + Datum.expected_text);
+         }
+
+         {
+            auto&& temp_tr = dns::name_offset_tracker_t{};
+
+            save_to(temp_tr, r);
+
+            BOOST_CHECK_EQUAL(util::oct_dump(temp_tr.store()), util::oct_dump(Datum.input_rdata));
+         }
+
+         {
+            auto&& built = dns::rec_txt_t{};
+
+            for(auto&& s : Datum.expected_strings)
+               built.AddString(s);
+
+            BOOST_CHECK(built == r);
          }
       }
    }
+
+   {
+      auto&& rdata = "\6v=spf1\20 include:a.b"s;
+      auto&& b = rdata.cbegin();
+      auto&& tr = dns::name_offset_tracker_t{};
+
+      BOOST_CHECK_THROW(dns::load_from<dns::rec_txt_t>(tr, b, rdata.cend()), dns::exception::bad_data_stream);
+   }
+
+   {
+      auto&& r = dns::rec_txt_t{std::string(300, 'x')};
+
+      BOOST_CHECK_EQUAL(std::distance(r.Strings().begin(), r.Strings().end()), 2);
+      BOOST_CHECK_EQUAL(r.Text(), std::string(300, 'x'));
+
+      BOOST_CHECK_THROW(r.AddString(std::string(256, 'x')), std::length_error);
+   }
 }
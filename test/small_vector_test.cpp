@@ -0,0 +1,260 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE small_vector_test
+#include <boost/test/unit_test.hpp>
+
+#include "util/small_vector.h"
+
+#include "test/test_context.h"
+
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace std::string_literals;
+
+namespace
+{
+   // counts what it hands out, getting it from new_delete_resource()
+   struct counting_resource_t : std::pmr::memory_resource
+   {
+      std::size_t allocations = 0;
+      std::size_t outstanding = 0;
+
+      void* do_allocate(std::size_t n, std::size_t align) override
+      {
+         ++allocations;
+         ++outstanding;
+         return std::pmr::new_delete_resource()->allocate(n, align);
+      }
+
+      void do_deallocate(void* p, std::size_t n, std::size_t align) override
+      {
+         --outstanding;
+         std::pmr::new_delete_resource()->deallocate(p, n, align);
+      }
+
+      bool do_is_equal(const std::pmr::memory_resource& rhs) const noexcept override
+      {
+         return this == &rhs;
+      }
+   };
+
+   // a string that counts the live instances
+   struct element_t
+   {
+      static inline int live = 0;
+
+      element_t(std::string v)
+         : value(std::move(v))
+      {
+         ++live;
+      }
+
+      element_t(const element_t& rhs)
+         : value(rhs.value)
+      {
+         ++live;
+      }
+
+      element_t(element_t&& rhs) noexcept
+         : value(std::move(rhs.value))
+      {
+         ++live;
+      }
+
+      element_t& operator=(const element_t&) = default;
+      element_t& operator=(element_t&&) = default;
+
+      ~element_t()
+      {
+         --live;
+      }
+
+      std::string value;
+   };
+
+   using vector_t = util::small_vector_t<element_t, 4>;
+
+   // long enough not to fit a std::string's own inline buffer
+   std::string text(int i)
+   {
+      return "element number " + std::to_string(i) + " of the small vector";
+   }
+
+   void fill(vector_t& v, int n)
+   {
+      for(auto i = 0; i < n; ++i)
+         v.push_back(element_t{text(i)});
+   }
+
+   void check_elements(const vector_t& v, int n)
+   {
+      BOOST_REQUIRE_EQUAL(v.size(), static_cast<std::size_t>(n));
+
+      for(auto i = 0; i < n; ++i)
+         BOOST_CHECK_EQUAL(v[i].value, text(i));
+   }
+}
+
+BOOST_AUTO_TEST_CASE(grows_past_inline_capacity)
+{
+   struct
+   {
+      std::string test_context;
+
+      int count;
+      bool expected_inline;
+      std::size_t expected_allocations;
+   }
+   TestData[] =
+   {
+      { TEST_CONTEXT("empty"), 0, true, 0 },
+      { TEST_CONTEXT("some"), 3, true, 0 },
+      { TEST_CONTEXT("full"), 4, true, 0 },
+      { TEST_CONTEXT("one more"), 5, false, 1 },
+      { TEST_CONTEXT("doubling"), 20, false, 3 },
+   };
+
+   for(auto&& data : TestData)
+   {
+      BOOST_TEST_CONTEXT(data.test_context)
+      {
+         auto&& mr = counting_resource_t{};
+
+         {
+            auto&& v = vector_t{&mr};
+
+            fill(v, data.count); // THE TEST
+
+            check_elements(v, data.count);
+            BOOST_CHECK_EQUAL(v.is_inline(), data.expected_inline);
+            BOOST_CHECK_EQUAL(mr.allocations, data.expected_allocations);
+            BOOST_CHECK_EQUAL(element_t::live, data.count);
+            BOOST_CHECK_THROW(v.at(data.count), std::out_of_range);
+         }
+
+         BOOST_CHECK_EQUAL(mr.outstanding, 0u);
+         BOOST_CHECK_EQUAL(element_t::live, 0);
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(clear_keeps_capacity)
+{
+   auto&& mr = counting_resource_t{};
+   auto&& v = vector_t{&mr};
+
+   fill(v, 10);
+
+   auto&& capacity = v.capacity();
+
+   v.clear(); // THE TEST
+
+   BOOST_CHECK(v.empty());
+   BOOST_CHECK_EQUAL(element_t::live, 0);
+   BOOST_CHECK_EQUAL(v.capacity(), capacity);
+
+   fill(v, 10);
+
+   check_elements(v, 10);
+   BOOST_CHECK_EQUAL(mr.allocations, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(push_back_of_own_element)
+{
+   auto&& v = vector_t{};
+
+   fill(v, 4);
+
+   v.push_back(v[1]); // THE TEST - moves every element, the one copied included
+
+   BOOST_CHECK_EQUAL(v.size(), 5u);
+   BOOST_CHECK_EQUAL(v[4].value, text(1));
+}
+
+BOOST_AUTO_TEST_CASE(copy_and_move)
+{
+   struct
+   {
+      std::string test_context;
+
+      int count;
+   }
+   TestData[] =
+   {
+      { TEST_CONTEXT("inline"), 3 },
+      { TEST_CONTEXT("spilled"), 9 },
+   };
+
+   for(auto&& data : TestData)
+   {
+      BOOST_TEST_CONTEXT(data.test_context)
+      {
+         auto&& mr = counting_resource_t{};
+
+         {
+            auto&& v = vector_t{&mr};
+            fill(v, data.count);
+
+            auto&& copy = vector_t{v}; // THE TEST
+
+            check_elements(copy, data.count);
+            BOOST_CHECK(copy.resource() == std::pmr::get_default_resource());
+
+            std::size_t allocations = mr.allocations;
+            auto&& heap_data = v.is_inline() ? nullptr : v.data();
+
+            auto&& moved = vector_t{std::move(v)}; // THE TEST
+
+            check_elements(moved, data.count);
+            BOOST_CHECK(moved.resource() == &mr);
+            BOOST_CHECK(v.empty());
+            BOOST_CHECK(v.is_inline());
+            BOOST_CHECK_EQUAL(mr.allocations, allocations);
+
+            if(heap_data)
+               BOOST_CHECK(moved.data() == heap_data);
+
+            v = std::move(moved); // THE TEST
+
+            check_elements(v, data.count);
+            BOOST_CHECK(moved.empty());
+
+            copy = v;
+
+            check_elements(copy, data.count);
+            BOOST_CHECK(copy.resource() == std::pmr::get_default_resource());
+
+            BOOST_CHECK_EQUAL(element_t::live, 2 * data.count);
+         }
+
+         BOOST_CHECK_EQUAL(mr.outstanding, 0u);
+         BOOST_CHECK_EQUAL(element_t::live, 0);
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(move_between_resources)
+{
+   auto&& mr1 = counting_resource_t{};
+   auto&& mr2 = counting_resource_t{};
+
+   {
+      auto&& v1 = vector_t{&mr1};
+      auto&& v2 = vector_t{&mr2};
+
+      fill(v1, 9);
+
+      v2 = std::move(v1); // THE TEST - elements moved over into memory of mr2
+
+      check_elements(v2, 9);
+      BOOST_CHECK(v2.resource() == &mr2);
+      BOOST_CHECK_EQUAL(mr2.allocations, 1u);
+      BOOST_CHECK(v1.empty());
+   }
+
+   BOOST_CHECK_EQUAL(mr1.outstanding, 0u);
+   BOOST_CHECK_EQUAL(mr2.outstanding, 0u);
+   BOOST_CHECK_EQUAL(element_t::live, 0);
+}
@@ -0,0 +1,143 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE text_buffer_test
+#include <boost/test/unit_test.hpp>
+
+#include "util/text_buffer.h"
+#include "util/oct_dump.h"
+#include "dns/record/rec_a.h"
+
+#include "test/test_context.h"
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace std::string_literals;
+
+BOOST_AUTO_TEST_CASE(integers)
+{
+   struct
+   {
+      std::string test_context;
+
+      int64_t value;
+      std::string expected;
+   }
+   TestData[] =
+   {
+      { TEST_CONTEXT("zero"), 0, "0" },
+      { TEST_CONTEXT("one digit"), 7, "7" },
+      { TEST_CONTEXT("two digits"), 10, "10" },
+      { TEST_CONTEXT("two digits"), 99, "99" },
+      { TEST_CONTEXT("three digits"), 100, "100" },
+      { TEST_CONTEXT("odd number of digits"), 1234567, "1234567" },
+      { TEST_CONTEXT("negative"), -42, "-42" },
+      { TEST_CONTEXT("largest"), std::numeric_limits<int64_t>::max(), "9223372036854775807" },
+      { TEST_CONTEXT("smallest"), std::numeric_limits<int64_t>::min(), "-9223372036854775808" },
+   };
+
+   for(auto&& Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         util::text_buffer_t b;
+
+         b << Datum.value; // THE TEST
+
+         BOOST_CHECK_EQUAL(b.str(), Datum.expected);
+      }
+   }
+
+   util::text_buffer_t b;
+
+   b << std::numeric_limits<uint64_t>::max() << ' ' << uint16_t{65535} << ' ' << int32_t{-1} << ' ' << uint8_t{'x'};
+
+   BOOST_CHECK_EQUAL(b.str(), "18446744073709551615 65535 -1 x");
+}
+
+BOOST_AUTO_TEST_CASE(ipv4)
+{
+   struct
+   {
+      std::string test_context;
+
+      uint32_t address;
+      std::string expected;
+   }
+   TestData[] =
+   {
+      { TEST_CONTEXT("all zero"), 0, "0.0.0.0" },
+      { TEST_CONTEXT("all ones"), 0xFFFFFFFF, "255.255.255.255" },
+      { TEST_CONTEXT("mixed widths"), 0x0A006401, "10.0.100.1" },
+      { TEST_CONTEXT("mixed widths"), 0xD83ADC04, "216.58.220.4" },
+   };
+
+   for(auto&& Datum : TestData)
+   {
+      BOOST_TEST_CONTEXT(Datum.test_context)
+      {
+         util::text_buffer_t b;
+
+         b << "[";
+         b.append_ipv4(Datum.address); // THE TEST
+         b << "]";
+
+         BOOST_CHECK_EQUAL(b.str(), "[" + Datum.expected + "]");
+         BOOST_CHECK_EQUAL(dns::rec_a_t{Datum.address}.DotAddress(), Datum.expected);
+         BOOST_CHECK_EQUAL(dns::rec_a_t{Datum.expected}.Address(), Datum.address);
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(bad_dotted_address)
+{
+   for(auto&& text : { "", "1.2.3", "1.2.3.4.", "1.2.3.4.5", "1..3.4", "256.1.1.1", "1.2.3.1000", "a.b.c.d", " 1.2.3.4", "1.2.3.-4" })
+   {
+      BOOST_TEST_CONTEXT(text)
+      {
+         BOOST_CHECK_THROW(dns::rec_a_t{text}, std::invalid_argument); // THE TEST
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(reused_without_growing)
+{
+   util::text_buffer_t b;
+
+   b << std::string(100, 'x');
+
+   auto&& data = b.data();
+
+   for(auto i = 0; i < 100; ++i)
+   {
+      b.clear();
+      b << "line " << i << " of " << 100; // THE TEST
+
+      BOOST_CHECK_EQUAL(b.data(), data);
+   }
+
+   BOOST_CHECK_EQUAL(b.str(), "line 99 of 100");
+}
+
+BOOST_AUTO_TEST_CASE(oct_dump_into_buffer)
+{
+   for(auto&& raw : { "plain"s, "\0\1\2"s, "\0012"s, "\310\061"s, "\t\\\"\377"s })
+   {
+      BOOST_TEST_CONTEXT(util::oct_dump(raw))
+      {
+         util::text_buffer_t b;
+         util::DumpOct(b, raw.begin(), raw.end()); // THE TEST
+
+         std::ostringstream os;
+         util::DumpOct(os, raw.begin(), raw.end());
+
+         BOOST_CHECK_EQUAL(b.str(), os.str());
+      }
+   }
+
+   BOOST_CHECK_EQUAL(util::oct_dump("\310\061"s), "\\3101"); // byte over 63 before a digit
+   BOOST_CHECK_EQUAL(util::oct_dump("\1\061"s), "\\0011");
+   BOOST_CHECK_EQUAL(util::oct_dump("\1x"s), "\\1x");
+}
@@ -0,0 +1,171 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE udp_resolver_test
+#include <boost/test/unit_test.hpp>
+
+#include "dns/udp/resolver.h"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+   /*
+    * Answers every query on the loopback by sending it back with QR set - except the
+    * ones numbered in 'bad_header', which get a header announcing a question not there,
+    * and those in 'bad_rdata', which get an A answer of 3 bytes: whole as far as
+    * message_view_t checks, but not decodable.
+    */
+   class echo_server_t
+   {
+      public:
+         echo_server_t(boost::asio::io_service& io, std::set<int> bad_header, std::set<int> bad_rdata = {})
+            : m_socket{io, boost::asio::ip::udp::endpoint{boost::asio::ip::address_v4::loopback(), 0}}
+            , m_bad_header(std::move(bad_header))
+            , m_bad_rdata(std::move(bad_rdata))
+         {
+            receive();
+         }
+
+         boost::asio::ip::udp::endpoint endpoint() const
+         {
+            return m_socket.local_endpoint();
+         }
+
+         // the IDs the queries came with
+         const std::vector<uint16_t>& ids() const
+         {
+            return m_ids;
+         }
+
+      private:
+         void receive()
+         {
+            m_socket.async_receive_from(boost::asio::buffer(m_buffer), m_peer, [this](auto ec, std::size_t sz)
+            {
+               if(ec || sz < dns::detail::header_size)
+                  return;
+
+               m_ids.push_back(dns::detail::peek_id(m_buffer.data()));
+
+               m_buffer[2] |= 0x80;
+
+               if(m_bad_header.count(m_ids.size()))
+               {
+                  m_buffer[5] = 1;
+                  sz = dns::detail::header_size;
+               }
+
+               if(m_bad_rdata.count(m_ids.size()))
+               {
+                  const uint8_t answer[] = { 0xC0, 12, 0, 1, 0, 1, 0, 0, 0, 1, 0, 3, 1, 2, 3 };
+
+                  m_buffer[7] = 1;
+                  sz = std::copy(std::begin(answer), std::end(answer), m_buffer.begin() + sz) - m_buffer.begin();
+               }
+
+               m_socket.send_to(boost::asio::buffer(m_buffer.data(), sz), m_peer);
+
+               receive();
+            });
+         }
+
+         boost::asio::ip::udp::socket m_socket;
+         boost::asio::ip::udp::endpoint m_peer;
+         std::array<uint8_t, 512> m_buffer;
+         std::set<int> m_bad_header;
+         std::set<int> m_bad_rdata;
+         std::vector<uint16_t> m_ids;
+   };
+
+   struct outcome_t
+   {
+      boost::system::error_code ec;
+      bool empty;
+      uint16_t id;
+   };
+}
+
+BOOST_AUTO_TEST_CASE(queries_sharing_an_id_each_get_their_response)
+{
+   auto&& io = boost::asio::io_service{};
+   auto&& server = echo_server_t{io, {2}};
+
+   dns::udp::resolver r{io, server.endpoint()};
+
+   auto&& query = dns::make_query("yahoo.com", dns::rr_type_t::rec_a);
+   auto&& outcomes = std::vector<outcome_t>{};
+
+   for(auto i = 0; i < 3; ++i)
+   {
+      r.async_resolve(query, [&outcomes, &io](const boost::system::error_code & ec, const dns::message_view_t& m) // THE TEST
+      {
+         outcomes.push_back(outcome_t{ec, m.empty(), m.empty() ? uint16_t{0} : m.Header().ID()});
+
+         if(outcomes.size() == 3)
+            io.stop(); // the server's receive would keep run_for() going
+      });
+   }
+
+   io.run_for(std::chrono::seconds(5));
+
+   BOOST_REQUIRE_EQUAL(server.ids().size(), 3);
+   BOOST_REQUIRE_EQUAL(outcomes.size(), 3);
+
+   // in flight together - so under IDs of their own, whatever the message said
+   BOOST_CHECK_EQUAL(std::set<uint16_t>(server.ids().begin(), server.ids().end()).size(), 3);
+
+   for(auto i : { 0, 2 })
+   {
+      BOOST_TEST_CONTEXT("query " << i)
+      {
+         BOOST_CHECK(!outcomes[i].ec);
+         BOOST_CHECK(!outcomes[i].empty);
+         BOOST_CHECK_EQUAL(outcomes[i].id, server.ids()[i]);
+      }
+   }
+
+   // the malformed one reaches its callback as an error, and the next query still runs
+   BOOST_CHECK(outcomes[1].ec);
+   BOOST_CHECK_EQUAL(outcomes[1].ec.category().name(), std::string{"dns::decode"});
+   BOOST_CHECK(outcomes[1].empty);
+}
+
+BOOST_AUTO_TEST_CASE(rdata_not_decoding_reaches_message_callbacks_as_error)
+{
+   auto&& io = boost::asio::io_service{};
+   auto&& server = echo_server_t{io, {}, {1}};
+
+   dns::udp::resolver r{io, server.endpoint()};
+
+   auto&& query = dns::make_query("yahoo.com", dns::rr_type_t::rec_a);
+   auto&& outcomes = std::vector<outcome_t>{};
+
+   for(auto i = 0; i < 2; ++i)
+   {
+      r.async_resolve(query, [&outcomes, &io](const boost::system::error_code & ec, const dns::message_t& m) // THE TEST
+      {
+         outcomes.push_back(outcome_t{ec, m.Questions().empty(), m.Header().ID()});
+
+         if(outcomes.size() == 2)
+            io.stop();
+      });
+   }
+
+   io.run_for(std::chrono::seconds(5));
+
+   BOOST_REQUIRE_EQUAL(outcomes.size(), 2);
+
+   BOOST_CHECK(outcomes[0].ec);
+   BOOST_CHECK_EQUAL(outcomes[0].ec.category().name(), std::string{"dns::decode"});
+   BOOST_CHECK(outcomes[0].empty);
+
+   BOOST_CHECK(!outcomes[1].ec);
+   BOOST_CHECK(!outcomes[1].empty);
+   BOOST_CHECK_EQUAL(outcomes[1].id, server.ids()[1]);
+}